@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "SimBatch.hpp"
+#include "SimTuning.hpp"
+
+/**
+ * @brief A swept parameter, and every value it takes
+ */
+struct SweepParameter {
+        std::string key;
+        std::vector<std::string> values;
+};
+
+static std::string trim(const std::string& text) {
+    const std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Expand a value to the values it stands for. start:stop:step is a range, anything else is itself
+ */
+static bool expandValue(const std::string& text, std::vector<std::string>& values) {
+    const std::size_t first = text.find(':');
+    if (first == std::string::npos) {
+        values.push_back(text);
+        return true;
+    }
+    const std::size_t second = text.find(':', first + 1);
+    if (second == std::string::npos) return false;
+    char* end;
+    const double start = std::strtod(text.c_str(), &end);
+    if (end != text.c_str() + first) return false;
+    const double stop = std::strtod(text.c_str() + first + 1, &end);
+    if (end != text.c_str() + second) return false;
+    const double step = std::strtod(text.c_str() + second + 1, &end);
+    if (*end != '\0' || step <= 0 || stop < start) return false;
+    // count the steps, so rounding doesn't drop the last value
+    const long count = std::lround(std::floor((stop - start) / step + 1e-6));
+    for (long i = 0; i <= count; i++) {
+        char value[32];
+        std::snprintf(value, sizeof(value), "%g", start + i * step);
+        values.push_back(value);
+    }
+    return true;
+}
+
+static bool parseSweep(const std::string& path, std::vector<SweepParameter>& parameters) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "can't open %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        const std::size_t equals = line.find('=');
+        SweepParameter parameter {trim(line.substr(0, equals)), {}};
+        bool valid = equals != std::string::npos && !parameter.key.empty();
+        for (std::size_t start = equals + 1; valid && start <= line.size();) {
+            std::size_t comma = line.find(',', start);
+            if (comma == std::string::npos) comma = line.size();
+            const std::string value = trim(line.substr(start, comma - start));
+            valid = !value.empty() && expandValue(value, parameter.values);
+            start = comma + 1;
+        }
+        // check every value now, instead of in every run
+        SimSettings settings;
+        for (const std::string& value : parameter.values) {
+            if (!valid) break;
+            // routines are checked by the runs, which fail on one they don't know
+            if (parameter.key == "routine") continue;
+            if (parameter.key == "seed") valid = value.find_first_not_of("0123456789") == std::string::npos;
+            else valid = settings.set(parameter.key, value);
+        }
+        if (!valid) {
+            std::fprintf(stderr, "%s:%d: invalid sweep line\n", path.c_str(), lineNumber);
+            return false;
+        }
+        parameters.push_back(parameter);
+    }
+    return true;
+}
+
+/**
+ * @brief Quote an argument for the shell
+ */
+static std::string quote(const std::string& arg) {
+    std::string quoted = "'";
+    for (char c : arg) quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    return quoted + "'";
+}
+
+int runBatch(const std::string& sweepPath, unsigned jobs, const std::string& outPath,
+             const std::vector<std::string>& baseArgs) {
+    std::vector<SweepParameter> parameters;
+    if (!parseSweep(sweepPath, parameters)) return 1;
+    std::size_t total = 1;
+    for (const SweepParameter& parameter : parameters) total *= parameter.values.size();
+
+    // the values of a configuration, the first parameter changing slowest
+    auto valueIndex = [&](std::size_t config, std::size_t parameter) {
+        for (std::size_t i = parameters.size() - 1; i > parameter; i--) config /= parameters[i].values.size();
+        return config % parameters[parameter].values.size();
+    };
+
+    // the runs are this program. Resolve it here, the shell would see its own /proc/self/exe
+    char self[4096];
+    const ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (length < 0) {
+        std::perror("/proc/self/exe");
+        return 1;
+    }
+    self[length] = '\0';
+    std::string base = quote(self);
+    for (const std::string& arg : baseArgs) base += " " + quote(arg);
+
+    std::vector<std::string> results(total);
+    std::atomic<std::size_t> next = 0;
+    std::atomic<std::size_t> done = 0;
+    std::atomic<bool> failed = false;
+    auto worker = [&] {
+        for (std::size_t config = next++; config < total; config = next++) {
+            std::string command = base;
+            for (std::size_t i = 0; i < parameters.size(); i++) {
+                const SweepParameter& parameter = parameters[i];
+                const std::string& value = parameter.values[valueIndex(config, i)];
+                if (parameter.key == "routine" || parameter.key == "seed")
+                    command += " --" + parameter.key + " " + quote(value);
+                else command += " --set " + quote(parameter.key + "=" + value);
+            }
+            // stdout carries the robot program's logs and binary telemetry, so the result has a file of its own
+            char resultPath[] = "/tmp/sim_result_XXXXXX";
+            const int resultFile = mkstemp(resultPath);
+            std::string result;
+            if (resultFile >= 0) {
+                close(resultFile);
+                command += " --result " + quote(resultPath) + " > /dev/null";
+                if (std::system(command.c_str()) == 0) {
+                    std::ifstream file(resultPath);
+                    std::getline(file, result);
+                    result = trim(result);
+                }
+                unlink(resultPath);
+            }
+            if (result.empty()) {
+                failed = true;
+                result = "failed";
+            }
+            results[config] = result;
+            std::fprintf(stderr, "\r%zu/%zu runs", ++done, total);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < std::max(jobs, 1u); i++) workers.emplace_back(worker);
+    for (std::thread& thread : workers) thread.join();
+    std::fprintf(stderr, "\n");
+
+    std::FILE* out = std::fopen(outPath.c_str(), "w");
+    if (out == nullptr) {
+        std::perror(outPath.c_str());
+        return 1;
+    }
+    for (const SweepParameter& parameter : parameters) std::fprintf(out, "%s,", parameter.key.c_str());
+    std::fprintf(out, "finished,exit_ms,settle_ms,overshoot,error_in,error_deg,odom_error_in,odom_error_deg\n");
+    for (std::size_t config = 0; config < total; config++) {
+        for (std::size_t i = 0; i < parameters.size(); i++)
+            std::fprintf(out, "%s,", parameters[i].values[valueIndex(config, i)].c_str());
+        std::fprintf(out, "%s\n", results[config].c_str());
+    }
+    std::fclose(out);
+    return failed ? 1 : 0;
+}
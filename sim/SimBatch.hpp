@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Run every configuration of a parameter sweep, each in its own simulator process, several at a time
+ *
+ * The sweep file has a `key = values` line per swept parameter, and `#` comments. Values are separated by commas, and
+ * a value written start:stop:step is every value from start to stop. The keys are the ones SimSettings::set takes,
+ * plus `routine` and `seed`. Every combination of values is run, and the results are written to a CSV file, a row per
+ * configuration, in the order of the sweep.
+ *
+ * Each run is a separate process, since the robot program keeps its state in globals. The processes share nothing,
+ * so runs scale with the number of cores. A run writes its result to a file of its own with --result, and its
+ * stdout, where the robot program logs, is thrown away.
+ *
+ * @param sweepPath path of the sweep file
+ * @param jobs how many runs at once
+ * @param outPath path of the CSV file to write
+ * @param baseArgs arguments given to every run, like --time-limit
+ * @return 0 if every run finished, 1 if the sweep is invalid or a run failed
+ */
+int runBatch(const std::string& sweepPath, unsigned jobs, const std::string& outPath,
+             const std::vector<std::string>& baseArgs);
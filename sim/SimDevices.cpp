@@ -0,0 +1,642 @@
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include "pros/adi.hpp"
+#include "pros/device.hpp"
+#include "pros/error.h"
+#include "pros/gps.hpp"
+#include "pros/imu.hpp"
+#include "pros/llemu.hpp"
+#include "pros/misc.hpp"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "SimWorld.hpp"
+
+/**
+ * The sensor, ADI, controller, competition, battery, SD card and LCD parts of the PROS API, on top of SimWorld.
+ *
+ * Every device the program uses is plugged in. The controller is connected, with its sticks centered and no buttons
+ * pressed, and there is no SD card. GPS sensors report the true pose with noise and outliers, for the estimator
+ * routine. Vision, distance, optical, AI vision, serial and radio devices aren't simulated: the robot doesn't have
+ * any.
+ */
+
+/**
+ * @brief Offsets the program set on an IMU, so it reads a chosen value
+ */
+struct ImuOffsets {
+        double rotation = 0;
+        double heading = 0;
+        double pitch = 0;
+        double roll = 0;
+        double yaw = 0;
+};
+
+/**
+ * @brief What the program set on a rotation sensor or an ADI encoder
+ */
+struct EncoderState {
+        bool reversed = false;
+        /** added to the reading, in the units of the sensor */
+        double offset = 0;
+};
+
+static std::array<ImuOffsets, 21> imuOffsets = {};
+static std::array<EncoderState, 21> rotationStates = {};
+static std::array<EncoderState, 8> encoderStates = {};
+static std::array<std::int32_t, 8> adiConfigs = {};
+static std::array<std::string, 8> lcdLines = {};
+static bool lcdInitialized = false;
+
+/**
+ * @brief Convert an ADI port from 'a' to 'h', 'A' to 'H', or 1 to 8, to 1 to 8
+ */
+static std::uint8_t adiIndex(std::uint8_t port) {
+    if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+    if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+    return port;
+}
+
+/**
+ * @brief Wrap an angle to [0, 360)
+ */
+static double wrap360(double angle) {
+    angle = std::fmod(angle, 360);
+    return angle < 0 ? angle + 360 : angle;
+}
+
+/**
+ * @brief Wrap an angle to [-180, 180)
+ */
+static double wrap180(double angle) { return wrap360(angle + 180) - 180; }
+
+namespace pros::v5 {
+Device::Device(const std::uint8_t port)
+    : _port(port) {}
+
+std::uint8_t Device::get_port() const { return _port; }
+
+bool Device::is_installed() { return true; }
+
+DeviceType Device::get_plugged_type() const { return _deviceType; }
+
+std::int32_t Imu::reset(bool blocking) const {
+    simWorld().calibrateImu(_port);
+    imuOffsets[_port - 1] = {};
+    while (blocking && simWorld().isImuCalibrating(_port)) pros::delay(10);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t) const { return 1; }
+
+/**
+ * @brief Read the rotation of an IMU, or set errno if it is calibrating
+ */
+static double readRotation(std::uint8_t port) {
+    if (simWorld().isImuCalibrating(port)) {
+        errno = EAGAIN;
+        return PROS_ERR_F;
+    }
+    return simWorld().getImuRotation(port);
+}
+
+double Imu::get_rotation() const {
+    const double rotation = readRotation(_port);
+    return rotation == PROS_ERR_F ? rotation : rotation + imuOffsets[_port - 1].rotation;
+}
+
+double Imu::get_heading() const {
+    const double rotation = readRotation(_port);
+    return rotation == PROS_ERR_F ? rotation : wrap360(rotation + imuOffsets[_port - 1].heading);
+}
+
+quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = get_yaw();
+    if (yaw == PROS_ERR_F) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    // a rotation about the vertical axis
+    const double half = -yaw * M_PI / 360;
+    return {0, 0, std::sin(half), std::cos(half)};
+}
+
+euler_s_t Imu::get_euler() const { return {get_pitch(), get_roll(), get_yaw()}; }
+
+double Imu::get_pitch() const {
+    if (readRotation(_port) == PROS_ERR_F) return PROS_ERR_F;
+    return wrap180(imuOffsets[_port - 1].pitch);
+}
+
+double Imu::get_roll() const {
+    if (readRotation(_port) == PROS_ERR_F) return PROS_ERR_F;
+    return wrap180(imuOffsets[_port - 1].roll);
+}
+
+double Imu::get_yaw() const {
+    const double rotation = readRotation(_port);
+    return rotation == PROS_ERR_F ? rotation : wrap180(rotation + imuOffsets[_port - 1].yaw);
+}
+
+imu_gyro_s_t Imu::get_gyro_rate() const {
+    if (readRotation(_port) == PROS_ERR_F) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, simWorld().getImuRate(_port)};
+}
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return set_pitch(0); }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return set_roll(0); }
+
+std::int32_t Imu::tare() const {
+    if (tare_euler() == PROS_ERR) return PROS_ERR;
+    tare_rotation();
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return set_euler({0, 0, 0}); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    const double rotation = readRotation(_port);
+    if (rotation == PROS_ERR_F) return PROS_ERR;
+    imuOffsets[_port - 1].heading = target - rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    const double rotation = readRotation(_port);
+    if (rotation == PROS_ERR_F) return PROS_ERR;
+    imuOffsets[_port - 1].rotation = target - rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const {
+    const double rotation = readRotation(_port);
+    if (rotation == PROS_ERR_F) return PROS_ERR;
+    imuOffsets[_port - 1].yaw = target - rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_pitch(const double target) const {
+    if (readRotation(_port) == PROS_ERR_F) return PROS_ERR;
+    imuOffsets[_port - 1].pitch = target;
+    return 1;
+}
+
+std::int32_t Imu::set_roll(const double target) const {
+    if (readRotation(_port) == PROS_ERR_F) return PROS_ERR;
+    imuOffsets[_port - 1].roll = target;
+    return 1;
+}
+
+std::int32_t Imu::set_euler(const euler_s_t target) const {
+    if (set_pitch(target.pitch) == PROS_ERR) return PROS_ERR;
+    set_roll(target.roll);
+    return set_yaw(target.yaw);
+}
+
+imu_accel_s_t Imu::get_accel() const {
+    if (readRotation(_port) == PROS_ERR_F) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    double forwards;
+    double right;
+    simWorld().getImuAccel(_port, forwards, right);
+    return {forwards, right, 1};
+}
+
+ImuStatus Imu::get_status() const {
+    return simWorld().isImuCalibrating(_port) ? ImuStatus::calibrating : ImuStatus::ready;
+}
+
+bool Imu::is_calibrating() const { return simWorld().isImuCalibrating(_port); }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+/**
+ * @brief Offset of each GPS from the center of the robot, in meters. Only kept to be read back, the simulated GPS
+ * reports the center of the robot
+ */
+static std::array<gps_position_s_t, 21> gpsOffsets = {};
+
+/**
+ * @brief Read a GPS, in meters and degrees
+ */
+static void readGps(std::uint8_t port, double& x, double& y, double& heading, double& error) {
+    simWorld().getGps(port, x, y, heading, error);
+    x *= 0.0254;
+    y *= 0.0254;
+    error *= 0.0254;
+}
+
+std::int32_t Gps::initialize_full(double, double, double, double xOffset, double yOffset) const {
+    return set_offset(xOffset, yOffset);
+}
+
+std::int32_t Gps::set_offset(double xOffset, double yOffset) const {
+    gpsOffsets[_port - 1] = {xOffset, yOffset};
+    return 1;
+}
+
+gps_position_s_t Gps::get_offset() const { return gpsOffsets[_port - 1]; }
+
+std::int32_t Gps::set_position(double, double, double) const { return 1; }
+
+std::int32_t Gps::set_data_rate(std::uint32_t) const { return 1; }
+
+double Gps::get_error() const {
+    double x, y, heading, error;
+    readGps(_port, x, y, heading, error);
+    return error;
+}
+
+gps_status_s_t Gps::get_position_and_orientation() const {
+    double x, y, heading, error;
+    readGps(_port, x, y, heading, error);
+    return {x, y, 0, 0, wrap180(heading)};
+}
+
+gps_position_s_t Gps::get_position() const {
+    double x, y, heading, error;
+    readGps(_port, x, y, heading, error);
+    return {x, y};
+}
+
+double Gps::get_position_x() const { return get_position().x; }
+
+double Gps::get_position_y() const { return get_position().y; }
+
+gps_orientation_s_t Gps::get_orientation() const { return {0, 0, get_yaw()}; }
+
+double Gps::get_pitch() const { return 0; }
+
+double Gps::get_roll() const { return 0; }
+
+double Gps::get_yaw() const { return wrap180(get_heading()); }
+
+double Gps::get_heading() const {
+    double x, y, heading, error;
+    readGps(_port, x, y, heading, error);
+    return wrap360(heading);
+}
+
+double Gps::get_heading_raw() const { return get_heading(); }
+
+gps_gyro_s_t Gps::get_gyro_rate() const { return {0, 0, 0}; }
+
+double Gps::get_gyro_rate_x() const { return 0; }
+
+double Gps::get_gyro_rate_y() const { return 0; }
+
+double Gps::get_gyro_rate_z() const { return 0; }
+
+gps_accel_s_t Gps::get_accel() const { return {0, 0, 0}; }
+
+double Gps::get_accel_x() const { return 0; }
+
+double Gps::get_accel_y() const { return 0; }
+
+double Gps::get_accel_z() const { return 0; }
+
+Rotation::Rotation(const std::int8_t port)
+    : Device(std::abs(port), DeviceType::rotation) {
+    if (port < 0) set_reversed(true);
+}
+
+/**
+ * @brief Position of a rotation sensor, in centidegrees
+ */
+static double rotationPosition(std::uint8_t port, double* velocity = nullptr) {
+    const EncoderState& state = rotationStates[port - 1];
+    const double position = simWorld().getTrackingWheel(port, false, velocity) * 100;
+    if (velocity != nullptr) *velocity *= state.reversed ? -100 : 100;
+    return (state.reversed ? -position : position) + state.offset;
+}
+
+std::int32_t Rotation::reset() {
+    // the position starts again from the angle
+    EncoderState& state = rotationStates[_port - 1];
+    state.offset += get_angle() - get_position();
+    return 1;
+}
+
+std::int32_t Rotation::set_data_rate(std::uint32_t) const { return 1; }
+
+std::int32_t Rotation::set_position(std::int32_t position) const {
+    rotationStates[_port - 1].offset += position - rotationPosition(_port);
+    return 1;
+}
+
+std::int32_t Rotation::reset_position() const { return set_position(0); }
+
+std::int32_t Rotation::get_position() const { return std::lround(rotationPosition(_port)); }
+
+std::int32_t Rotation::get_velocity() const {
+    double velocity;
+    rotationPosition(_port, &velocity);
+    return std::lround(velocity);
+}
+
+std::int32_t Rotation::get_angle() const { return std::lround(wrap360(rotationPosition(_port) / 100) * 100) % 36000; }
+
+std::int32_t Rotation::set_reversed(bool value) const {
+    rotationStates[_port - 1].reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() const { return set_reversed(!rotationStates[_port - 1].reversed); }
+
+std::int32_t Rotation::get_reversed() const { return rotationStates[_port - 1].reversed; }
+} // namespace pros::v5
+
+namespace pros::adi {
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t type)
+    : _smart_port(INTERNAL_ADI_PORT),
+      _adi_port(adiIndex(adi_port)) {
+    set_config(type);
+}
+
+Port::Port(ext_adi_port_pair_t port_pair, adi_port_config_e_t type)
+    : _smart_port(port_pair.first),
+      _adi_port(adiIndex(port_pair.second)) {
+    set_config(type);
+}
+
+std::int32_t Port::get_config() const { return adiConfigs[_adi_port - 1]; }
+
+std::int32_t Port::get_value() const { return simWorld().adiValue(_adi_port); }
+
+std::int32_t Port::set_config(adi_port_config_e_t type) const {
+    adiConfigs[_adi_port - 1] = type;
+    return 1;
+}
+
+std::int32_t Port::set_value(std::int32_t value) const {
+    simWorld().adiValue(_adi_port) = value;
+    return 1;
+}
+
+ext_adi_port_tuple_t Port::get_port() const { return {_smart_port, _adi_port, PROS_ERR_BYTE}; }
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state)
+    : Port(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+DigitalOut::DigitalOut(ext_adi_port_pair_t port_pair, bool init_state)
+    : Port(port_pair, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+Pneumatics::Pneumatics(std::uint8_t adi_port, bool start_extended, bool extended_is_low)
+    : DigitalOut(adi_port, start_extended != extended_is_low),
+      state(start_extended != extended_is_low),
+      extended_is_low(extended_is_low) {}
+
+Pneumatics::Pneumatics(ext_adi_port_pair_t port_pair, bool start_extended, bool extended_is_low)
+    : DigitalOut(port_pair, start_extended != extended_is_low),
+      state(start_extended != extended_is_low),
+      extended_is_low(extended_is_low) {}
+
+std::int32_t Pneumatics::extend() {
+    const bool previous = state;
+    state = !extended_is_low;
+    set_value(state);
+    return previous != state;
+}
+
+std::int32_t Pneumatics::retract() {
+    const bool previous = state;
+    state = extended_is_low;
+    set_value(state);
+    return previous != state;
+}
+
+std::int32_t Pneumatics::toggle() {
+    state = !state;
+    set_value(state);
+    return 1;
+}
+
+bool Pneumatics::is_extended() const { return state != extended_is_low; }
+
+Encoder::Encoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+    : Port(adi_port_top, E_ADI_LEGACY_ENCODER),
+      _port_pair(adiIndex(adi_port_top), adiIndex(adi_port_bottom)) {
+    encoderStates[_adi_port - 1].reversed = reversed;
+}
+
+Encoder::Encoder(ext_adi_port_tuple_t port_tuple, bool reversed)
+    : Port({std::get<0>(port_tuple), std::get<1>(port_tuple)}, E_ADI_LEGACY_ENCODER),
+      _port_pair(adiIndex(std::get<1>(port_tuple)), adiIndex(std::get<2>(port_tuple))) {
+    encoderStates[_adi_port - 1].reversed = reversed;
+}
+
+std::int32_t Encoder::reset() const {
+    encoderStates[_adi_port - 1].offset -= get_value();
+    return 1;
+}
+
+std::int32_t Encoder::get_value() const {
+    // the quadrature encoder counts 360 ticks per revolution
+    const EncoderState& state = encoderStates[_adi_port - 1];
+    const double position = simWorld().getTrackingWheel(_adi_port, true);
+    return std::lround((state.reversed ? -position : position) + state.offset);
+}
+
+ext_adi_port_tuple_t Encoder::get_port() const { return {_smart_port, _port_pair.first, _port_pair.second}; }
+} // namespace pros::adi
+
+namespace pros::c {
+int32_t controller_is_connected(controller_id_e_t) { return 1; }
+
+int32_t controller_get_analog(controller_id_e_t, controller_analog_e_t) { return 0; }
+
+int32_t controller_get_battery_capacity(controller_id_e_t) { return 100; }
+
+int32_t controller_get_battery_level(controller_id_e_t) { return 100; }
+
+int32_t controller_get_digital(controller_id_e_t, controller_digital_e_t) { return 0; }
+
+int32_t controller_get_digital_new_press(controller_id_e_t, controller_digital_e_t) { return 0; }
+
+int32_t controller_get_digital_new_release(controller_id_e_t, controller_digital_e_t) { return 0; }
+
+int32_t controller_print(controller_id_e_t, uint8_t, uint8_t, const char*, ...) { return 1; }
+
+int32_t controller_set_text(controller_id_e_t, uint8_t, uint8_t, const char*) { return 1; }
+
+int32_t controller_clear_line(controller_id_e_t, uint8_t) { return 1; }
+
+int32_t controller_clear(controller_id_e_t) { return 1; }
+
+int32_t controller_rumble(controller_id_e_t, const char*) { return 1; }
+
+uint8_t competition_get_status() { return simWorld().getCompetitionStatus(); }
+
+uint8_t competition_is_disabled() { return (competition_get_status() & COMPETITION_DISABLED) != 0; }
+
+uint8_t competition_is_connected() { return (competition_get_status() & COMPETITION_CONNECTED) != 0; }
+
+uint8_t competition_is_autonomous() { return (competition_get_status() & COMPETITION_AUTONOMOUS) != 0; }
+
+uint8_t competition_is_field() { return (competition_get_status() & COMPETITION_SYSTEM) != 0; }
+
+uint8_t competition_is_switch() { return competition_is_connected() && !competition_is_field(); }
+
+int32_t battery_get_voltage() { return 12800; }
+
+int32_t battery_get_current() { return std::lround(simWorld().getBatteryCurrent() * 1000); }
+
+double battery_get_temperature() { return 30; }
+
+double battery_get_capacity() { return 100; }
+
+int32_t usd_is_installed() { return 0; }
+
+int32_t usd_list_files(const char*, char*, int32_t) {
+    errno = ENXIO;
+    return PROS_ERR;
+}
+
+bool lcd_is_initialized() { return lcdInitialized; }
+
+bool lcd_initialize() {
+    lcdInitialized = true;
+    return true;
+}
+
+bool lcd_shutdown() {
+    lcdInitialized = false;
+    return true;
+}
+
+bool lcd_set_text(int16_t line, const char* text) {
+    if (!lcdInitialized || line < 0 || line >= int16_t(lcdLines.size())) return false;
+    lcdLines[line] = text;
+    return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...) {
+    char text[128];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return lcd_set_text(line, text);
+}
+
+bool lcd_clear() {
+    for (int16_t line = 0; line < int16_t(lcdLines.size()); line++) lcd_clear_line(line);
+    return lcdInitialized;
+}
+
+bool lcd_clear_line(int16_t line) { return lcd_set_text(line, ""); }
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t) { return true; }
+
+uint8_t lcd_read_buttons() { return 0; }
+
+void lcd_set_text_align(text_align_e_t) {}
+
+} // namespace pros::c
+
+namespace pros {
+Controller::Controller(controller_id_e_t id)
+    : _id(id) {}
+
+std::int32_t Controller::is_connected() { return c::controller_is_connected(_id); }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return c::controller_get_analog(_id, channel); }
+
+std::int32_t Controller::get_battery_capacity() { return c::controller_get_battery_capacity(_id); }
+
+std::int32_t Controller::get_battery_level() { return c::controller_get_battery_level(_id); }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return c::controller_get_digital(_id, button); }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_release(controller_digital_e_t button) {
+    return c::controller_get_digital_new_release(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return c::controller_clear_line(_id, line); }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear() { return c::controller_clear(_id); }
+
+namespace battery {
+double get_capacity() { return c::battery_get_capacity(); }
+
+int32_t get_current() { return c::battery_get_current(); }
+
+double get_temperature() { return c::battery_get_temperature(); }
+
+int32_t get_voltage() { return c::battery_get_voltage(); }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status() { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous() { return c::competition_is_autonomous(); }
+
+std::uint8_t is_connected() { return c::competition_is_connected(); }
+
+std::uint8_t is_disabled() { return c::competition_is_disabled(); }
+
+std::uint8_t is_field_control() { return c::competition_is_field(); }
+
+std::uint8_t is_competition_switch() { return c::competition_is_switch(); }
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed() { return c::usd_is_installed(); }
+
+std::int32_t list_files(const char* path, char* buffer, std::int32_t len) {
+    return c::usd_list_files(path, buffer, len);
+}
+} // namespace usd
+
+namespace lcd {
+bool is_initialized() { return c::lcd_is_initialized(); }
+
+bool initialize() { return c::lcd_initialize(); }
+
+bool shutdown() { return c::lcd_shutdown(); }
+
+bool set_text(std::int16_t line, std::string text) { return c::lcd_set_text(line, text.c_str()); }
+
+bool clear() { return c::lcd_clear(); }
+
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn0_cb(cb); }
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn1_cb(cb); }
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn2_cb(cb); }
+
+void set_text_align(Text_Align alignment) { c::lcd_set_text_align(static_cast<text_align_e_t>(alignment)); }
+
+std::uint8_t read_buttons() { return c::lcd_read_buttons(); }
+} // namespace lcd
+} // namespace pros
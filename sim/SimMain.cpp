@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "main.h" // IWYU pragma: keep
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "Create.hpp"
+#include "LogBuffer.hpp"
+#include "PoseEstimator.hpp"
+#include "RobotLog.hpp"
+#include "SimBatch.hpp"
+#include "SimScheduler.hpp"
+#include "SimTuning.hpp"
+#include "SimWorld.hpp"
+
+/**
+ * Runs an auton of the robot program, or a tuning motion, on the host against SimWorld, and reports how it went.
+ *
+ * Usage: sim [--routine name] [--seed N] [--time-limit ms] [--set key=value]... [--trace file.csv] [--csv]
+ *            [--result file]
+ *        sim --batch sweep.txt [--jobs N] [--out results.csv] [options given to every run]
+ *
+ * Routines:
+ * - left, right, skills: the routine, straight away. auton: autonomous(), like a match would
+ * - lateral: moveToPoint 24 inches forwards
+ * - angular: turnToHeading 90 degrees
+ * - pose: moveToPose to (24, 24, 90), with the lead from the settings
+ * - drive: the tank sticks at 20 for a second, full forwards for a second, then released
+ * - estimator: a minute of figure eights with wheels 2% bigger than the program thinks, a drifting IMU and a noisy GPS
+ *   with outliers, tracked by a PoseEstimator instead of wheel odometry. Reports how far wheel odometry alone drifted
+ *   too
+ * - intake: the bottom intake motor's VelocityController holds a velocity while a load is put on the motor, then taken
+ *   off, like a ball going through. Reports how long it took to get back to the velocity each time, and exits with 3
+ *   if either took longer than INTAKE_RECOVERY_TIME
+ * - serial: the left routine with everything the robot program sends over the radio going to stdout: the logs, the
+ *   screen task's pose as telemetry, and the motion recordings, within a bandwidth budget. Waits for the stream to drain, then
+ *   reports on stderr how close to the budget it ran and what was dropped, so stdout can be piped into
+ *   tools/mrec_decode --serial
+ *
+ * --set changes a tunable parameter, see SimSettings. --csv prints the result as a single line, for scripts and
+ * optimizers: finished, exit_ms, settle_ms, overshoot, error_in, error_deg, odom_error_in, odom_error_deg. --result
+ * writes that line to a file instead, away from the logs and telemetry the robot program writes to stdout.
+ * --batch runs every configuration of a sweep in parallel, see runBatch.
+ *
+ * Built with -DALLOCATION_CHECKS, a run exits with 2 if a tick of the motion or odometry loop allocated on the heap.
+ */
+
+void Left_side();
+void Right_side();
+void Skills();
+
+/**
+ * @brief What the runner was asked to do
+ */
+struct SimOptions {
+        std::string routine = "left";
+        std::uint32_t seed = 0;
+        /** in milliseconds, 0 for the length of the routine's period */
+        std::uint32_t timeLimit = 0;
+        std::string trace;
+        bool csv = false;
+        /** file the CSV line is written to, empty for stdout */
+        std::string result;
+        SimSettings settings;
+};
+
+// how long to keep watching a tuning motion after it returns, for late overshoot and drift
+constexpr std::uint32_t SETTLE_WATCH_TIME = 500;
+// how long the drive routine watches the robot coast after releasing the sticks, on top of SETTLE_WATCH_TIME
+constexpr std::uint32_t DRIVE_COAST_TIME = 2500;
+// how long the estimator routine drives, and how long each loop of its figure eights is
+constexpr std::uint32_t ESTIMATOR_TIME = 60000;
+constexpr std::uint32_t ESTIMATOR_LOOP_TIME = 10000;
+// port of the GPS the estimator routine adds, one the robot program doesn't use
+constexpr std::uint8_t ESTIMATOR_GPS_PORT = 20;
+// the intake routine: the motor it loads, the velocity it holds in rpm, and the load in Nm, about a third of the
+// stall torque of a green cartridge at that velocity
+constexpr std::uint8_t INTAKE_PORT = 2;
+constexpr float INTAKE_VELOCITY = 100;
+constexpr double INTAKE_LOAD = 0.3;
+// how long the intake routine spins up before the load, and watches after putting it on and taking it off
+constexpr std::uint32_t INTAKE_SPIN_UP_TIME = 1000;
+constexpr std::uint32_t INTAKE_WATCH_TIME = 1000;
+// the intake is back to the velocity when within this fraction of it, averaged over INTAKE_AVERAGE_TIME so the ripple
+// of the voltage steps doesn't count. The routine fails if that takes longer than INTAKE_RECOVERY_TIME
+constexpr float INTAKE_TOLERANCE = 0.05;
+constexpr std::uint32_t INTAKE_AVERAGE_TIME = 10;
+constexpr std::int32_t INTAKE_RECOVERY_TIME = 100;
+// bandwidth budget of the serial routine, in bytes per second, about what the V5 radio carries
+constexpr std::uint32_t SERIAL_BANDWIDTH = 2000;
+// how long the serial routine may take, and how long it waits for the stream to drain after the routine
+constexpr std::uint32_t SERIAL_TIME = 120000;
+constexpr std::uint32_t SERIAL_DRAIN_TIME = 90000;
+
+static SimTracker tracker;
+static PoseEstimator* estimator = nullptr;
+// wheel odometry alone, next to the estimator, in inches and radians like lemlib::getPose(true)
+static lemlib::Pose deadReckoning(0, 0, 0);
+// set by the routine task, so the main task knows when to stop
+static volatile bool routineDone = false;
+static volatile std::uint32_t routineEnd = 0;
+// what the intake routine measured, in milliseconds, -1 if the intake never got back to the velocity
+static std::int32_t loadRecovery = -1;
+static std::int32_t releaseRecovery = -1;
+static float slowestVelocity = 0;
+
+/**
+ * @brief Whether a routine is an auton of the robot program, instead of a tuning motion
+ */
+static bool isAuton(const std::string& routine) {
+    return routine == "left" || routine == "right" || routine == "skills" || routine == "auton";
+}
+
+/**
+ * @brief Watch the intake motor for INTAKE_WATCH_TIME
+ *
+ * @return milliseconds until it stayed within INTAKE_TOLERANCE of INTAKE_VELOCITY, -1 if it didn't
+ */
+static std::int32_t watchIntake() {
+    std::int32_t recovered = 0;
+    float sum = 0;
+    for (std::uint32_t time = 1; time <= INTAKE_WATCH_TIME; time++) {
+        pros::delay(1);
+        const float velocity = simWorld().motor(INTAKE_PORT).velocity;
+        slowestVelocity = std::min(slowestVelocity, velocity);
+        sum += velocity;
+        if (time % INTAKE_AVERAGE_TIME != 0) continue;
+        const float average = sum / INTAKE_AVERAGE_TIME;
+        sum = 0;
+        if (std::fabs(average - INTAKE_VELOCITY) > INTAKE_TOLERANCE * INTAKE_VELOCITY) recovered = -1;
+        else if (recovered < 0) recovered = time;
+    }
+    return recovered;
+}
+
+/**
+ * @brief Run a tuning motion, measuring it against its target
+ */
+static void runTuning(const SimOptions& options) {
+    if (options.routine == "lateral") {
+        tracker.setTarget(SimTracker::Kind::LATERAL, 0, 24, 0);
+        chassis.moveToPoint(0, 24, 4000, {}, false);
+    } else if (options.routine == "angular") {
+        tracker.setTarget(SimTracker::Kind::ANGULAR, 0, 0, 90);
+        chassis.turnToHeading(90, 3000, {}, false);
+    } else if (options.routine == "pose") {
+        tracker.setTarget(SimTracker::Kind::POSE, 24, 24, 90);
+        chassis.moveToPose(24, 24, 90, 5000, {.lead = options.settings.lead}, false);
+    } else if (options.routine == "estimator") {
+        // loops one way then the other, so heading errors don't cancel out
+        const std::uint32_t start = pros::millis();
+        while (pros::millis() - start < ESTIMATOR_TIME) {
+            const bool clockwise = (pros::millis() - start) / ESTIMATOR_LOOP_TIME % 2 == 0;
+            drivetrain.leftMotors->move(clockwise ? 90 : 10);
+            drivetrain.rightMotors->move(clockwise ? 10 : 90);
+            pros::delay(10);
+        }
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+    } else if (options.routine == "intake") {
+        IO2Velocity.setVelocity(INTAKE_VELOCITY);
+        pros::delay(INTAKE_SPIN_UP_TIME);
+        slowestVelocity = INTAKE_VELOCITY;
+        simWorld().setLoad(INTAKE_PORT, INTAKE_LOAD);
+        loadRecovery = watchIntake();
+        simWorld().setLoad(INTAKE_PORT, 0);
+        releaseRecovery = watchIntake();
+        IO2Velocity.setVelocity(0);
+    } else if (options.routine == "serial") {
+        Left_side();
+        robotLog().info("serial: routine done, draining");
+        // the recordings are written at the pace of the budget
+        const std::uint32_t drainStart = pros::millis();
+        while (pros::millis() - drainStart < SERIAL_DRAIN_TIME &&
+               (!bufferedLog().buffersEmpty() || chassis.getRecorder().isWriting()))
+            pros::delay(100);
+    } else {
+        // a slow creep shows the low end of the throttle curve, the push and release show the coast
+        for (int i = 0; i < 200; i++) {
+            chassis.tank(i < 100 ? 20 : 127, i < 100 ? 20 : 127);
+            pros::delay(10);
+        }
+        chassis.tank(0, 0);
+        tracker.setTarget(SimTracker::Kind::DRIVE, 0, 0, 0);
+        // a coasting drivetrain takes a while to stop
+        pros::delay(DRIVE_COAST_TIME);
+    }
+}
+
+static void runRoutine(void* param) {
+    const SimOptions& options = *static_cast<SimOptions*>(param);
+    const std::uint32_t start = pros::millis();
+    if (options.routine == "auton") {
+        autonomous();
+    } else {
+        chassis.getCalibration().wait(); // odometry must be running before moving
+        if (options.routine == "left") Left_side();
+        else if (options.routine == "right") Right_side();
+        else if (options.routine == "skills") Skills();
+        else runTuning(options);
+    }
+    routineEnd = pros::millis() - start;
+    if (!isAuton(options.routine)) pros::delay(SETTLE_WATCH_TIME);
+    routineDone = true;
+}
+
+/**
+ * @brief Whether the control loops ran without allocating. Always true unless built with -DALLOCATION_CHECKS
+ */
+static bool checkAllocations() {
+#ifdef ALLOCATION_CHECKS
+    const std::uint32_t motionTicks = chassis.getAllocatingTicks();
+    const std::uint32_t odomTicks = odomScheduler.getAllocatingTicks();
+    if (motionTicks == 0 && odomTicks == 0) return true;
+    std::fprintf(stderr, "allocating ticks: %u motion, %u odometry\n", motionTicks, odomTicks);
+    return false;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Set up the estimator routine: a worse robot, a GPS, and a PoseEstimator run by the odometry scheduler
+ *
+ * Must be called before initialize(), so the IMU calibrates with the drift
+ */
+static void setUpEstimator() {
+    SimRobotSettings robot;
+    robot.wheelScale = 1.02;
+    simWorld().setRobot(robot);
+    SimImuSettings imuSettings;
+    imuSettings.bias = 0.05;
+    simWorld().setImu(imuSettings);
+
+    // made here, not as globals, so the drivetrain and IMU are constructed first
+    static TimestampedOdom estimatorOdom(drivetrain, &imu);
+    static TimestampedOdom deadReckoningOdom(drivetrain, &imu);
+    static pros::Gps gps(ESTIMATOR_GPS_PORT);
+    static PoseEstimator poseEstimator(&estimatorOdom, &imu);
+    poseEstimator.addGps(&gps);
+    estimator = &poseEstimator;
+    odomScheduler.setUpdate([] {
+        estimator->update();
+        if (deadReckoningOdom.poll()) deadReckoning = deadReckoningOdom.integrate(deadReckoning);
+    });
+}
+
+/**
+ * @brief Print a result as the line --csv and --result write
+ */
+static void printCsv(std::FILE* out, const SimResult& result) {
+    std::fprintf(out, "%d,%u,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", result.finished, result.exitTime, result.settleTime,
+                 result.overshoot, result.error, result.headingError, result.odomError, result.odomHeadingError);
+}
+
+static bool parseOptions(int argc, char** argv, SimOptions& options) {
+    static const char* const routines[] = {"left", "right", "skills", "auton", "lateral", "angular", "pose", "drive",
+                                           "estimator", "intake", "serial"};
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--routine") == 0 && hasValue) options.routine = argv[++i];
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) options.seed = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--time-limit") == 0 && hasValue)
+            options.timeLimit = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) options.trace = argv[++i];
+        else if (std::strcmp(argv[i], "--csv") == 0) options.csv = true;
+        else if (std::strcmp(argv[i], "--result") == 0 && hasValue) options.result = argv[++i];
+        else if (std::strcmp(argv[i], "--set") == 0 && hasValue) {
+            const std::string setting = argv[++i];
+            const std::size_t equals = setting.find('=');
+            if (equals == std::string::npos ||
+                !options.settings.set(setting.substr(0, equals), setting.substr(equals + 1))) {
+                std::fprintf(stderr, "invalid setting %s\n", setting.c_str());
+                return false;
+            }
+        } else return false;
+    }
+    bool known = false;
+    for (const char* routine : routines) known |= options.routine == routine;
+    if (!known) return false;
+    // 15 seconds of auton in a match, 60 in skills
+    if (options.timeLimit == 0) options.timeLimit = options.routine == "skills" ? 60000 : 15000;
+    if (options.routine == "estimator") options.timeLimit = std::max(options.timeLimit, ESTIMATOR_TIME + 5000);
+    if (options.routine == "serial") options.timeLimit = std::max(options.timeLimit, SERIAL_TIME);
+    return true;
+}
+
+/**
+ * @brief Run a batch, if asked to. The batch options are taken out, the rest are given to every run
+ *
+ * @return the exit code, or -1 if no batch was asked for
+ */
+static int batch(int argc, char** argv) {
+    std::string sweep;
+    std::string out = "results.csv";
+    unsigned jobs = std::thread::hardware_concurrency();
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--batch") == 0 && hasValue) sweep = argv[++i];
+        else if (std::strcmp(argv[i], "--jobs") == 0 && hasValue) jobs = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue) out = argv[++i];
+        else args.push_back(argv[i]);
+    }
+    if (sweep.empty()) return -1;
+    return runBatch(sweep, jobs, out, args);
+}
+
+int main(int argc, char** argv) {
+    const int batchResult = batch(argc, argv);
+    if (batchResult >= 0) {
+        // the global constructors made tasks that never ran, so leave without waiting for them
+        std::fflush(stdout);
+        _exit(batchResult);
+    }
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--routine left|right|skills|auton|lateral|angular|pose|drive|estimator|intake|serial] "
+                     "[--seed N] [--time-limit ms] [--set key=value]... [--trace file.csv] [--csv] [--result file]\n"
+                     "       %s --batch sweep.txt [--jobs N] [--out results.csv] [options for every run]\n",
+                     argv[0], argv[0]);
+        _exit(1);
+    }
+    std::FILE* trace = nullptr;
+    if (!options.trace.empty()) {
+        trace = std::fopen(options.trace.c_str(), "w");
+        if (trace == nullptr) {
+            std::perror(options.trace.c_str());
+            _exit(1);
+        }
+        std::fprintf(trace, "time,x,y,theta,odom_x,odom_y,odom_theta\n");
+    }
+
+    // the global constructors already made the devices, so the world knows every motor
+    SimScheduler::get().start();
+    SimScheduler::get().setTickHook([] {
+        simWorld().step();
+        tracker.update();
+    });
+    simWorld().setDrivetrain(drivetrain.leftMotors->get_port_all(), drivetrain.rightMotors->get_port_all(),
+                             drivetrain.trackWidth, drivetrain.wheelDiameter, drivetrain.rpm);
+    simWorld().seed(options.seed);
+    if (options.routine == "estimator") setUpEstimator();
+
+    initialize();
+    options.settings.apply();
+    if (options.routine == "serial") {
+        chassis.getRecorder().setOutput(MotionRecorder::Output::SERIAL);
+        telemetry.setEnabled(true);
+        bufferedLog().setBandwidth(SERIAL_BANDWIDTH);
+    }
+    simWorld().setCompetitionStatus(COMPETITION_AUTONOMOUS);
+    const std::uint32_t start = pros::millis();
+    pros::Task routine(runRoutine, &options, "sim routine");
+
+    // the throughput of the log buffer, sampled once a second
+    std::uint32_t throughputSamples = 0;
+    std::uint64_t throughputTotal = 0;
+    std::uint32_t throughputMax = 0;
+    std::uint32_t lastSample = start;
+    float x, y, theta;
+    while (!routineDone && pros::millis() - start < options.timeLimit) {
+        if (pros::millis() - lastSample >= 1000) {
+            lastSample += 1000;
+            const std::uint32_t throughput = bufferedLog().getThroughput();
+            throughputSamples++;
+            throughputTotal += throughput;
+            throughputMax = std::max(throughputMax, throughput);
+        }
+        if (trace != nullptr) {
+            simWorld().getPose(x, y, theta);
+            const lemlib::Pose odom = chassis.getPose();
+            std::fprintf(trace, "%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", pros::millis() - start, x, y, theta, odom.x,
+                         odom.y, odom.theta);
+        }
+        pros::delay(10);
+    }
+
+    simWorld().getPose(x, y, theta);
+    const lemlib::Pose odom = chassis.getPose();
+    SimResult result;
+    result.finished = routineDone;
+    result.exitTime = routineDone ? routineEnd : options.timeLimit;
+    tracker.finish(result);
+    if (isAuton(options.routine)) result.settleTime = result.exitTime;
+    result.odomError = std::hypot(odom.x - x, odom.y - y);
+    result.odomHeadingError = std::remainder(odom.theta - theta, 360);
+    if (options.routine == "serial") {
+        // stdout carries the stream itself
+        std::fprintf(stderr, "budget: %u B/s\n", SERIAL_BANDWIDTH);
+        std::fprintf(stderr, "throughput: %u B/s mean, %u B/s max, over %u s\n",
+                     throughputSamples == 0 ? 0 : unsigned(throughputTotal / throughputSamples), throughputMax,
+                     throughputSamples);
+        std::fprintf(stderr, "log: %u messages dropped, high water %u B bulk, %u B priority, write load %.2f\n",
+                     bufferedLog().getDropped(), bufferedLog().getHighWater(LogLane::BULK),
+                     bufferedLog().getHighWater(LogLane::PRIORITY), bufferedLog().getWriteLoad());
+        std::fprintf(stderr, "telemetry: %u B sent, %u frames dropped\n", telemetry.getBytesSent(),
+                     telemetry.getDropped());
+        std::fprintf(stderr, "motions: %u written, %u dropped, %s\n", chassis.getRecorder().getWrittenMotions(),
+                     chassis.getRecorder().getDroppedMotions(),
+                     chassis.getRecorder().isWriting() ? "still writing" : "drained");
+    } else if (options.csv) {
+        printCsv(stdout, result);
+    } else {
+        std::printf("routine: %s\n", options.routine.c_str());
+        if (result.finished) std::printf("finished: %u ms\n", result.exitTime);
+        else std::printf("finished: no, stopped at %u ms\n", options.timeLimit);
+        if (result.settleTime >= 0) std::printf("settled: %d ms\n", result.settleTime);
+        else std::printf("settled: no\n");
+        if (!std::isnan(result.error)) {
+            std::printf("overshoot: %.2f\n", result.overshoot);
+            std::printf("target error: %.2f in, %.2f deg\n", result.error, result.headingError);
+        }
+        std::printf("true pose: %.2f, %.2f, %.2f\n", x, y, theta);
+        std::printf("odom pose: %.2f, %.2f, %.2f\n", odom.x, odom.y, odom.theta);
+        std::printf("odom error: %.2f in, %.2f deg\n", result.odomError, result.odomHeadingError);
+        if (options.routine == "intake") {
+            std::printf("intake: %.0f rpm, slowest %.1f rpm under a %.2f Nm load, %u jams\n", INTAKE_VELOCITY,
+                        slowestVelocity, INTAKE_LOAD, IO2Velocity.getJams());
+            std::printf("recovered: %d ms after the load, %d ms after taking it off\n", loadRecovery,
+                        releaseRecovery);
+        }
+        if (estimator != nullptr) {
+            std::printf("wheel odometry error: %.2f in, %.2f deg\n",
+                        std::hypot(deadReckoning.x - x, deadReckoning.y - y),
+                        std::remainder(lemlib::radToDeg(deadReckoning.theta) - theta, 360));
+            const EstimatorStats stats = estimator->getStats();
+            std::printf("gps: %u accepted, %u rejected, %u outliers read\n", stats.gpsAccepted, stats.gpsRejected,
+                        simWorld().getGpsOutliers());
+        }
+    }
+    if (trace != nullptr) std::fclose(trace);
+    if (!options.result.empty()) {
+        std::FILE* resultFile = std::fopen(options.result.c_str(), "w");
+        if (resultFile == nullptr) {
+            std::perror(options.result.c_str());
+            _exit(1);
+        }
+        printCsv(resultFile, result);
+        std::fclose(resultFile);
+    }
+    std::fflush(stdout);
+    const auto tooSlow = [](std::int32_t recovery) { return recovery < 0 || recovery > INTAKE_RECOVERY_TIME; };
+    if (options.routine == "intake" && (tooSlow(loadRecovery) || tooSlow(releaseRecovery))) {
+        std::fprintf(stderr, "intake: took longer than %d ms to recover\n", INTAKE_RECOVERY_TIME);
+        _exit(3);
+    }
+    // the other tasks are still blocked in their threads, so leave without waiting for them
+    _exit(checkAllocations() ? 0 : 2);
+}
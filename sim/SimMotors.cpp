@@ -0,0 +1,873 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <mutex>
+#include "pros/error.h"
+#include "pros/motor_group.hpp"
+#include "pros/motors.h"
+#include "pros/motors.hpp"
+#include "SimWorld.hpp"
+
+/**
+ * The motor part of the PROS API, on top of SimWorld. Like on the brain, a negative port reverses the motor, and the
+ * C++ classes call the C functions.
+ */
+
+/**
+ * @brief Get the motor on a port, or set errno if the port doesn't exist
+ */
+static SimMotor* lookup(std::int8_t port) {
+    if (port == 0 || std::abs(port) > 21) {
+        errno = ENXIO;
+        return nullptr;
+    }
+    return &simWorld().motor(std::abs(port));
+}
+
+static int sign(std::int8_t port) { return port < 0 ? -1 : 1; }
+
+/**
+ * @brief Convert a position in the encoder units of a motor to degrees
+ */
+static double toDegrees(const SimMotor& motor, double position) {
+    switch (motor.units) {
+        case pros::E_MOTOR_ENCODER_ROTATIONS: return position * 360;
+        case pros::E_MOTOR_ENCODER_COUNTS: return position * 360 / SimWorld::ticksPerRevolution(motor);
+        default: return position;
+    }
+}
+
+static double fromDegrees(const SimMotor& motor, double degrees) {
+    switch (motor.units) {
+        case pros::E_MOTOR_ENCODER_ROTATIONS: return degrees / 360;
+        case pros::E_MOTOR_ENCODER_COUNTS: return degrees * SimWorld::ticksPerRevolution(motor) / 360;
+        default: return degrees;
+    }
+}
+
+namespace pros::c {
+int32_t motor_move(int8_t port, int32_t voltage) {
+    return motor_move_voltage(port, std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+int32_t motor_brake(int8_t port) { return motor_move_velocity(port, 0); }
+
+int32_t motor_move_absolute(int8_t port, double position, const int32_t velocity) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->mode = SimMotor::Mode::POSITION;
+    motor->targetPosition = motor->zero + sign(port) * toDegrees(*motor, position);
+    motor->targetVelocity = std::min<double>(std::abs(velocity), SimWorld::freeSpeed(*motor));
+    return 1;
+}
+
+int32_t motor_move_relative(int8_t port, double position, const int32_t velocity) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->mode = SimMotor::Mode::POSITION;
+    motor->targetPosition = motor->position + sign(port) * toDegrees(*motor, position);
+    motor->targetVelocity = std::min<double>(std::abs(velocity), SimWorld::freeSpeed(*motor));
+    return 1;
+}
+
+int32_t motor_move_velocity(int8_t port, const int32_t velocity) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    const double free = SimWorld::freeSpeed(*motor);
+    motor->mode = SimMotor::Mode::VELOCITY;
+    motor->targetVelocity = sign(port) * std::clamp<double>(velocity, -free, free);
+    return 1;
+}
+
+int32_t motor_move_voltage(int8_t port, const int32_t voltage) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->mode = SimMotor::Mode::VOLTAGE;
+    motor->targetVoltage = sign(port) * std::clamp(voltage, -12000, 12000);
+    return 1;
+}
+
+int32_t motor_modify_profiled_velocity(int8_t port, const int32_t velocity) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    if (motor->mode == SimMotor::Mode::POSITION)
+        motor->targetVelocity = std::min<double>(std::abs(velocity), SimWorld::freeSpeed(*motor));
+    return 1;
+}
+
+double motor_get_target_position(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return fromDegrees(*motor, sign(port) * (motor->targetPosition - motor->zero));
+}
+
+int32_t motor_get_target_velocity(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->mode == SimMotor::Mode::VELOCITY ? std::lround(sign(port) * motor->targetVelocity) : 0;
+}
+
+double motor_get_actual_velocity(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return sign(port) * motor->reportedVelocity;
+}
+
+int32_t motor_get_current_draw(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::lround(std::abs(motor->current) * 1000);
+}
+
+int32_t motor_get_direction(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return sign(port) * motor->velocity < 0 ? -1 : 1;
+}
+
+double motor_get_efficiency(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    const double electrical = motor->voltage * motor->current;
+    const double mechanical = motor->torque * motor->velocity * 2 * M_PI / 60;
+    if (electrical <= 0 || mechanical <= 0) return 0;
+    return std::min(100.0, mechanical / electrical * 100);
+}
+
+int32_t motor_is_over_current(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::abs(motor->current) * 1000 >= motor->currentLimit * 0.99;
+}
+
+int32_t motor_is_over_temp(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->temperature >= 55;
+}
+
+uint32_t motor_get_faults(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    uint32_t faults = E_MOTOR_FAULT_NO_FAULTS;
+    if (motor_is_over_temp(port)) faults |= E_MOTOR_FAULT_MOTOR_OVER_TEMP;
+    if (motor_is_over_current(port)) faults |= E_MOTOR_FAULT_OVER_CURRENT;
+    return faults;
+}
+
+uint32_t motor_get_flags(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    uint32_t flags = E_MOTOR_FLAGS_NONE;
+    if (std::abs(motor->velocity) < 1) flags |= E_MOTOR_FLAGS_ZERO_VELOCITY;
+    if (std::abs(motor->position - motor->zero) < 1) flags |= E_MOTOR_FLAGS_ZERO_POSITION;
+    return flags;
+}
+
+int32_t motor_get_raw_position(int8_t port, uint32_t* const timestamp) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    if (timestamp != nullptr) *timestamp = simWorld().getTime();
+    return std::lround(sign(port) * motor->position * SimWorld::ticksPerRevolution(*motor) / 360);
+}
+
+double motor_get_position(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return fromDegrees(*motor, sign(port) * (motor->position - motor->zero));
+}
+
+double motor_get_power(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return std::abs(motor->voltage * motor->current);
+}
+
+double motor_get_temperature(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return motor->temperature;
+}
+
+double motor_get_torque(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return sign(port) * motor->torque;
+}
+
+int32_t motor_get_voltage(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::lround(sign(port) * motor->voltage * 1000);
+}
+
+int32_t motor_set_zero_position(int8_t port, const double position) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    // the position that used to read `position` reads 0 from now on
+    motor->zero += sign(port) * toDegrees(*motor, position);
+    return 1;
+}
+
+int32_t motor_tare_position(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->zero = motor->position;
+    return 1;
+}
+
+int32_t motor_set_brake_mode(int8_t port, const motor_brake_mode_e_t mode) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->brakeMode = mode;
+    return 1;
+}
+
+int32_t motor_set_current_limit(int8_t port, const int32_t limit) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->currentLimit = std::clamp(limit, 0, 2500);
+    return 1;
+}
+
+int32_t motor_set_encoder_units(int8_t port, const motor_encoder_units_e_t units) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->units = units;
+    return 1;
+}
+
+int32_t motor_set_gearing(int8_t port, const motor_gearset_e_t gearset) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    if (gearset < E_MOTOR_GEARSET_36 || gearset > E_MOTOR_GEARSET_06) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    motor->gearset = gearset;
+    return 1;
+}
+
+int32_t motor_set_voltage_limit(int8_t port, const int32_t limit) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->voltageLimit = std::clamp(limit, 0, 12000);
+    return 1;
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return E_MOTOR_BRAKE_INVALID;
+    return motor_brake_mode_e_t(motor->brakeMode);
+}
+
+int32_t motor_get_current_limit(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->currentLimit;
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return E_MOTOR_ENCODER_INVALID;
+    return motor_encoder_units_e_t(motor->units);
+}
+
+motor_gearset_e_t motor_get_gearing(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return E_MOTOR_GEARSET_INVALID;
+    return motor_gearset_e_t(motor->gearset);
+}
+
+int32_t motor_get_voltage_limit(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->voltageLimit;
+}
+
+motor_type_e_t motor_get_type(int8_t port) {
+    SimMotor* motor = lookup(port);
+    if (motor == nullptr) return E_MOTOR_TYPE_INVALID;
+    return E_MOTOR_TYPE_V5;
+}
+} // namespace pros::c
+
+namespace pros::v5 {
+Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor),
+      _port(port) {
+    if (gearset != MotorGears::invalid) set_gearing(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units(encoder_units);
+}
+
+std::int32_t Motor::move(std::int32_t voltage) const { return c::motor_move(_port, voltage); }
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    return c::motor_move_absolute(_port, position, velocity);
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    return c::motor_move_relative(_port, position, velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const { return c::motor_move_velocity(_port, velocity); }
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const { return c::motor_move_voltage(_port, voltage); }
+
+std::int32_t Motor::brake() const { return c::motor_brake(_port); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    return c::motor_modify_profiled_velocity(_port, velocity);
+}
+
+double Motor::get_target_position(const std::uint8_t) const { return c::motor_get_target_position(_port); }
+
+std::int32_t Motor::get_target_velocity(const std::uint8_t) const { return c::motor_get_target_velocity(_port); }
+
+double Motor::get_actual_velocity(const std::uint8_t) const { return c::motor_get_actual_velocity(_port); }
+
+std::int32_t Motor::get_current_draw(const std::uint8_t) const { return c::motor_get_current_draw(_port); }
+
+std::int32_t Motor::get_direction(const std::uint8_t) const { return c::motor_get_direction(_port); }
+
+double Motor::get_efficiency(const std::uint8_t) const { return c::motor_get_efficiency(_port); }
+
+std::uint32_t Motor::get_faults(const std::uint8_t) const { return c::motor_get_faults(_port); }
+
+std::uint32_t Motor::get_flags(const std::uint8_t) const { return c::motor_get_flags(_port); }
+
+double Motor::get_position(const std::uint8_t) const { return c::motor_get_position(_port); }
+
+double Motor::get_power(const std::uint8_t) const { return c::motor_get_power(_port); }
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t) const {
+    return c::motor_get_raw_position(_port, timestamp);
+}
+
+double Motor::get_temperature(const std::uint8_t) const { return c::motor_get_temperature(_port); }
+
+double Motor::get_torque(const std::uint8_t) const { return c::motor_get_torque(_port); }
+
+std::int32_t Motor::get_voltage(const std::uint8_t) const { return c::motor_get_voltage(_port); }
+
+std::int32_t Motor::is_over_current(const std::uint8_t) const { return c::motor_is_over_current(_port); }
+
+std::int32_t Motor::is_over_temp(const std::uint8_t) const { return c::motor_is_over_temp(_port); }
+
+MotorBrake Motor::get_brake_mode(const std::uint8_t) const {
+    return static_cast<MotorBrake>(c::motor_get_brake_mode(_port));
+}
+
+std::int32_t Motor::get_current_limit(const std::uint8_t) const { return c::motor_get_current_limit(_port); }
+
+MotorUnits Motor::get_encoder_units(const std::uint8_t) const {
+    return static_cast<MotorUnits>(c::motor_get_encoder_units(_port));
+}
+
+MotorGears Motor::get_gearing(const std::uint8_t) const {
+    return static_cast<MotorGears>(c::motor_get_gearing(_port));
+}
+
+std::int32_t Motor::get_voltage_limit(const std::uint8_t) const { return c::motor_get_voltage_limit(_port); }
+
+std::int32_t Motor::is_reversed(const std::uint8_t) const { return _port < 0; }
+
+MotorType Motor::get_type(const std::uint8_t) const { return static_cast<MotorType>(c::motor_get_type(_port)); }
+
+std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t) const {
+    return c::motor_set_brake_mode(_port, static_cast<motor_brake_mode_e_t>(mode));
+}
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t) const {
+    return c::motor_set_brake_mode(_port, mode);
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t) const {
+    return c::motor_set_current_limit(_port, limit);
+}
+
+std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t) const {
+    return c::motor_set_encoder_units(_port, static_cast<motor_encoder_units_e_t>(units));
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t) const {
+    return c::motor_set_encoder_units(_port, units);
+}
+
+std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t) const {
+    return c::motor_set_gearing(_port, static_cast<motor_gearset_e_t>(gearset));
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t) const {
+    return c::motor_set_gearing(_port, gearset);
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t) {
+    _port = reverse ? -std::abs(_port) : std::abs(_port);
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t) const {
+    return c::motor_set_voltage_limit(_port, limit);
+}
+
+std::int32_t Motor::set_zero_position(const double position, const std::uint8_t) const {
+    return c::motor_set_zero_position(_port, position);
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t) const { return c::motor_tare_position(_port); }
+
+std::int8_t Motor::size() const { return 1; }
+
+std::int8_t Motor::get_port(const std::uint8_t) const { return _port; }
+
+// a motor is a group of one
+std::vector<double> Motor::get_target_position_all() const { return {get_target_position()}; }
+
+std::vector<std::int32_t> Motor::get_target_velocity_all() const { return {get_target_velocity()}; }
+
+std::vector<double> Motor::get_actual_velocity_all() const { return {get_actual_velocity()}; }
+
+std::vector<std::int32_t> Motor::get_current_draw_all() const { return {get_current_draw()}; }
+
+std::vector<std::int32_t> Motor::get_direction_all() const { return {get_direction()}; }
+
+std::vector<double> Motor::get_efficiency_all() const { return {get_efficiency()}; }
+
+std::vector<std::uint32_t> Motor::get_faults_all() const { return {get_faults()}; }
+
+std::vector<std::uint32_t> Motor::get_flags_all() const { return {get_flags()}; }
+
+std::vector<double> Motor::get_position_all() const { return {get_position()}; }
+
+std::vector<double> Motor::get_power_all() const { return {get_power()}; }
+
+std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return {get_raw_position(timestamp)};
+}
+
+std::vector<double> Motor::get_temperature_all() const { return {get_temperature()}; }
+
+std::vector<double> Motor::get_torque_all() const { return {get_torque()}; }
+
+std::vector<std::int32_t> Motor::get_voltage_all() const { return {get_voltage()}; }
+
+std::vector<std::int32_t> Motor::is_over_current_all() const { return {is_over_current()}; }
+
+std::vector<std::int32_t> Motor::is_over_temp_all() const { return {is_over_temp()}; }
+
+std::vector<MotorBrake> Motor::get_brake_mode_all() const { return {get_brake_mode()}; }
+
+std::vector<std::int32_t> Motor::get_current_limit_all() const { return {get_current_limit()}; }
+
+std::vector<MotorUnits> Motor::get_encoder_units_all() const { return {get_encoder_units()}; }
+
+std::vector<MotorGears> Motor::get_gearing_all() const { return {get_gearing()}; }
+
+std::vector<std::int8_t> Motor::get_port_all() const { return {_port}; }
+
+std::vector<std::int32_t> Motor::get_voltage_limit_all() const { return {get_voltage_limit()}; }
+
+std::vector<std::int32_t> Motor::is_reversed_all() const { return {is_reversed()}; }
+
+std::vector<MotorType> Motor::get_type_all() const { return {get_type()}; }
+
+std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_brake_mode_all(const motor_brake_mode_e_t mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const { return set_current_limit(limit); }
+
+std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const { return set_encoder_units(units); }
+
+std::int32_t Motor::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units(units);
+}
+
+std::int32_t Motor::set_gearing_all(const MotorGears gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_gearing_all(const motor_gearset_e_t gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_reversed_all(const bool reverse) { return set_reversed(reverse); }
+
+std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const { return set_voltage_limit(limit); }
+
+std::int32_t Motor::set_zero_position_all(const double position) const { return set_zero_position(position); }
+
+std::int32_t Motor::tare_position_all() const { return tare_position(); }
+
+/**
+ * @brief Call a C function on every motor of a group
+ *
+ * @return 1, or PROS_ERR if any call failed
+ */
+template <typename F> static std::int32_t forEach(const std::vector<std::int8_t>& ports, F function) {
+    std::int32_t result = 1;
+    for (std::int8_t port : ports)
+        if (function(port) == PROS_ERR) result = PROS_ERR;
+    return result;
+}
+
+/**
+ * @brief Call a C function on every motor of a group, and collect the results
+ */
+template <typename T, typename F> static std::vector<T> collect(const std::vector<std::int8_t>& ports, F function) {
+    std::vector<T> results;
+    for (std::int8_t port : ports) results.push_back(static_cast<T>(function(port)));
+    return results;
+}
+
+/**
+ * @brief Call a C function on one motor of a group, or set errno if there is no motor at the index
+ */
+template <typename T, typename F>
+static T atIndex(const std::vector<std::int8_t>& ports, std::uint8_t index, T error, F function) {
+    if (index >= ports.size()) {
+        errno = EOVERFLOW;
+        return error;
+    }
+    return static_cast<T>(function(ports[index]));
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : _ports(ports) {
+    if (gearset != MotorGears::invalid) set_gearing_all(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units_all(encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor& motor_group)
+    : _ports(motor_group.get_port_all()) {}
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_move(port, voltage); });
+}
+
+std::int32_t MotorGroup::move_absolute(const double position, const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_move_absolute(port, position, velocity); });
+}
+
+std::int32_t MotorGroup::move_relative(const double position, const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_move_relative(port, position, velocity); });
+}
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_move_velocity(port, velocity); });
+}
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_move_voltage(port, voltage); });
+}
+
+std::int32_t MotorGroup::brake() const { return forEach(_ports, c::motor_brake); }
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_modify_profiled_velocity(port, velocity); });
+}
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_target_position);
+}
+
+std::vector<double> MotorGroup::get_target_position_all() const {
+    return collect<double>(_ports, c::motor_get_target_position);
+}
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_target_velocity);
+}
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_target_velocity);
+}
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_actual_velocity);
+}
+
+std::vector<double> MotorGroup::get_actual_velocity_all() const {
+    return collect<double>(_ports, c::motor_get_actual_velocity);
+}
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_current_draw);
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_current_draw);
+}
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_direction);
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_direction);
+}
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_efficiency);
+}
+
+std::vector<double> MotorGroup::get_efficiency_all() const {
+    return collect<double>(_ports, c::motor_get_efficiency);
+}
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const {
+    return atIndex<std::uint32_t>(_ports, index, PROS_ERR, c::motor_get_faults);
+}
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all() const {
+    return collect<std::uint32_t>(_ports, c::motor_get_faults);
+}
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const {
+    return atIndex<std::uint32_t>(_ports, index, PROS_ERR, c::motor_get_flags);
+}
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all() const {
+    return collect<std::uint32_t>(_ports, c::motor_get_flags);
+}
+
+double MotorGroup::get_position(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_position);
+}
+
+std::vector<double> MotorGroup::get_position_all() const { return collect<double>(_ports, c::motor_get_position); }
+
+double MotorGroup::get_power(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_power);
+}
+
+std::vector<double> MotorGroup::get_power_all() const { return collect<double>(_ports, c::motor_get_power); }
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR,
+                   [&](std::int8_t port) { return c::motor_get_raw_position(port, timestamp); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return collect<std::int32_t>(_ports, [&](std::int8_t port) { return c::motor_get_raw_position(port, timestamp); });
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_temperature);
+}
+
+std::vector<double> MotorGroup::get_temperature_all() const {
+    return collect<double>(_ports, c::motor_get_temperature);
+}
+
+double MotorGroup::get_torque(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, c::motor_get_torque);
+}
+
+std::vector<double> MotorGroup::get_torque_all() const { return collect<double>(_ports, c::motor_get_torque); }
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_voltage);
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_voltage);
+}
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_is_over_current);
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all() const {
+    return collect<std::int32_t>(_ports, c::motor_is_over_current);
+}
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_is_over_temp);
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all() const {
+    return collect<std::int32_t>(_ports, c::motor_is_over_temp);
+}
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorBrake::invalid, c::motor_get_brake_mode);
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all() const {
+    return collect<MotorBrake>(_ports, c::motor_get_brake_mode);
+}
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_current_limit);
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_current_limit);
+}
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorUnits::invalid, c::motor_get_encoder_units);
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all() const {
+    return collect<MotorUnits>(_ports, c::motor_get_encoder_units);
+}
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorGears::invalid, c::motor_get_gearing);
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all() const { return collect<MotorGears>(_ports, c::motor_get_gearing); }
+
+std::vector<std::int8_t> MotorGroup::get_port_all() const { return _ports; }
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_get_voltage_limit);
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all() const {
+    return collect<std::int32_t>(_ports, c::motor_get_voltage_limit);
+}
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](std::int8_t port) { return port < 0; });
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all() const {
+    return collect<std::int32_t>(_ports, [](std::int8_t port) { return port < 0; });
+}
+
+MotorType MotorGroup::get_type(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorType::invalid, c::motor_get_type);
+}
+
+std::vector<MotorType> MotorGroup::get_type_all() const { return collect<MotorType>(_ports, c::motor_get_type); }
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    return set_brake_mode(static_cast<motor_brake_mode_e_t>(mode), index);
+}
+
+std::int32_t MotorGroup::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](std::int8_t port) { return c::motor_set_brake_mode(port, mode); });
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const {
+    return set_brake_mode_all(static_cast<motor_brake_mode_e_t>(mode));
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const motor_brake_mode_e_t mode) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_brake_mode(port, mode); });
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](std::int8_t port) { return c::motor_set_current_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_current_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    return set_encoder_units(static_cast<motor_encoder_units_e_t>(units), index);
+}
+
+std::int32_t MotorGroup::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR,
+                   [&](std::int8_t port) { return c::motor_set_encoder_units(port, units); });
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const {
+    return set_encoder_units_all(static_cast<motor_encoder_units_e_t>(units));
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_encoder_units(port, units); });
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<motor_gearset_e_t> gearsets) const {
+    std::int32_t result = 1;
+    for (std::size_t i = 0; i < std::min(gearsets.size(), _ports.size()); i++)
+        if (c::motor_set_gearing(_ports[i], gearsets[i]) == PROS_ERR) result = PROS_ERR;
+    return result;
+}
+
+std::int32_t MotorGroup::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](std::int8_t port) { return c::motor_set_gearing(port, gearset); });
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<MotorGears> gearsets) const {
+    std::vector<motor_gearset_e_t> converted;
+    for (MotorGears gearset : gearsets) converted.push_back(static_cast<motor_gearset_e_t>(gearset));
+    return set_gearing(converted);
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    return set_gearing(static_cast<motor_gearset_e_t>(gearset), index);
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const {
+    return set_gearing_all(static_cast<motor_gearset_e_t>(gearset));
+}
+
+std::int32_t MotorGroup::set_gearing_all(const motor_gearset_e_t gearset) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_gearing(port, gearset); });
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    if (index >= _ports.size()) {
+        errno = EOVERFLOW;
+        return PROS_ERR;
+    }
+    _ports[index] = reverse ? -std::abs(_ports[index]) : std::abs(_ports[index]);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+    for (std::int8_t& port : _ports) port = reverse ? -std::abs(port) : std::abs(port);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](std::int8_t port) { return c::motor_set_voltage_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_voltage_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR,
+                   [&](std::int8_t port) { return c::motor_set_zero_position(port, position); });
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const {
+    return forEach(_ports, [&](std::int8_t port) { return c::motor_set_zero_position(port, position); });
+}
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, c::motor_tare_position);
+}
+
+std::int32_t MotorGroup::tare_position_all() const { return forEach(_ports, c::motor_tare_position); }
+
+std::int8_t MotorGroup::size() const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const {
+    return atIndex<std::int8_t>(_ports, index, PROS_ERR_BYTE, [](std::int8_t port) { return port; });
+}
+
+void MotorGroup::operator+=(AbstractMotor& other) { append(other); }
+
+void MotorGroup::append(AbstractMotor& other) {
+    std::lock_guard<pros::Mutex> lock(_MotorGroup_mutex);
+    for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) {
+    std::lock_guard<pros::Mutex> lock(_MotorGroup_mutex);
+    std::erase_if(_ports, [&](std::int8_t other) { return std::abs(other) == std::abs(port); });
+}
+} // namespace pros::v5
@@ -0,0 +1,203 @@
+#include <cerrno>
+#include <system_error>
+#include "pros/rtos.hpp"
+#include "SimScheduler.hpp"
+
+/**
+ * The RTOS part of the PROS API, on top of SimScheduler. task_t and mutex_t are SimScheduler handles.
+ */
+
+using SimTask = SimScheduler::Task;
+using SimMutex = SimScheduler::Mutex;
+
+static SimScheduler& scheduler() { return SimScheduler::get(); }
+
+static SimTask* toTask(pros::task_t task) { return static_cast<SimTask*>(task); }
+
+static SimMutex* toMutex(pros::mutex_t mutex) { return static_cast<SimMutex*>(mutex); }
+
+namespace pros::c {
+uint32_t millis() { return scheduler().getTime(); }
+
+uint64_t micros() { return uint64_t(scheduler().getTime()) * 1000; }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t, const char* const name) {
+    return scheduler().create(function, parameters, prio, name);
+}
+
+void task_delete(task_t task) { scheduler().remove(toTask(task)); }
+
+void task_delay(const uint32_t milliseconds) { scheduler().delay(milliseconds); }
+
+void delay(const uint32_t milliseconds) { scheduler().delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) { scheduler().delayUntil(prev_time, delta); }
+
+uint32_t task_get_priority(task_t task) {
+    return task == nullptr ? scheduler().current()->priority : toTask(task)->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) { scheduler().setPriority(toTask(task), prio); }
+
+task_state_e_t task_get_state(task_t task) {
+    SimTask* simTask = task == nullptr ? scheduler().current() : toTask(task);
+    switch (simTask->state) {
+        case SimScheduler::State::RUNNING: return E_TASK_STATE_RUNNING;
+        case SimScheduler::State::READY: return E_TASK_STATE_READY;
+        case SimScheduler::State::BLOCKED: return E_TASK_STATE_BLOCKED;
+        case SimScheduler::State::SUSPENDED: return E_TASK_STATE_SUSPENDED;
+        case SimScheduler::State::DELETED: return E_TASK_STATE_DELETED;
+    }
+    return E_TASK_STATE_INVALID;
+}
+
+void task_suspend(task_t task) { scheduler().suspend(toTask(task)); }
+
+void task_resume(task_t task) { scheduler().resume(toTask(task)); }
+
+uint32_t task_get_count() { return scheduler().count(); }
+
+char* task_get_name(task_t task) {
+    SimTask* simTask = task == nullptr ? scheduler().current() : toTask(task);
+    return simTask->name.data();
+}
+
+task_t task_get_by_name(const char* name) { return scheduler().find(name); }
+
+task_t task_get_current() { return scheduler().current(); }
+
+uint32_t task_notify(task_t task) {
+    scheduler().notify(toTask(task), 0, E_NOTIFY_ACTION_INCR, nullptr);
+    return 1;
+}
+
+void task_join(task_t task) { scheduler().join(toTask(task)); }
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    return scheduler().notify(toTask(task), value, action, prev_value);
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    return scheduler().notifyTake(clear_on_exit, timeout);
+}
+
+bool task_notify_clear(task_t task) { return scheduler().notifyClear(toTask(task)); }
+
+mutex_t mutex_create() { return scheduler().createMutex(false); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) { return scheduler().take(toMutex(mutex), timeout); }
+
+bool mutex_give(mutex_t mutex) { return scheduler().give(toMutex(mutex)); }
+
+mutex_t mutex_recursive_create() { return scheduler().createMutex(true); }
+
+bool mutex_recursive_take(mutex_t mutex, uint32_t timeout) { return scheduler().take(toMutex(mutex), timeout); }
+
+bool mutex_recursive_give(mutex_t mutex) { return scheduler().give(toMutex(mutex)); }
+
+void mutex_delete(mutex_t mutex) { scheduler().deleteMutex(toMutex(mutex)); }
+} // namespace pros::c
+
+namespace pros::rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task)
+    : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point(duration(c::millis())); }
+
+/**
+ * @brief Create the mutex the first time it is used, for mutexes that were constant initialized
+ */
+template <typename M> static mutex_t lazyInit(std::atomic<mutex_t>& mutex, M create) {
+    mutex_t current = mutex.load();
+    if (current != nullptr) return current;
+    mutex_t created = create();
+    if (mutex.compare_exchange_strong(current, created)) return created;
+    c::mutex_delete(created);
+    return current;
+}
+
+mutex_t Mutex::lazy_init() { return lazyInit(mutex, c::mutex_create); }
+
+bool Mutex::take() { return c::mutex_take(lazy_init(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(lazy_init(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(lazy_init()); }
+
+void Mutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(EDEADLK, std::system_category(), "Cannot obtain lock!");
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+
+Mutex::~Mutex() { c::mutex_delete(mutex.load()); }
+
+mutex_t RecursiveMutex::lazy_init() { return lazyInit(mutex, c::mutex_recursive_create); }
+
+bool RecursiveMutex::take() { return c::mutex_recursive_take(lazy_init(), TIMEOUT_MAX); }
+
+bool RecursiveMutex::take(std::uint32_t timeout) { return c::mutex_recursive_take(lazy_init(), timeout); }
+
+bool RecursiveMutex::give() { return c::mutex_recursive_give(lazy_init()); }
+
+void RecursiveMutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(EDEADLK, std::system_category(), "Cannot obtain lock!");
+}
+
+void RecursiveMutex::unlock() { give(); }
+
+bool RecursiveMutex::try_lock() { return take(0); }
+
+RecursiveMutex::~RecursiveMutex() { c::mutex_delete(mutex.load()); }
+} // namespace pros::rtos
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "SimScheduler.hpp"
+
+// same as TIMEOUT_MAX and TASK_PRIORITY_DEFAULT
+constexpr std::uint32_t FOREVER = 0xFFFFFFFF;
+constexpr std::uint32_t DEFAULT_PRIORITY = 8;
+
+static thread_local SimScheduler::Task* threadTask = nullptr;
+
+SimScheduler& SimScheduler::get() {
+    // never destroyed, the threads of tasks that never finish still wait on it at exit
+    static SimScheduler* scheduler = new SimScheduler();
+    return *scheduler;
+}
+
+void SimScheduler::start() {
+    Lock lock(mutex);
+    self();
+    started = true;
+}
+
+void SimScheduler::setTickHook(std::function<void()> hook) {
+    Lock lock(mutex);
+    tickHook = std::move(hook);
+}
+
+std::uint32_t SimScheduler::getTime() {
+    Lock lock(mutex);
+    return time;
+}
+
+SimScheduler::Task* SimScheduler::self() {
+    if (threadTask != nullptr) return threadTask;
+    if (running != nullptr) {
+        std::fprintf(stderr, "sim: a thread that isn't a task called the PROS API\n");
+        std::abort();
+    }
+    tasks.push_back(std::make_unique<Task>());
+    Task* task = tasks.back().get();
+    task->name = "main";
+    task->priority = DEFAULT_PRIORITY;
+    task->state = State::RUNNING;
+    running = task;
+    threadTask = task;
+    return task;
+}
+
+void SimScheduler::makeReady(Task* task) {
+    task->state = State::READY;
+    task->readyOrder = ++readyOrder;
+    task->timed = false;
+}
+
+SimScheduler::Task* SimScheduler::nextReady() {
+    Task* next = nullptr;
+    for (const std::unique_ptr<Task>& task : tasks) {
+        if (task->state != State::READY) continue;
+        if (next == nullptr || task->priority > next->priority ||
+            (task->priority == next->priority && task->readyOrder < next->readyOrder))
+            next = task.get();
+    }
+    return next;
+}
+
+void SimScheduler::tick() {
+    time++;
+    if (tickHook) tickHook();
+    for (const std::unique_ptr<Task>& task : tasks) {
+        if (task->state != State::BLOCKED || !task->timed || task->wakeTime > time) continue;
+        // the timeout ran out, so stop waiting for whatever it was
+        if (task->waitingForMutex != nullptr) {
+            std::deque<Task*>& waiters = task->waitingForMutex->waiters;
+            waiters.erase(std::find(waiters.begin(), waiters.end(), task.get()));
+            task->waitingForMutex = nullptr;
+        }
+        task->waitingForNotify = false;
+        makeReady(task.get());
+    }
+}
+
+void SimScheduler::switchAway(Lock& lock, Task* task) {
+    Task* next;
+    while ((next = nextReady()) == nullptr) tick();
+    next->state = State::RUNNING;
+    running = next;
+    next->wake.notify_one();
+    if (task->state == State::DELETED) return;
+    task->wake.wait(lock, [&] { return running == task; });
+}
+
+void SimScheduler::preempt(Lock& lock, Task* task) {
+    if (!started) return;
+    Task* next = nextReady();
+    if (next == nullptr || next->priority <= task->priority) return;
+    makeReady(task);
+    switchAway(lock, task);
+}
+
+void SimScheduler::wakeJoiners(Task* task) {
+    for (const std::unique_ptr<Task>& joiner : tasks) {
+        if (joiner->state != State::BLOCKED || joiner->waitingForTask != task) continue;
+        joiner->waitingForTask = nullptr;
+        makeReady(joiner.get());
+    }
+}
+
+SimScheduler::Task* SimScheduler::create(void (*function)(void*), void* parameters, std::uint32_t priority,
+                                         const char* name) {
+    Lock lock(mutex);
+    Task* creator = self();
+    tasks.push_back(std::make_unique<Task>());
+    Task* task = tasks.back().get();
+    task->name = name != nullptr ? name : "";
+    task->priority = priority;
+    makeReady(task);
+    std::thread([this, task, function, parameters] {
+        threadTask = task;
+        {
+            Lock lock(mutex);
+            task->wake.wait(lock, [&] { return running == task; });
+        }
+        function(parameters);
+        Lock lock(mutex);
+        task->state = State::DELETED;
+        wakeJoiners(task);
+        switchAway(lock, task);
+    }).detach();
+    preempt(lock, creator);
+    return task;
+}
+
+void SimScheduler::remove(Task* task) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (task == nullptr) task = current;
+    if (task->state == State::DELETED) return;
+    if (task->waitingForMutex != nullptr) {
+        std::deque<Task*>& waiters = task->waitingForMutex->waiters;
+        waiters.erase(std::find(waiters.begin(), waiters.end(), task));
+        task->waitingForMutex = nullptr;
+    }
+    task->state = State::DELETED;
+    wakeJoiners(task);
+    if (task != current) {
+        // the thread of the deleted task waits for the run token forever
+        preempt(lock, current);
+        return;
+    }
+    switchAway(lock, task);
+    task->wake.wait(lock, [] { return false; });
+}
+
+SimScheduler::Task* SimScheduler::current() {
+    Lock lock(mutex);
+    return self();
+}
+
+SimScheduler::Task* SimScheduler::find(const char* name) {
+    Lock lock(mutex);
+    for (const std::unique_ptr<Task>& task : tasks)
+        if (task->state != State::DELETED && task->name == name) return task.get();
+    return nullptr;
+}
+
+std::uint32_t SimScheduler::count() {
+    Lock lock(mutex);
+    return std::count_if(tasks.begin(), tasks.end(),
+                         [](const std::unique_ptr<Task>& task) { return task->state != State::DELETED; });
+}
+
+void SimScheduler::delay(std::uint32_t milliseconds) {
+    Lock lock(mutex);
+    Task* task = self();
+    // a delay of 0 lets the other tasks of the same priority run
+    if (milliseconds == 0) makeReady(task);
+    else {
+        task->state = State::BLOCKED;
+        task->timed = true;
+        task->wakeTime = time + milliseconds;
+    }
+    switchAway(lock, task);
+}
+
+void SimScheduler::delayUntil(std::uint32_t* previous, std::uint32_t delta) {
+    Lock lock(mutex);
+    Task* task = self();
+    const std::uint32_t wakeTime = *previous + delta;
+    *previous = wakeTime;
+    // a wake time that has passed doesn't block, like FreeRTOS
+    if (std::int32_t(wakeTime - time) <= 0) return;
+    task->state = State::BLOCKED;
+    task->timed = true;
+    task->wakeTime = wakeTime;
+    switchAway(lock, task);
+}
+
+void SimScheduler::setPriority(Task* task, std::uint32_t priority) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (task == nullptr) task = current;
+    task->priority = priority;
+    preempt(lock, current);
+}
+
+void SimScheduler::suspend(Task* task) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (task == nullptr) task = current;
+    if (task->state == State::DELETED) return;
+    if (task->waitingForMutex != nullptr) {
+        std::deque<Task*>& waiters = task->waitingForMutex->waiters;
+        waiters.erase(std::find(waiters.begin(), waiters.end(), task));
+        task->waitingForMutex = nullptr;
+    }
+    task->state = State::SUSPENDED;
+    task->timed = false;
+    if (task == current) switchAway(lock, task);
+}
+
+void SimScheduler::resume(Task* task) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (task->state != State::SUSPENDED) return;
+    makeReady(task);
+    preempt(lock, current);
+}
+
+void SimScheduler::join(Task* task) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (task->state == State::DELETED || task == current) return;
+    current->state = State::BLOCKED;
+    current->waitingForTask = task;
+    switchAway(lock, current);
+}
+
+std::uint32_t SimScheduler::notify(Task* task, std::uint32_t value, int action, std::uint32_t* previous) {
+    Lock lock(mutex);
+    Task* current = self();
+    if (previous != nullptr) *previous = task->notifyValue;
+    std::uint32_t result = 0;
+    // the actions of notify_action_e_t
+    switch (action) {
+        case 1: task->notifyValue |= value; break;
+        case 2: task->notifyValue++; break;
+        case 3: task->notifyValue = value; break;
+        case 4:
+            if (task->notifyPending) result = 1;
+            else task->notifyValue = value;
+            break;
+        default: break;
+    }
+    task->notifyPending = true;
+    if (task->state == State::BLOCKED && task->waitingForNotify) {
+        task->waitingForNotify = false;
+        makeReady(task);
+        preempt(lock, current);
+    }
+    return result;
+}
+
+std::uint32_t SimScheduler::notifyTake(bool clear, std::uint32_t timeout) {
+    Lock lock(mutex);
+    Task* task = self();
+    if (task->notifyValue == 0 && timeout != 0) {
+        task->state = State::BLOCKED;
+        task->waitingForNotify = true;
+        task->timed = timeout != FOREVER;
+        task->wakeTime = time + timeout;
+        switchAway(lock, task);
+    }
+    const std::uint32_t value = task->notifyValue;
+    if (value != 0) task->notifyValue = clear ? 0 : value - 1;
+    task->notifyPending = false;
+    return value;
+}
+
+bool SimScheduler::notifyClear(Task* task) {
+    Lock lock(mutex);
+    if (task == nullptr) task = self();
+    const bool pending = task->notifyPending;
+    task->notifyPending = false;
+    return pending;
+}
+
+SimScheduler::Mutex* SimScheduler::createMutex(bool recursive) {
+    Lock lock(mutex);
+    mutexes.push_back(std::make_unique<Mutex>());
+    mutexes.back()->recursive = recursive;
+    return mutexes.back().get();
+}
+
+void SimScheduler::deleteMutex(Mutex*) {
+    // kept, so a task that still holds a handle doesn't crash the simulation
+}
+
+bool SimScheduler::take(Mutex* m, std::uint32_t timeout) {
+    Lock lock(mutex);
+    Task* task = self();
+    if (m->owner == nullptr || (m->recursive && m->owner == task)) {
+        m->owner = task;
+        m->count++;
+        return true;
+    }
+    if (timeout == 0) return false;
+    task->state = State::BLOCKED;
+    task->waitingForMutex = m;
+    task->timed = timeout != FOREVER;
+    task->wakeTime = time + timeout;
+    m->waiters.push_back(task);
+    switchAway(lock, task);
+    // give() hands the mutex straight to the next owner
+    return m->owner == task;
+}
+
+bool SimScheduler::give(Mutex* m) {
+    Lock lock(mutex);
+    Task* task = self();
+    if (m->owner != task) return false;
+    if (--m->count > 0) return true;
+    m->owner = nullptr;
+    if (m->waiters.empty()) return true;
+    // the highest priority waiter gets it, the first to wait if there is a tie
+    auto next = m->waiters.begin();
+    for (auto waiter = m->waiters.begin(); waiter != m->waiters.end(); waiter++)
+        if ((*waiter)->priority > (*next)->priority) next = waiter;
+    Task* owner = *next;
+    m->waiters.erase(next);
+    m->owner = owner;
+    m->count = 1;
+    owner->waitingForMutex = nullptr;
+    makeReady(owner);
+    preempt(lock, task);
+    return true;
+}
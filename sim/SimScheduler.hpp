@@ -0,0 +1,140 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A deterministic stand in for the FreeRTOS scheduler of the brain, in virtual time
+ *
+ * Each task is a thread, but only the task holding the run token runs. Like FreeRTOS, the highest priority task that
+ * is ready runs, tasks of the same priority take turns in the order they became ready, and a task that makes a higher
+ * priority task ready is preempted straight away. Unlike FreeRTOS, a task only gives up the token when it blocks:
+ * delays, notifications, mutexes and joins. Robot code blocks in every loop anyway, or it would starve the lower
+ * priority tasks on the brain too.
+ *
+ * Virtual time only moves when every task is blocked. It moves a millisecond at a time, calling the tick hook each
+ * time, so the world is stepped while no task is running. Code takes no virtual time to run, so the simulation runs
+ * as fast as the host can go, and the same program gives the same run every time.
+ *
+ * The thread that first calls into the scheduler becomes the "main" task, with the default priority. Tasks created
+ * before start() is called, like by global constructors, wait for the main task to block before they run, like tasks
+ * created before the FreeRTOS scheduler starts.
+ */
+class SimScheduler {
+    public:
+        /** the state of a task, like pros::task_state_e_t */
+        enum class State { RUNNING, READY, BLOCKED, SUSPENDED, DELETED };
+
+        struct Mutex;
+
+        /**
+         * @brief A task. Handles stay valid after the task is deleted
+         */
+        struct Task {
+                std::string name;
+                std::uint32_t priority;
+                State state = State::READY;
+                /** order the task became ready in, for tasks of the same priority */
+                std::uint64_t readyOrder = 0;
+                /** when a delay or a timeout ends, if timed */
+                std::uint32_t wakeTime = 0;
+                bool timed = false;
+                /** what the task is blocked on, if anything */
+                bool waitingForNotify = false;
+                Mutex* waitingForMutex = nullptr;
+                Task* waitingForTask = nullptr;
+                std::uint32_t notifyValue = 0;
+                bool notifyPending = false;
+                std::condition_variable wake;
+        };
+
+        /**
+         * @brief A mutex, recursive or not
+         */
+        struct Mutex {
+                bool recursive = false;
+                Task* owner = nullptr;
+                std::uint32_t count = 0;
+                std::deque<Task*> waiters;
+        };
+
+        /**
+         * @brief Get the scheduler
+         */
+        static SimScheduler& get();
+
+        /**
+         * @brief Make the calling thread the main task, and let tasks preempt each other from now on
+         */
+        void start();
+        /**
+         * @brief Set what is called every millisecond of virtual time, while no task is running
+         */
+        void setTickHook(std::function<void()> hook);
+        /**
+         * @brief Get the virtual time, in milliseconds
+         */
+        std::uint32_t getTime();
+
+        Task* create(void (*function)(void*), void* parameters, std::uint32_t priority, const char* name);
+        /**
+         * @brief Delete a task. Deleting the current task never returns
+         */
+        void remove(Task* task);
+        Task* current();
+        Task* find(const char* name);
+        std::uint32_t count();
+        void delay(std::uint32_t milliseconds);
+        void delayUntil(std::uint32_t* previous, std::uint32_t delta);
+        void setPriority(Task* task, std::uint32_t priority);
+        void suspend(Task* task);
+        void resume(Task* task);
+        void join(Task* task);
+
+        /** same as task_notify_ext */
+        std::uint32_t notify(Task* task, std::uint32_t value, int action, std::uint32_t* previous);
+        std::uint32_t notifyTake(bool clear, std::uint32_t timeout);
+        bool notifyClear(Task* task);
+
+        Mutex* createMutex(bool recursive);
+        void deleteMutex(Mutex* mutex);
+        bool take(Mutex* mutex, std::uint32_t timeout);
+        bool give(Mutex* mutex);
+    private:
+        using Lock = std::unique_lock<std::mutex>;
+
+        SimScheduler() = default;
+
+        /**
+         * @brief The task of the calling thread. The first thread to ask becomes the main task
+         */
+        Task* self();
+        void makeReady(Task* task);
+        /**
+         * @brief Give the run token to the next task, moving time if none is ready, and wait to get it back
+         */
+        void switchAway(Lock& lock, Task* task);
+        /**
+         * @brief Let a higher priority task that just became ready run
+         */
+        void preempt(Lock& lock, Task* task);
+        Task* nextReady();
+        void tick();
+        void wakeJoiners(Task* task);
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Task>> tasks;
+        std::vector<std::unique_ptr<Mutex>> mutexes;
+        Task* running = nullptr;
+        std::uint32_t time = 0;
+        std::uint64_t readyOrder = 0;
+        bool started = false;
+        std::function<void()> tickHook;
+};
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "Create.hpp"
+#include "SimTuning.hpp"
+#include "SimWorld.hpp"
+
+// a motion has settled once the robot stays this close to its target, in inches and degrees
+constexpr float SETTLE_DISTANCE = 1;
+constexpr float SETTLE_ANGLE = 1;
+// the drive routine has settled once the robot stays slower than this, in inches per second
+constexpr float SETTLE_SPEED = 0.5;
+
+/**
+ * @brief Parse a whole string as a float
+ */
+static bool parseFloat(const std::string& text, float& value) {
+    char* end;
+    value = std::strtof(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+/**
+ * @brief Parse deadband/minOutput/curve
+ */
+static bool parseCurve(const std::string& text, SimCurve& curve) {
+    const std::size_t first = text.find('/');
+    const std::size_t second = text.find('/', first + 1);
+    if (first == std::string::npos || second == std::string::npos) return false;
+    return parseFloat(text.substr(0, first), curve.deadband) &&
+           parseFloat(text.substr(first + 1, second - first - 1), curve.minOutput) &&
+           parseFloat(text.substr(second + 1), curve.curve);
+}
+
+SimSettings::SimSettings()
+    : lateral(lateral_controller),
+      angular(angular_controller) {}
+
+bool SimSettings::set(const std::string& key, const std::string& value) {
+    static constexpr std::pair<const char*, float lemlib::ControllerSettings::*> fields[] = {
+        {"kP", &lemlib::ControllerSettings::kP},
+        {"kI", &lemlib::ControllerSettings::kI},
+        {"kD", &lemlib::ControllerSettings::kD},
+        {"windupRange", &lemlib::ControllerSettings::windupRange},
+        {"smallError", &lemlib::ControllerSettings::smallError},
+        {"smallErrorTimeout", &lemlib::ControllerSettings::smallErrorTimeout},
+        {"largeError", &lemlib::ControllerSettings::largeError},
+        {"largeErrorTimeout", &lemlib::ControllerSettings::largeErrorTimeout},
+        {"slew", &lemlib::ControllerSettings::slew},
+    };
+    if (key == "lead") return parseFloat(value, lead);
+    if (key == "throttle" || key == "steer") {
+        SimCurve curve;
+        if (!parseCurve(value, curve)) return false;
+        (key == "throttle" ? throttle : steer) = curve;
+        return true;
+    }
+    const std::size_t dot = key.find('.');
+    if (dot == std::string::npos) return false;
+    const std::string controller = key.substr(0, dot);
+    if (controller != "lateral" && controller != "angular") return false;
+    for (const auto& [name, field] : fields) {
+        if (key.compare(dot + 1, std::string::npos, name) != 0) continue;
+        return parseFloat(value, (controller == "lateral" ? lateral : angular).*field);
+    }
+    return false;
+}
+
+void SimSettings::apply() const {
+    chassis.setControllerSettings(lateral, angular);
+    // the chassis keeps pointers to the curves, and a run applies its settings once, so these live until exit
+    lemlib::DriveCurve* throttleCurve = &throttle_curve;
+    lemlib::DriveCurve* steerCurve = &steer_curve;
+    if (throttle) throttleCurve = new lemlib::ExpoDriveCurve(throttle->deadband, throttle->minOutput, throttle->curve);
+    if (steer) steerCurve = new lemlib::ExpoDriveCurve(steer->deadband, steer->minOutput, steer->curve);
+    chassis.setDriveCurves(throttleCurve, steerCurve);
+}
+
+void SimTracker::setTarget(Kind kind, float x, float y, float theta) {
+    float currentX, currentY, currentTheta;
+    simWorld().getPose(currentX, currentY, currentTheta);
+    this->kind = kind;
+    targetX = kind == Kind::ANGULAR || kind == Kind::DRIVE ? currentX : x;
+    targetY = kind == Kind::ANGULAR || kind == Kind::DRIVE ? currentY : y;
+    targetTheta = kind == Kind::DRIVE ? currentTheta : theta;
+    turnDirection = std::remainder(theta - currentTheta, 360) < 0 ? -1 : 1;
+    start = simWorld().getTime();
+    lastOutside = start;
+    outside = true;
+    overshoot = 0;
+}
+
+void SimTracker::update() {
+    if (kind == Kind::NONE) return;
+    float x, y, theta;
+    simWorld().getPose(x, y, theta);
+    const float dx = x - targetX;
+    const float dy = y - targetY;
+    // unit vector along the target heading, clockwise from the y axis
+    const float sin = std::sin(targetTheta * float(M_PI) / 180);
+    const float cos = std::cos(targetTheta * float(M_PI) / 180);
+    headingError = std::remainder(theta - targetTheta, 360);
+    bool inside;
+    switch (kind) {
+        case Kind::LATERAL:
+        case Kind::POSE:
+            error = std::hypot(dx, dy);
+            overshoot = std::max(overshoot, dx * sin + dy * cos);
+            inside = error < SETTLE_DISTANCE && (kind == Kind::LATERAL || std::fabs(headingError) < SETTLE_ANGLE);
+            break;
+        case Kind::ANGULAR:
+            error = std::hypot(dx, dy);
+            overshoot = std::max(overshoot, headingError * turnDirection);
+            inside = std::fabs(headingError) < SETTLE_ANGLE;
+            break;
+        default: {
+            float linear, angular;
+            simWorld().getVelocity(linear, angular);
+            // how far it coasted, and how far it strayed from a straight line
+            overshoot = dx * sin + dy * cos;
+            error = std::fabs(dx * cos - dy * sin);
+            inside = std::fabs(linear) < SETTLE_SPEED;
+            break;
+        }
+    }
+    if (!inside) lastOutside = simWorld().getTime();
+    outside = !inside;
+}
+
+void SimTracker::finish(SimResult& result) const {
+    if (kind == Kind::NONE) return;
+    result.settleTime = outside ? -1 : std::int32_t(lastOutside + 1 - start);
+    result.overshoot = overshoot;
+    result.error = error;
+    result.headingError = headingError;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+
+/**
+ * @brief Parameters of a lemlib::ExpoDriveCurve
+ */
+struct SimCurve {
+        float deadband;
+        float minOutput;
+        float curve;
+};
+
+/**
+ * @brief The tunable parameters of a simulated run. Starts with the ones the robot program uses
+ *
+ * Set with keys like `lateral.kP`, `angular.slew`, `lead`, and `throttle`/`steer` for curves, written as
+ * deadband/minOutput/curve. The controller keys are the field names of lemlib::ControllerSettings.
+ */
+struct SimSettings {
+        SimSettings();
+
+        /**
+         * @brief Set a parameter from text
+         *
+         * @return false if the key doesn't exist or the value can't be parsed
+         */
+        bool set(const std::string& key, const std::string& value);
+        /**
+         * @brief Give the settings to the chassis. Must be called before any motion starts
+         */
+        void apply() const;
+
+        lemlib::ControllerSettings lateral;
+        lemlib::ControllerSettings angular;
+        /** unset to keep the curves the robot program uses */
+        std::optional<SimCurve> throttle;
+        std::optional<SimCurve> steer;
+        /** lead of the `pose` tuning motion */
+        float lead = 0.6;
+};
+
+/**
+ * @brief How a run went
+ */
+struct SimResult {
+        bool finished = false;
+        /** when the routine or motion returned, in milliseconds since it started */
+        std::uint32_t exitTime = 0;
+        /**
+         * milliseconds from the start of the motion until the robot stayed within 1 inch and 1 degree of the target,
+         * -1 if it never did. For the drive routine, from releasing the sticks until the robot stayed stopped
+         */
+        std::int32_t settleTime = -1;
+        /** furthest the robot went past the target, in inches or degrees. For the drive routine, the coast distance */
+        float overshoot = 0;
+        /** distance and heading from the target at the end, NAN for auton routines, which have no single target */
+        float error = NAN;
+        float headingError = NAN;
+        /** distance and heading from the true pose to odometry at the end */
+        float odomError = 0;
+        float odomHeadingError = 0;
+};
+
+/**
+ * @brief Measures the true motion of the robot against a target, every millisecond
+ *
+ * update() is called from the scheduler's tick hook, so it sees every millisecond without waking a task. The target
+ * is set by the routine task.
+ */
+class SimTracker {
+    public:
+        /** what is measured against the target */
+        enum class Kind { NONE, LATERAL, ANGULAR, POSE, DRIVE };
+
+        /**
+         * @brief Start measuring against a target
+         *
+         * @param kind LATERAL and POSE measure distance, and overshoot along the heading of the target. ANGULAR
+         * measures heading. DRIVE measures coasting from the current pose, against the straight line along its
+         * heading, and ignores the target
+         * @param x in inches
+         * @param y in inches
+         * @param theta in degrees
+         */
+        void setTarget(Kind kind, float x, float y, float theta);
+        void update();
+        /**
+         * @brief Fill in the settle time, overshoot and errors of a result
+         */
+        void finish(SimResult& result) const;
+    private:
+        Kind kind = Kind::NONE;
+        float targetX = 0;
+        float targetY = 0;
+        float targetTheta = 0;
+        /** 1 if an angular target is clockwise of where the turn started, -1 if not */
+        float turnDirection = 1;
+        std::uint32_t start = 0;
+        std::uint32_t lastOutside = 0;
+        bool outside = true;
+        float overshoot = 0;
+        float error = 0;
+        float headingError = 0;
+};
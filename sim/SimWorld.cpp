@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include "SimWorld.hpp"
+
+// stall torque of the output shaft in Nm, free speed in rpm, and encoder ticks per revolution, for each gearset
+constexpr double STALL_TORQUE[] = {2.1, 1.05, 0.35};
+constexpr double FREE_SPEED[] = {100, 200, 600};
+constexpr double TICKS[] = {1800, 900, 300};
+
+constexpr double NOMINAL_VOLTAGE = 12;
+constexpr double STALL_CURRENT = 2.5;
+constexpr double RESISTANCE = NOMINAL_VOLTAGE / STALL_CURRENT;
+// heat capacity in J per degree, and how fast the motor cools, in W per degree above the air
+constexpr double THERMAL_MASS = 30;
+constexpr double COOLING = 0.1;
+constexpr double AMBIENT = 25;
+
+// the internal velocity controller of the motor, in volts per fraction of free speed. It controls the velocity the
+// motor reports, which is filtered, so it is slow to notice a load
+constexpr double VELOCITY_KP = 6;
+constexpr double VELOCITY_KI = 20;
+constexpr double VELOCITY_FILTER = 0.02;
+// the internal position controller, in rpm per degree
+constexpr double POSITION_KP = 2;
+
+constexpr double GRAVITY = 9.81;
+constexpr double INCH = 0.0254;
+constexpr double RPM = 2 * std::numbers::pi / 60;
+constexpr double DEGREE = std::numbers::pi / 180;
+
+/**
+ * @brief Sign of a velocity, that fades to 0 near 0 so friction doesn't chatter
+ */
+static double frictionSign(double velocity) { return std::clamp(velocity / 0.01, -1.0, 1.0); }
+
+SimWorld::SimWorld()
+    : random(1) {}
+
+void SimWorld::setDrivetrain(const std::vector<std::int8_t>& left, const std::vector<std::int8_t>& right,
+                             float trackWidth, float wheelDiameter, float rpm) {
+    for (std::int8_t port : left) {
+        SimMotor& m = motor(std::abs(port));
+        m.side = -1;
+        m.mount = port < 0 ? -1 : 1;
+    }
+    for (std::int8_t port : right) {
+        SimMotor& m = motor(std::abs(port));
+        m.side = 1;
+        m.mount = port < 0 ? -1 : 1;
+    }
+    this->trackWidth = trackWidth * INCH;
+    wheelRadius = wheelDiameter * INCH / 2;
+    if (!left.empty()) ratio = freeSpeed(motor(std::abs(left.front()))) / rpm;
+    hasDrivetrain = true;
+}
+
+void SimWorld::setRobot(const SimRobotSettings& settings) { robot = settings; }
+
+void SimWorld::setImu(const SimImuSettings& settings) { imuSettings = settings; }
+
+void SimWorld::setGps(const SimGpsSettings& settings) { gpsSettings = settings; }
+
+void SimWorld::seed(std::uint32_t seed) { random.seed(seed); }
+
+void SimWorld::addTrackingWheel(const SimTrackingWheel& wheel) { trackingWheels.push_back(wheel); }
+
+void SimWorld::setPose(float x, float y, float theta) {
+    this->x = x * INCH;
+    this->y = y * INCH;
+    this->theta = theta * DEGREE;
+    linear = 0;
+    angular = 0;
+}
+
+void SimWorld::setLoad(std::uint8_t port, double torque) { motor(port).load = torque; }
+
+void SimWorld::step() {
+    constexpr double dt = 0.001;
+    for (SimMotor& m : motors)
+        if (m.installed) stepMotor(m, dt);
+    stepDrivetrain(dt);
+    stepImus(dt);
+    time++;
+}
+
+void SimWorld::stepMotor(SimMotor& m, double dt) {
+    const double free = freeSpeed(m);
+    auto velocityControl = [&](double target) {
+        const double error = (target - m.reportedVelocity) / free;
+        m.integral = std::clamp(m.integral + VELOCITY_KI * error * dt, -NOMINAL_VOLTAGE, NOMINAL_VOLTAGE);
+        return NOMINAL_VOLTAGE * target / free + VELOCITY_KP * error + m.integral;
+    };
+    auto positionControl = [&](double target, double maxVelocity) {
+        return velocityControl(std::clamp(POSITION_KP * (target - m.position), -maxVelocity, maxVelocity));
+    };
+
+    const bool stopped = (m.mode == SimMotor::Mode::VOLTAGE && m.targetVoltage == 0) ||
+                         (m.mode == SimMotor::Mode::VELOCITY && m.targetVelocity == 0);
+    bool open = false;
+    double volts = 0;
+    if (stopped) {
+        // a stopped motor does what its brake mode says
+        if (m.brakeMode == 2) volts = positionControl(m.holdPosition, free);
+        else {
+            open = m.brakeMode == 0;
+            m.integral = 0;
+        }
+    } else {
+        m.holdPosition = m.position;
+        switch (m.mode) {
+            case SimMotor::Mode::VOLTAGE:
+                m.integral = 0;
+                volts = m.targetVoltage / 1000;
+                break;
+            case SimMotor::Mode::VELOCITY: volts = velocityControl(m.targetVelocity); break;
+            case SimMotor::Mode::POSITION:
+                volts = positionControl(m.targetPosition, std::abs(m.targetVelocity));
+                break;
+        }
+    }
+    double limit = NOMINAL_VOLTAGE;
+    if (m.voltageLimit > 0) limit = std::min(limit, m.voltageLimit / 1000.0);
+    m.voltage = std::clamp(volts, -limit, limit);
+
+    // coasting leaves the windings open, otherwise the back EMF opposes the voltage
+    if (open) m.current = 0;
+    else {
+        double currentLimit = m.currentLimit / 1000.0;
+        // a hot motor limits its current, then stops
+        if (m.temperature >= 70) currentLimit = 0;
+        else if (m.temperature >= 55) currentLimit /= 1 << int((m.temperature - 50) / 5);
+        m.current = STALL_CURRENT * (m.voltage / NOMINAL_VOLTAGE - m.velocity / free);
+        m.current = std::clamp(m.current, -currentLimit, currentLimit);
+    }
+    m.torque = STALL_TORQUE[m.gearset] * m.current / STALL_CURRENT;
+    m.temperature += (m.current * m.current * RESISTANCE - COOLING * (m.temperature - AMBIENT)) / THERMAL_MASS * dt;
+
+    // the drivetrain moves the motors that drive it
+    if (m.side == 0 || !hasDrivetrain) {
+        const double speed = m.velocity * RPM;
+        double net = m.torque - robot.loadFriction * speed;
+        // the load holds a stalled motor until the motor can overcome it
+        if (speed != 0) net -= m.load * (speed > 0 ? 1 : -1);
+        else if (std::abs(net) <= m.load) net = 0;
+        else net -= m.load * (net > 0 ? 1 : -1);
+        double next = speed + net / robot.loadInertia * dt;
+        if (m.load > 0 && speed * next < 0) next = 0;
+        m.velocity = next / RPM;
+        m.position += m.velocity * 6 * dt;
+    }
+    m.reportedVelocity += (m.velocity - m.reportedVelocity) * dt / VELOCITY_FILTER;
+}
+
+void SimWorld::stepDrivetrain(double dt) {
+    if (!hasDrivetrain) return;
+    const double weight = robot.mass * GRAVITY;
+    // the wheels the robot really has, not the ones the program is told about
+    const double radius = wheelRadius * robot.wheelScale;
+    double left = 0;
+    double right = 0;
+    for (const SimMotor& m : motors) {
+        if (m.side == 0) continue;
+        const double force = m.mount * m.torque * ratio / radius;
+        (m.side < 0 ? left : right) += force;
+    }
+    // past the traction limit, the wheels slip
+    const double traction = robot.traction * weight / 2;
+    left = std::clamp(left, -traction, traction);
+    right = std::clamp(right, -traction, traction);
+    left -= robot.rollingResistance * weight / 2 * frictionSign(linear + angular * trackWidth / 2);
+    right -= robot.rollingResistance * weight / 2 * frictionSign(linear - angular * trackWidth / 2);
+
+    const double length = robot.length * INCH;
+    const double width = robot.width * INCH;
+    const double inertia = robot.mass * (length * length + width * width) / 12;
+    const double torque = (left - right) * trackWidth / 2 -
+                          robot.scrub * weight * trackWidth / 2 * frictionSign(angular * trackWidth / 2);
+    forwardsAccel = (left + right) / robot.mass;
+    linear += forwardsAccel * dt;
+    angular += torque / inertia * dt;
+    lateralAccel = linear * angular;
+    theta += angular * dt;
+    x += linear * std::sin(theta) * dt;
+    y += linear * std::cos(theta) * dt;
+
+    const double leftVelocity = linear + angular * trackWidth / 2;
+    const double rightVelocity = linear - angular * trackWidth / 2;
+    for (SimMotor& m : motors) {
+        if (m.side == 0) continue;
+        m.velocity = m.mount * (m.side < 0 ? leftVelocity : rightVelocity) / radius * ratio / RPM;
+        m.position += m.velocity * 6 * dt;
+    }
+    for (const SimTrackingWheel& wheel : trackingWheels) {
+        const double offset = wheel.offset * INCH;
+        const double velocity = (wheel.horizontal ? angular * offset : linear - angular * offset) /
+                                (wheel.diameter * INCH / 2) / DEGREE;
+        if (wheel.adi) {
+            encoderRates[wheel.port - 1] = velocity;
+            encoderWheels[wheel.port - 1] += velocity * dt;
+        } else {
+            rotationRates[wheel.port - 1] = velocity;
+            rotationWheels[wheel.port - 1] += velocity * dt;
+        }
+    }
+}
+
+void SimWorld::stepImus(double dt) {
+    std::normal_distribution<double> normal;
+    for (std::size_t port = 0; port < imus.size(); port++) {
+        if (!imuUsed[port]) continue;
+        Imu& sensor = imus[port];
+        if (sensor.calibrating && time >= sensor.calibrationEnd) {
+            sensor.calibrating = false;
+            sensor.start = theta;
+            sensor.drift = 0;
+            sensor.bias = imuSettings.bias * normal(random);
+            sensor.scale = 1 + imuSettings.scaleError * normal(random);
+        }
+        sensor.bias += imuSettings.biasWalk * std::sqrt(dt) * normal(random);
+        sensor.drift += sensor.bias * dt;
+        sensor.rotation = (theta - sensor.start) / DEGREE * sensor.scale + sensor.drift +
+                          imuSettings.noise * normal(random);
+        sensor.rate = angular / DEGREE * sensor.scale + sensor.bias + imuSettings.noise * normal(random);
+    }
+}
+
+SimMotor& SimWorld::motor(std::uint8_t port) {
+    SimMotor& m = motors[port - 1];
+    m.installed = true;
+    return m;
+}
+
+double SimWorld::freeSpeed(const SimMotor& motor) { return FREE_SPEED[motor.gearset]; }
+
+double SimWorld::ticksPerRevolution(const SimMotor& motor) { return TICKS[motor.gearset]; }
+
+SimWorld::Imu& SimWorld::imu(std::uint8_t port) {
+    // the IMU calibrated itself when the brain turned on
+    if (!imuUsed[port - 1]) {
+        imuUsed[port - 1] = true;
+        imus[port - 1].calibrating = true;
+        imus[port - 1].calibrationEnd = time;
+        stepImus(0);
+    }
+    return imus[port - 1];
+}
+
+void SimWorld::calibrateImu(std::uint8_t port) {
+    Imu& sensor = imu(port);
+    sensor.calibrating = true;
+    sensor.calibrationEnd = time + imuSettings.calibrationTime;
+}
+
+bool SimWorld::isImuCalibrating(std::uint8_t port) { return imu(port).calibrating; }
+
+double SimWorld::getImuRotation(std::uint8_t port) { return imu(port).rotation; }
+
+double SimWorld::getImuRate(std::uint8_t port) { return imu(port).rate; }
+
+void SimWorld::getImuAccel(std::uint8_t port, double& forwards, double& right) {
+    imu(port);
+    forwards = forwardsAccel / GRAVITY;
+    right = lateralAccel / GRAVITY;
+}
+
+double SimWorld::getTrackingWheel(std::uint8_t port, bool adi, double* velocity) const {
+    if (velocity != nullptr) *velocity = adi ? encoderRates[port - 1] : rotationRates[port - 1];
+    return adi ? encoderWheels[port - 1] : rotationWheels[port - 1];
+}
+
+std::int32_t& SimWorld::adiValue(std::uint8_t port) { return adi[port - 1]; }
+
+void SimWorld::setCompetitionStatus(std::uint8_t status) { competitionStatus = status; }
+
+std::uint8_t SimWorld::getCompetitionStatus() const { return competitionStatus; }
+
+double SimWorld::getBatteryCurrent() const {
+    double current = 0;
+    for (const SimMotor& m : motors) current += std::abs(m.current);
+    return current;
+}
+
+void SimWorld::getGps(std::uint8_t port, double& x, double& y, double& heading, double& error) {
+    Gps& gps = gpses[port - 1];
+    if (!gps.used || time - gps.readTime >= gpsSettings.period) {
+        std::normal_distribution<double> normal;
+        std::uniform_real_distribution<double> uniform;
+        gps.used = true;
+        gps.readTime = time;
+        gps.x = this->x / INCH + gpsSettings.noise * normal(random);
+        gps.y = this->y / INCH + gpsSettings.noise * normal(random);
+        gps.heading = theta / DEGREE + gpsSettings.headingNoise * normal(random);
+        if (uniform(random) < gpsSettings.outlierChance) {
+            const double direction = 2 * std::numbers::pi * uniform(random);
+            gps.x += gpsSettings.outlierDistance * std::sin(direction);
+            gps.y += gpsSettings.outlierDistance * std::cos(direction);
+            gpsOutliers++;
+        }
+    }
+    x = gps.x;
+    y = gps.y;
+    heading = gps.heading;
+    error = gpsSettings.noise;
+}
+
+std::uint32_t SimWorld::getGpsOutliers() const { return gpsOutliers; }
+
+void SimWorld::getPose(float& x, float& y, float& theta) const {
+    x = this->x / INCH;
+    y = this->y / INCH;
+    theta = this->theta / DEGREE;
+}
+
+void SimWorld::getVelocity(float& linear, float& angular) const {
+    linear = this->linear / INCH;
+    angular = this->angular / DEGREE;
+}
+
+std::uint32_t SimWorld::getTime() const { return time; }
+
+SimWorld& simWorld() {
+    static SimWorld world;
+    return world;
+}
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief The physical constants of the simulated robot
+ */
+struct SimRobotSettings {
+        /** mass of the robot, in kg */
+        float mass = 6.8;
+        /** length of the frame, in inches. Only used for the moment of inertia */
+        float length = 16.5;
+        /** width of the frame, in inches. Only used for the moment of inertia */
+        float width = 13;
+        /** rolling resistance of the wheels, as a fraction of the weight on them */
+        float rollingResistance = 0.03;
+        /** resistance of the wheels to being dragged sideways when turning, as a fraction of the weight */
+        float scrub = 0.05;
+        /** most force the wheels can push with before they slip, as a fraction of the weight on them */
+        float traction = 1.0;
+        /** moment of inertia of what each motor that isn't driving the robot spins, in kg m^2 */
+        float loadInertia = 0.0005;
+        /** friction of what each motor that isn't driving the robot spins, in Nm per rad/s */
+        float loadFriction = 0.0005;
+        /** true diameter of the drive wheels over the diameter the program is given. Above 1, wheel odometry measures
+         * less than the robot drives */
+        float wheelScale = 1;
+};
+
+/**
+ * @brief How the simulated IMU differs from the truth
+ */
+struct SimImuSettings {
+        /** standard deviation of the noise on each sample, in degrees */
+        float noise = 0.02;
+        /** standard deviation of the gyro bias left after calibrating, in degrees per second */
+        float bias = 0.005;
+        /** how fast the gyro bias wanders, in degrees per second per root second */
+        float biasWalk = 0.0005;
+        /** standard deviation of the gyro scale error, as a fraction */
+        float scaleError = 0.002;
+        /** how long a calibration takes, in milliseconds */
+        std::uint32_t calibrationTime = 2000;
+};
+
+/**
+ * @brief How the simulated GPS sensors differ from the truth
+ *
+ * The GPS reports the center of the robot, in field coordinates: the pose of the simulated robot, with the center of
+ * the field at 0, 0.
+ */
+struct SimGpsSettings {
+        /** standard deviation of the noise on each position, in inches. The GPS reports it as its error */
+        float noise = 0.5;
+        /** standard deviation of the noise on each heading, in degrees */
+        float headingNoise = 1;
+        /** chance of each reading being an outlier, like when the GPS sees another robot instead of the field strip */
+        float outlierChance = 0.02;
+        /** how far outliers are from the truth, in inches */
+        float outlierDistance = 20;
+        /** time between readings, in milliseconds */
+        std::uint32_t period = 20;
+};
+
+/**
+ * @brief A wheel that turns a rotation sensor or an ADI encoder as the robot moves
+ */
+struct SimTrackingWheel {
+        /** smart port of the rotation sensor, or the top ADI port of the encoder, 1 to 8 */
+        std::uint8_t port;
+        /** whether the wheel turns an ADI encoder instead of a rotation sensor */
+        bool adi;
+        /** diameter of the wheel, in inches */
+        float diameter;
+        /** distance from the tracking center, in inches. Right or forwards is positive */
+        float offset;
+        /** whether the wheel rolls sideways, instead of forwards */
+        bool horizontal;
+};
+
+/**
+ * @brief The state of a simulated V5 motor
+ *
+ * Positions and velocities are of the output shaft, in the motor's own direction: they don't depend on whether the
+ * port it is used through is reversed. Reversing is done by the PROS API, like on the brain.
+ */
+struct SimMotor {
+        /** what the motor was last told to do */
+        enum class Mode { VOLTAGE, VELOCITY, POSITION };
+
+        bool installed = false;
+        /** 0 for 100 rpm, 1 for 200 rpm, 2 for 600 rpm, like pros::motor_gearset_e_t */
+        int gearset = 1;
+        /** like pros::motor_encoder_units_e_t */
+        int units = 0;
+        /** like pros::motor_brake_mode_e_t */
+        int brakeMode = 0;
+        /** in mA */
+        std::int32_t currentLimit = 2500;
+        /** in mV, 0 for no limit */
+        std::int32_t voltageLimit = 0;
+
+        Mode mode = Mode::VOLTAGE;
+        /** in mV, for Mode::VOLTAGE */
+        double targetVoltage = 0;
+        /** in rpm. The velocity for Mode::VELOCITY, the most velocity for Mode::POSITION */
+        double targetVelocity = 0;
+        /** in degrees, for Mode::POSITION */
+        double targetPosition = 0;
+        /** where to hold, in degrees, when stopped with the hold brake mode */
+        double holdPosition = 0;
+        /** integral of the internal velocity controller, in volts */
+        double integral = 0;
+
+        /** in degrees, since the motor was plugged in */
+        double position = 0;
+        /** position the encoder reads 0 at, in degrees */
+        double zero = 0;
+        /** in rpm */
+        double velocity = 0;
+        /** velocity reported by the motor, which filters it, in rpm */
+        double reportedVelocity = 0;
+        /** applied, in volts */
+        double voltage = 0;
+        /** in amps */
+        double current = 0;
+        /** in Nm */
+        double torque = 0;
+        /** in degrees celsius */
+        double temperature = 25;
+        /** in Nm, opposing the motor, for motors that don't drive the robot */
+        double load = 0;
+
+        /** which side of the drivetrain the motor drives: -1 for left, 1 for right, 0 for neither */
+        int side = 0;
+        /** 1 if spinning the motor forwards drives its side forwards, -1 if backwards */
+        int mount = 1;
+};
+
+/**
+ * @brief The simulated robot: its motors, sensors and drivetrain, and how they move
+ *
+ * Motors follow the linear DC motor model. Their torque falls linearly from stall torque to 0 at free speed, scaled by
+ * voltage, and their current is capped by the current limit and by temperature, like on a real motor. The
+ * drivetrain is a rigid body on two sides of wheels, with rolling resistance, scrub when turning, and a traction
+ * limit. Motors that don't drive the robot spin an inertia, with friction and an optional load.
+ *
+ * The pose is in inches and degrees, with the same conventions as lemlib: x to the right, y forwards, and theta
+ * clockwise from the y axis.
+ *
+ * Nothing here blocks or depends on the scheduler. The scheduler calls step() once per millisecond, while no task is
+ * running.
+ */
+class SimWorld {
+    public:
+        SimWorld();
+
+        /**
+         * @brief Set up the drivetrain
+         *
+         * @param left ports of the left motors, negative if the motor is reversed, like pros::MotorGroup
+         * @param right ports of the right motors
+         * @param trackWidth distance between the left and right wheels, in inches
+         * @param wheelDiameter in inches
+         * @param rpm speed of the wheels when the motors are at free speed
+         */
+        void setDrivetrain(const std::vector<std::int8_t>& left, const std::vector<std::int8_t>& right, float trackWidth,
+                           float wheelDiameter, float rpm);
+        /**
+         * @brief Set the physical constants of the robot
+         */
+        void setRobot(const SimRobotSettings& settings);
+        /**
+         * @brief Set how the IMUs differ from the truth
+         */
+        void setImu(const SimImuSettings& settings);
+        /**
+         * @brief Set how the GPS sensors differ from the truth
+         */
+        void setGps(const SimGpsSettings& settings);
+        /**
+         * @brief Seed the noise of the sensors. The same seed gives the same run
+         */
+        void seed(std::uint32_t seed);
+        /**
+         * @brief Add a tracking wheel
+         */
+        void addTrackingWheel(const SimTrackingWheel& wheel);
+        /**
+         * @brief Set the true pose of the robot, and stop it
+         *
+         * @param x in inches
+         * @param y in inches
+         * @param theta in degrees
+         */
+        void setPose(float x, float y, float theta);
+        /**
+         * @brief Set the torque opposing a motor that doesn't drive the robot, like game objects in an intake
+         *
+         * @param port 1 to 21
+         * @param torque in Nm
+         */
+        void setLoad(std::uint8_t port, double torque);
+
+        /**
+         * @brief Move everything forwards by a millisecond
+         */
+        void step();
+
+        /**
+         * @brief Get a motor, and plug it in. Ports are 1 to 21
+         */
+        SimMotor& motor(std::uint8_t port);
+        /**
+         * @brief Free speed of a motor, in rpm
+         */
+        static double freeSpeed(const SimMotor& motor);
+        /**
+         * @brief Encoder ticks per revolution of the output shaft of a motor
+         */
+        static double ticksPerRevolution(const SimMotor& motor);
+
+        /**
+         * @brief Start calibrating an IMU. It reads 0 when it is done
+         */
+        void calibrateImu(std::uint8_t port);
+        /**
+         * @brief Whether an IMU is calibrating
+         */
+        bool isImuCalibrating(std::uint8_t port);
+        /**
+         * @brief Rotation measured by an IMU since it was calibrated, in degrees clockwise
+         */
+        double getImuRotation(std::uint8_t port);
+        /**
+         * @brief Rate of turn measured by an IMU, in degrees per second clockwise
+         */
+        double getImuRate(std::uint8_t port);
+        /**
+         * @brief Acceleration measured by an IMU, in g, forwards and to the right
+         */
+        void getImuAccel(std::uint8_t port, double& forwards, double& right);
+
+        /**
+         * @brief Latest reading of a GPS. A new reading is taken every period
+         *
+         * @param port 1 to 21
+         * @param x set to the x position, in inches
+         * @param y set to the y position, in inches
+         * @param heading set to the heading, in degrees clockwise
+         * @param error set to the error the GPS reports, in inches
+         */
+        void getGps(std::uint8_t port, double& x, double& y, double& heading, double& error);
+        /**
+         * @brief Number of outliers every GPS has read
+         */
+        std::uint32_t getGpsOutliers() const;
+
+        /**
+         * @brief Position of the tracking wheel on a port, in degrees
+         *
+         * @param port smart port of a rotation sensor, or top ADI port of an encoder
+         * @param adi whether the port is an ADI port
+         * @param velocity set to the velocity of the wheel, in degrees per second
+         * @return the position, or 0 if no tracking wheel is on the port
+         */
+        double getTrackingWheel(std::uint8_t port, bool adi, double* velocity = nullptr) const;
+
+        /**
+         * @brief Get the value written to an ADI port, 1 to 8. Nothing is simulated on ADI ports but encoders
+         */
+        std::int32_t& adiValue(std::uint8_t port);
+
+        /**
+         * @brief Set the competition status bits, like pros::competition::get_status returns. 0 by default, for a
+         * robot that isn't connected to field control
+         */
+        void setCompetitionStatus(std::uint8_t status);
+        std::uint8_t getCompetitionStatus() const;
+        /**
+         * @brief Current drawn from the battery by every motor, in amps
+         */
+        double getBatteryCurrent() const;
+
+        /**
+         * @brief Get the true pose of the robot
+         *
+         * @param x set to the x position, in inches
+         * @param y set to the y position, in inches
+         * @param theta set to the heading, in degrees
+         */
+        void getPose(float& x, float& y, float& theta) const;
+        /**
+         * @brief Get the true velocity of the robot
+         *
+         * @param linear set to the forwards velocity, in inches per second
+         * @param angular set to the clockwise angular velocity, in degrees per second
+         */
+        void getVelocity(float& linear, float& angular) const;
+        /**
+         * @brief Get the number of milliseconds simulated
+         */
+        std::uint32_t getTime() const;
+    private:
+        struct Imu {
+                bool calibrating = false;
+                std::uint32_t calibrationEnd = 0;
+                /** heading of the robot when the IMU was calibrated, in radians */
+                double start = 0;
+                double bias = 0;
+                double scale = 1;
+                /** integrated bias, in degrees */
+                double drift = 0;
+                /** last sample, in degrees and degrees per second */
+                double rotation = 0;
+                double rate = 0;
+        };
+
+        struct Gps {
+                bool used = false;
+                /** when the latest reading was taken, in milliseconds */
+                std::uint32_t readTime = 0;
+                /** latest reading, in inches and degrees */
+                double x = 0;
+                double y = 0;
+                double heading = 0;
+        };
+
+        void stepMotor(SimMotor& motor, double dt);
+        void stepDrivetrain(double dt);
+        void stepImus(double dt);
+        Imu& imu(std::uint8_t port);
+
+        SimRobotSettings robot;
+        SimImuSettings imuSettings;
+        SimGpsSettings gpsSettings;
+        std::mt19937 random;
+
+        std::array<SimMotor, 21> motors = {};
+        std::array<Imu, 21> imus = {};
+        std::array<bool, 21> imuUsed = {};
+        std::array<Gps, 21> gpses = {};
+        std::uint32_t gpsOutliers = 0;
+        std::array<std::int32_t, 8> adi = {};
+        std::vector<SimTrackingWheel> trackingWheels;
+        std::array<double, 21> rotationWheels = {};
+        std::array<double, 8> encoderWheels = {};
+        std::array<double, 21> rotationRates = {};
+        std::array<double, 8> encoderRates = {};
+
+        bool hasDrivetrain = false;
+        /** in meters */
+        double trackWidth = 0.254;
+        double wheelRadius = 0.041;
+        /** motor speed over wheel speed */
+        double ratio = 1;
+
+        /** pose in meters and radians, theta clockwise from the y axis */
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+        /** velocity in m/s and rad/s clockwise */
+        double linear = 0;
+        double angular = 0;
+        /** acceleration in m/s^2 */
+        double forwardsAccel = 0;
+        double lateralAccel = 0;
+
+        std::uint8_t competitionStatus = 0;
+        std::uint32_t time = 0;
+};
+
+/**
+ * @brief The world the PROS API of the simulator reads and writes
+ */
+SimWorld& simWorld();
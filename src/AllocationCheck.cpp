@@ -0,0 +1,79 @@
+#ifdef ALLOCATION_CHECKS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "pros/rtos.h"
+#include "RobotLog.hpp"
+#include "AllocationCheck.hpp"
+
+namespace {
+/** the maximum number of tasks that can be checked */
+constexpr int MAX_TASKS = 8;
+
+/**
+ * @brief A task whose allocations are counted
+ */
+struct WatchedTask {
+        std::atomic<pros::task_t> task {nullptr};
+        std::atomic<std::uint32_t> allocations {0};
+};
+
+WatchedTask watchedTasks[MAX_TASKS];
+std::atomic<int> watchedTaskCount {0};
+
+/**
+ * @brief Find the current task in the watched tasks, watching it if it isn't yet
+ */
+WatchedTask* currentWatchedTask(bool watch) {
+    const pros::task_t current = pros::c::task_get_current();
+    const int count = watchedTaskCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (watchedTasks[i].task.load(std::memory_order_relaxed) == current) return &watchedTasks[i];
+    }
+    if (!watch) return nullptr;
+    const int index = watchedTaskCount.fetch_add(1);
+    if (index >= MAX_TASKS) {
+        watchedTaskCount = MAX_TASKS;
+        return nullptr;
+    }
+    watchedTasks[index].task = current;
+    return &watchedTasks[index];
+}
+
+void* countedAlloc(std::size_t size) {
+    if (watchedTaskCount.load(std::memory_order_relaxed) != 0) {
+        WatchedTask* watched = currentWatchedTask(false);
+        if (watched != nullptr) watched->allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void AllocationCheck::beginTick() {
+    WatchedTask* watched = currentWatchedTask(true);
+    if (watched != nullptr) startCount = watched->allocations.load(std::memory_order_relaxed);
+}
+
+void AllocationCheck::endTick() {
+    WatchedTask* watched = currentWatchedTask(false);
+    if (watched == nullptr) return;
+    const std::uint32_t allocations = watched->allocations.load(std::memory_order_relaxed) - startCount;
+    if (allocations == 0) return;
+    failedTicks++;
+    robotLog().error("{} allocated {} times in one tick", name, allocations);
+}
+#endif
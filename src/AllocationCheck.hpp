@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Checks that a control loop does not allocate on the heap
+ *
+ * The control loops are meant to run without touching the heap once the chassis is calibrated. Wrap each tick in
+ * beginTick() and endTick(), and any tick where the calling task allocated is logged as an error and counted.
+ *
+ * Allocations are only counted when the project is built with -DALLOCATION_CHECKS (add it to EXTRA_CXXFLAGS in the
+ * Makefile), since it replaces the global operator new. Otherwise every method compiles to nothing.
+ *
+ * @b Example
+ * @code {.cpp}
+ * AllocationCheck allocationCheck("my loop");
+ * while (true) {
+ *     allocationCheck.beginTick();
+ *     // do work
+ *     allocationCheck.endTick();
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class AllocationCheck {
+    public:
+        /**
+         * @brief Construct a new allocation check
+         *
+         * @param name name of the loop being checked, used when logging
+         */
+        AllocationCheck(const char* name)
+            : name(name) {}
+#ifdef ALLOCATION_CHECKS
+        /**
+         * @brief Start checking a tick. The calling task is the one that is checked
+         */
+        void beginTick();
+        /**
+         * @brief Finish checking a tick. Logs an error if the calling task allocated since beginTick()
+         */
+        void endTick();
+#else
+        void beginTick() {}
+
+        void endTick() {}
+#endif
+        /**
+         * @brief Get the number of ticks that allocated
+         */
+        std::uint32_t getFailedTicks() const { return failedTicks; }
+    private:
+        const char* name;
+        std::uint32_t startCount = 0;
+        std::uint32_t failedTicks = 0;
+};
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include "RobotLog.hpp"
+#include "Autotune.hpp"
+
+/** period of the relay loop, in milliseconds. The same as the lemlib motions, so the gains fit them */
+constexpr std::uint32_t TICK = 10;
+/** oscillations thrown away while the relay settles into a steady cycle */
+constexpr int TRANSIENT_CYCLES = 2;
+
+/**
+ * @brief A tuning rule: the proportional gain and the integral and derivative times, as fractions of Ku and Tu
+ */
+struct TuningRule {
+        float kP;
+        /** 0 for no integral */
+        float integralTime;
+        float derivativeTime;
+};
+
+static TuningRule tuningRule(AutotuneRule rule) {
+    switch (rule) {
+        case AutotuneRule::ZIEGLER_NICHOLS: return {0.6, 0.5, 0.125};
+        case AutotuneRule::PD: return {0.8, 0, 0.125};
+        case AutotuneRule::SOME_OVERSHOOT: return {0.33, 0.5, 0.33};
+        case AutotuneRule::NO_OVERSHOOT: return {0.2, 0.5, 0.33};
+    }
+    return {0.8, 0, 0.125};
+}
+
+/**
+ * @brief Round a time up to a whole number of ticks, of at least 2 ticks
+ */
+static float roundToTicks(float time) { return std::max(std::ceil(time / TICK), 2.0f) * TICK; }
+
+Autotuner::Autotuner(lemlib::Chassis* chassis, lemlib::Drivetrain drivetrain)
+    : chassis(chassis),
+      drivetrain(drivetrain) {}
+
+AutotuneResult Autotuner::tuneAngular(AutotuneSettings settings) { return tune(true, settings); }
+
+AutotuneResult Autotuner::tuneLateral(AutotuneSettings settings) { return tune(false, settings); }
+
+AutotuneResult Autotuner::tune(bool angular, AutotuneSettings settings) {
+    const char* name = angular ? "angular" : "lateral";
+    AutotuneResult result;
+    if (chassis->isInMotion()) {
+        robotLog().error("Can't autotune the {} controller while a motion is running", name);
+        return result;
+    }
+    const lemlib::Pose start = chassis->getPose();
+    const float startHeading = lemlib::degToRad(start.theta);
+    // error from where the robot started, positive when it has to turn clockwise or drive forwards to get back
+    auto getError = [&]() {
+        const lemlib::Pose pose = chassis->getPose();
+        if (angular) return start.theta - pose.theta;
+        return -((pose.x - start.x) * std::sin(startHeading) + (pose.y - start.y) * std::cos(startHeading));
+    };
+
+    float output = settings.relayPower;
+    int rises = 0;
+    std::uint32_t lastRise = 0;
+    // extremes of the error over the current cycle
+    float high = 0;
+    float low = 0;
+    float periodSum = 0;
+    float amplitudeSum = 0;
+    int measured = 0;
+    const std::uint32_t begin = pros::millis();
+    std::uint32_t now = begin;
+    while (measured < settings.cycles) {
+        const float error = getError();
+        if (std::fabs(error) > settings.maxError) {
+            robotLog().warn("Autotune of the {} controller stopped, the error grew past {}", name, settings.maxError);
+            break;
+        }
+        if (now - begin > std::uint32_t(settings.timeout)) {
+            robotLog().warn("Autotune of the {} controller timed out after {} cycles", name, measured);
+            break;
+        }
+        high = std::max(high, error);
+        low = std::min(low, error);
+        // the relay follows the sign of the error, once it is past the hysteresis
+        if (error > settings.hysteresis && output < 0) {
+            output = settings.relayPower;
+            // switching back to positive ends a cycle
+            if (rises > TRANSIENT_CYCLES) {
+                periodSum += now - lastRise;
+                amplitudeSum += (high - low) / 2;
+                measured++;
+            }
+            rises++;
+            lastRise = now;
+            high = error;
+            low = error;
+        } else if (error < -settings.hysteresis && output > 0) {
+            output = -settings.relayPower;
+        }
+        drivetrain.leftMotors->move(output);
+        drivetrain.rightMotors->move(angular ? -output : output);
+        pros::Task::delay_until(&now, TICK);
+    }
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    if (measured < settings.cycles) return result;
+
+    result.ultimatePeriod = periodSum / measured;
+    result.amplitude = amplitudeSum / measured;
+    if (result.amplitude <= settings.hysteresis) {
+        robotLog().warn("Autotune of the {} controller oscillated less than the hysteresis", name);
+        return result;
+    }
+    // describing function of a relay with hysteresis
+    result.ultimateGain = 4 * settings.relayPower /
+                          (M_PI * std::sqrt(result.amplitude * result.amplitude -
+                                            settings.hysteresis * settings.hysteresis));
+    result.success = true;
+
+    // lemlib::PID sums and differences the error once per tick, instead of integrating over seconds
+    const TuningRule rule = tuningRule(settings.rule);
+    const float kP = rule.kP * result.ultimateGain;
+    const float kI = rule.integralTime > 0 ? kP * TICK / (rule.integralTime * result.ultimatePeriod) : 0;
+    const float kD = kP * rule.derivativeTime * result.ultimatePeriod / TICK;
+    const float largeError = 3 * settings.tolerance;
+    result.settings = lemlib::ControllerSettings(kP, kI, kD, kI > 0 ? largeError : 0, settings.tolerance,
+                                                 roundToTicks(result.ultimatePeriod / 4), largeError,
+                                                 roundToTicks(result.ultimatePeriod), settings.slew);
+    robotLog().info("Autotune of the {} controller: ultimate gain {}, ultimate period {}ms. Suggested "
+                    "settings: ({}, {}, {}, {}, {}, {}, {}, {}, {})",
+                    name, result.ultimateGain, result.ultimatePeriod, kP, kI, kD, result.settings.windupRange,
+                    result.settings.smallError, result.settings.smallErrorTimeout, result.settings.largeError,
+                    result.settings.largeErrorTimeout, result.settings.slew);
+    return result;
+}
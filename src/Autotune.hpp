@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+
+/**
+ * @brief How to turn the ultimate gain and period into PID gains
+ *
+ * The classic tuning rules, from the most aggressive to the most damped
+ */
+enum class AutotuneRule {
+    /** Ziegler-Nichols PID. Fast, with a lot of overshoot */
+    ZIEGLER_NICHOLS,
+    /** Ziegler-Nichols PD, with no integral, like most lemlib controllers */
+    PD,
+    /** PID with some overshoot */
+    SOME_OVERSHOOT,
+    /** PID with no overshoot */
+    NO_OVERSHOOT
+};
+
+/**
+ * @brief Settings for an autotune
+ */
+struct AutotuneSettings {
+        /** power the relay switches between, out of 127. Large enough to overcome friction. 40 by default */
+        float relayPower = 40;
+        /** error the relay ignores, so sensor noise doesn't switch it, in inches or degrees. 0.25 by default */
+        float hysteresis = 0.25;
+        /** oscillations to measure, after the first few are thrown away. 6 by default */
+        int cycles = 6;
+        /** the autotune gives up if the error grows past this, in inches or degrees. 12 by default */
+        float maxError = 12;
+        /** longest the autotune can run, in milliseconds. 15000 by default */
+        int timeout = 15000;
+        /** the rule used to suggest gains. PD by default */
+        AutotuneRule rule = AutotuneRule::PD;
+        /** error the suggested controller should settle within, in inches or degrees. 1 by default */
+        float tolerance = 1;
+        /** copied into the suggested settings, since the oscillation says nothing about it. 0 by default */
+        float slew = 0;
+};
+
+/**
+ * @brief What an autotune measured, and the controller it suggests
+ */
+struct AutotuneResult {
+        /** whether the robot oscillated steadily for every cycle */
+        bool success = false;
+        /** gain that would make the loop oscillate forever, in power per inch or degree */
+        float ultimateGain = 0;
+        /** period of that oscillation, in milliseconds */
+        float ultimatePeriod = 0;
+        /** half the peak to peak oscillation, in inches or degrees */
+        float amplitude = 0;
+        /** suggested gains and exit conditions, in the units of lemlib::ControllerSettings */
+        lemlib::ControllerSettings settings = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+};
+
+/**
+ * @brief Finds PID gains for the chassis with relay feedback (Astrom-Hagglund)
+ *
+ * The drivetrain is driven with full relay power one way until the error changes sign, then the other way, so it
+ * oscillates about where it started. The amplitude and period of the oscillation give the ultimate gain and period of
+ * the loop, which a tuning rule turns into gains. Exit conditions are derived from the period: the small error timeout
+ * is a quarter of it, long enough that an oscillation still going would leave the range.
+ *
+ * Turning oscillates about the starting heading, so the robot needs no room. Driving oscillates forwards and backwards
+ * about the starting position, so it needs a few inches each way. Odometry must be running, and no motion may run
+ * during an autotune.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void opcontrol() {
+ *     chassis.getCalibration().wait();
+ *     Autotuner autotuner(&chassis, drivetrain);
+ *     // logs the suggested settings, ready to paste into Create.cpp
+ *     AutotuneResult turn = autotuner.tuneAngular();
+ *     AutotuneResult drive = autotuner.tuneLateral({.slew = 20});
+ * }
+ * @endcode
+ */
+class Autotuner {
+    public:
+        /**
+         * @brief Autotuner constructor
+         *
+         * @param chassis chassis that provides the pose
+         * @param drivetrain drivetrain to oscillate
+         */
+        Autotuner(lemlib::Chassis* chassis, lemlib::Drivetrain drivetrain);
+        /**
+         * @brief Find gains for the angular controller, by oscillating the heading. Blocks until done
+         */
+        AutotuneResult tuneAngular(AutotuneSettings settings = {});
+        /**
+         * @brief Find gains for the lateral controller, by oscillating forwards and backwards. Blocks until done
+         */
+        AutotuneResult tuneLateral(AutotuneSettings settings = {});
+    private:
+        /**
+         * @brief Run the relay and measure the oscillation
+         *
+         * @param angular whether to oscillate the heading, instead of the distance
+         */
+        AutotuneResult tune(bool angular, AutotuneSettings settings);
+
+        lemlib::Chassis* chassis;
+        lemlib::Drivetrain drivetrain;
+};
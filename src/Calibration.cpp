@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "Calibration.hpp"
+
+bool CalibrationHandle::isDone() const { return done; }
+
+bool CalibrationHandle::succeeded() const {
+    if (!done) return false;
+    for (const std::atomic<CalibrationState>& state : states)
+        if (state == CalibrationState::FAILED || state == CalibrationState::TIMED_OUT) return false;
+    return true;
+}
+
+bool CalibrationHandle::wait(std::uint32_t timeout) const {
+    const std::uint32_t start = pros::millis();
+    while (!done) {
+        if (timeout != TIMEOUT_MAX && pros::millis() - start >= timeout) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+
+float CalibrationHandle::getProgress() const {
+    if (done) return 1;
+    // sensors that aren't attached don't count
+    float total = 0;
+    int count = 0;
+    for (std::size_t i = 0; i < SENSOR_COUNT; i++) {
+        if (states[i] == CalibrationState::NONE) continue;
+        total += progress[i];
+        count++;
+    }
+    // odometry isn't running yet, so never report 100% before done
+    return count == 0 ? 0 : std::min(total / count, 0.99f);
+}
+
+CalibrationState CalibrationHandle::getState(CalibrationSensor sensor) const {
+    return states[static_cast<std::size_t>(sensor)];
+}
+
+int CalibrationHandle::getFailedAttempts() const { return failedAttempts; }
+
+void CalibrationHandle::setState(CalibrationSensor sensor, CalibrationState state, float progress) {
+    this->progress[static_cast<std::size_t>(sensor)] = progress;
+    states[static_cast<std::size_t>(sensor)] = state;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "pros/rtos.hpp"
+
+/**
+ * @brief The sensors RobotChassis calibrates
+ */
+enum class CalibrationSensor { IMU, VERTICAL1, VERTICAL2, HORIZONTAL1, HORIZONTAL2 };
+
+/**
+ * @brief How far along a sensor's calibration is
+ */
+enum class CalibrationState {
+    /** the sensor isn't attached, or isn't being calibrated */
+    NONE,
+    /** waiting to be calibrated */
+    PENDING,
+    CALIBRATING,
+    DONE,
+    /** the sensor reported an error on every attempt */
+    FAILED,
+    /** the sensor was still calibrating after the timeout, on every attempt */
+    TIMED_OUT
+};
+
+/**
+ * @brief Settings for RobotChassis::calibrateAsync
+ */
+struct CalibrationSettings {
+        /** whether the IMU should be calibrated. true by default */
+        bool calibrateIMU = true;
+        /** how many times to try calibrating the IMU before giving up. 5 by default */
+        int imuAttempts = 5;
+        /** longest an IMU calibration attempt can take, in milliseconds. 3000 by default */
+        std::uint32_t imuTimeout = 3000;
+};
+
+/**
+ * @brief Tracks a calibration running in the background
+ *
+ * Returned by RobotChassis::calibrateAsync. Everything can be read from any task while the calibration runs.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     chassis.calibrateAsync();
+ * }
+ *
+ * void autonomous() {
+ *     // don't move until odometry is running
+ *     chassis.getCalibration().wait();
+ * }
+ * @endcode
+ */
+class CalibrationHandle {
+    public:
+        /** number of sensors in CalibrationSensor */
+        static constexpr std::size_t SENSOR_COUNT = 5;
+
+        /**
+         * @brief Whether calibration has finished and odometry is running, whether or not every sensor succeeded
+         */
+        bool isDone() const;
+        /**
+         * @brief Whether calibration has finished, and no sensor failed or timed out
+         */
+        bool succeeded() const;
+        /**
+         * @brief Block until calibration finishes
+         *
+         * @param timeout longest time to wait, in milliseconds. Forever by default
+         * @return true if calibration finished, false if the timeout ran out first
+         */
+        bool wait(std::uint32_t timeout = TIMEOUT_MAX) const;
+        /**
+         * @brief Get how far along calibration is, from 0 to 1
+         *
+         * IMU progress is estimated from how long IMUs usually take to calibrate
+         */
+        float getProgress() const;
+        /**
+         * @brief Get the state of a sensor's calibration
+         */
+        CalibrationState getState(CalibrationSensor sensor) const;
+        /**
+         * @brief Get the number of failed IMU calibration attempts
+         */
+        int getFailedAttempts() const;
+    private:
+        friend class RobotChassis;
+
+        void setState(CalibrationSensor sensor, CalibrationState state, float progress);
+
+        std::array<std::atomic<CalibrationState>, SENSOR_COUNT> states = {};
+        std::array<std::atomic<float>, SENSOR_COUNT> progress = {};
+        std::atomic<int> failedAttempts = 0;
+        std::atomic<bool> started = false;
+        std::atomic<bool> done = false;
+};
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include "pros/misc.hpp"
+#include "RobotLog.hpp"
+#include "Characterization.hpp"
+
+/** period of the tests, in milliseconds. The same as the lemlib motions */
+constexpr std::uint32_t TICK = 10;
+/** how long the drivetrain rests between tests, so it is still when the next one starts */
+constexpr std::uint32_t REST_TIME = 1000;
+/** tests each way: quasistatic forwards, quasistatic backwards, dynamic forwards, dynamic backwards */
+constexpr std::uint8_t TESTS = 4;
+/** samples slower than this are left out of the fits, in inches per second. Static friction holds the robot there */
+constexpr float MIN_VELOCITY = 0.5;
+
+/**
+ * @brief Least squares fit of power = kS * sign(velocity) + kV * velocity + kA * acceleration
+ *
+ * Accelerations are central differences of the velocities of each test, so the first and last sample of a test are
+ * left out
+ *
+ * @param fit set to the gains, in power per inch per second of wheel speed
+ * @param rSquared set to how much of the power the fit explains
+ * @return false if the samples can't tell the gains apart
+ */
+static bool fitFeedforward(const std::vector<DriveCharacterizer::Sample>& samples, std::uint8_t firstTest,
+                           Feedforward& fit, float& rSquared) {
+    // calls visit(power, velocity, acceleration) for every sample the fit uses
+    auto forEachPoint = [&](auto visit) {
+        for (std::size_t i = 1; i + 1 < samples.size(); i++) {
+            const DriveCharacterizer::Sample& prev = samples[i - 1];
+            const DriveCharacterizer::Sample& sample = samples[i];
+            const DriveCharacterizer::Sample& next = samples[i + 1];
+            if (sample.test < firstTest || sample.test >= firstTest + TESTS) continue;
+            if (prev.test != sample.test || next.test != sample.test || next.time == prev.time) continue;
+            if (std::fabs(sample.velocity) < MIN_VELOCITY) continue;
+            visit(sample.power, sample.velocity, (next.velocity - prev.velocity) / ((next.time - prev.time) / 1000.0));
+        }
+    };
+
+    // normal equations, X^T X gains = X^T power
+    std::array<std::array<double, 4>, 3> system {};
+    double powerSum = 0;
+    double powerSquaredSum = 0;
+    int count = 0;
+    forEachPoint([&](double power, double velocity, double acceleration) {
+        const double row[3] = {double(lemlib::sgn(velocity)), velocity, acceleration};
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) system[r][c] += row[r] * row[c];
+            system[r][3] += row[r] * power;
+        }
+        powerSum += power;
+        powerSquaredSum += power * power;
+        count++;
+    });
+    if (count < 3) return false;
+
+    // gaussian elimination with partial pivoting
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < 3; r++)
+            if (std::fabs(system[r][col]) > std::fabs(system[pivot][col])) pivot = r;
+        if (std::fabs(system[pivot][col]) < 1e-9) return false;
+        std::swap(system[col], system[pivot]);
+        for (int r = 0; r < 3; r++) {
+            if (r == col) continue;
+            const double factor = system[r][col] / system[col][col];
+            for (int c = col; c < 4; c++) system[r][c] -= factor * system[col][c];
+        }
+    }
+    const double kS = system[0][3] / system[0][0];
+    const double kV = system[1][3] / system[1][1];
+    const double kA = system[2][3] / system[2][2];
+    fit = {.kS = float(kS), .kV = float(kV), .kA = float(kA)};
+
+    double residualSum = 0;
+    forEachPoint([&](double power, double velocity, double acceleration) {
+        const double residual = power - (kS * lemlib::sgn(velocity) + kV * velocity + kA * acceleration);
+        residualSum += residual * residual;
+    });
+    const double totalSum = powerSquaredSum - powerSum * powerSum / count;
+    rSquared = totalSum > 0 ? float(1 - residualSum / totalSum) : 0;
+    return true;
+}
+
+DriveCharacterizer::DriveCharacterizer(lemlib::Chassis* chassis, lemlib::Drivetrain drivetrain)
+    : chassis(chassis),
+      drivetrain(drivetrain) {}
+
+const std::vector<DriveCharacterizer::Sample>& DriveCharacterizer::getSamples() const { return samples; }
+
+float DriveCharacterizer::getVelocity(pros::MotorGroup* motors) const {
+    float sum = 0;
+    int count = 0;
+    for (int i = 0; i < motors->size(); i++) {
+        const double rpm = motors->get_actual_velocity(i);
+        if (std::isinf(rpm)) continue; // motor disconnected
+        // output rpm of the cartridge
+        float cartridgeRpm = 200;
+        switch (motors->get_gearing(i)) {
+            case pros::MotorGears::ratio_36_to_1: cartridgeRpm = 100; break;
+            case pros::MotorGears::ratio_6_to_1: cartridgeRpm = 600; break;
+            default: break;
+        }
+        sum += rpm * (drivetrain.rpm / cartridgeRpm) * drivetrain.wheelDiameter * M_PI / 60;
+        count++;
+    }
+    return count == 0 ? 0 : sum / count;
+}
+
+bool DriveCharacterizer::runTest(std::uint8_t test, bool turning, bool dynamic, float direction,
+                                 const CharacterizationSettings& settings) {
+    const lemlib::Pose start = chassis->getPose();
+    bool moved = false;
+    const std::uint32_t begin = pros::millis();
+    std::uint32_t now = begin;
+    while (now - begin < std::uint32_t(settings.timeout)) {
+        const std::uint32_t time = now - begin;
+        const float power =
+            direction * std::min<float>(dynamic ? settings.stepPower : settings.rampRate * time / 1000, 127);
+        drivetrain.leftMotors->move(power);
+        drivetrain.rightMotors->move(turning ? -power : power);
+
+        const lemlib::Pose pose = chassis->getPose();
+        const float left = getVelocity(drivetrain.leftMotors);
+        const float right = getVelocity(drivetrain.rightMotors);
+        const float velocity = turning ? (left - right) / 2 : (left + right) / 2;
+        samples.push_back({test, time, power, velocity, pose.theta});
+        moved |= std::fabs(velocity) >= MIN_VELOCITY;
+
+        // stop before running out of room, or out of power
+        if (turning ? std::fabs(pose.theta - start.theta) >= settings.maxRotation
+                    : pose.distance(start) >= settings.maxDistance)
+            break;
+        if (std::fabs(power) >= 127) break;
+        pros::Task::delay_until(&now, TICK);
+    }
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    pros::delay(REST_TIME);
+    return moved;
+}
+
+CharacterizationResult DriveCharacterizer::characterize(CharacterizationSettings settings) {
+    CharacterizationResult result;
+    if (chassis->isInMotion()) {
+        robotLog().error("Can't characterize the drivetrain while a motion is running");
+        return result;
+    }
+    const std::uint8_t tests = settings.angular ? 2 * TESTS : TESTS;
+    samples.clear();
+    // allocate every sample up front, instead of while the motors are running
+    samples.reserve(tests * (settings.timeout / TICK + 1));
+
+    bool moved = true;
+    for (std::uint8_t test = 0; test < tests; test++) {
+        const bool turning = test >= TESTS;
+        const bool dynamic = test % TESTS >= 2;
+        if (!runTest(test, turning, dynamic, test % 2 == 0 ? 1 : -1, settings)) {
+            robotLog().warn("The drivetrain didn't move in characterization test {}", test);
+            moved = false;
+        }
+    }
+    if (settings.logPath != nullptr) writeSamples(settings.logPath);
+    if (!moved) return result;
+
+    if (!fitFeedforward(samples, 0, result.lateral, result.lateralFit)) {
+        robotLog().warn("Can't fit the driving characterization, the tests didn't vary enough");
+        return result;
+    }
+    robotLog().info("Lateral feedforward: kS {}, kV {}, kA {}, fit {}", result.lateral.kS, result.lateral.kV,
+                    result.lateral.kA, result.lateralFit);
+    if (!settings.angular) {
+        result.success = true;
+        return result;
+    }
+
+    // the wheels travel further than the track width says when they scrub, so the turn measures the track width the
+    // drivetrain actually turns with
+    double wheelTravel = 0;
+    double rotation = 0;
+    for (std::size_t i = 1; i < samples.size(); i++) {
+        if (samples[i].test < TESTS || samples[i].test != samples[i - 1].test) continue;
+        wheelTravel += std::fabs(samples[i].velocity) * (samples[i].time - samples[i - 1].time) / 1000.0;
+        rotation += std::fabs(lemlib::degToRad(samples[i].heading - samples[i - 1].heading));
+    }
+    Feedforward wheelFeedforward;
+    if (rotation == 0 || !fitFeedforward(samples, TESTS, wheelFeedforward, result.angularFit)) {
+        robotLog().warn("Can't fit the turning characterization, the tests didn't vary enough");
+        return result;
+    }
+    result.trackWidth = 2 * wheelTravel / rotation;
+    // a degree per second of turning is this many inches per second at each wheel
+    const float wheelSpeed = lemlib::degToRad(1) * result.trackWidth / 2;
+    result.angular = {.kS = wheelFeedforward.kS,
+                      .kV = wheelFeedforward.kV * wheelSpeed,
+                      .kA = wheelFeedforward.kA * wheelSpeed};
+    result.success = true;
+    robotLog().info("Angular feedforward: kS {}, kV {}, kA {}, fit {}", result.angular.kS, result.angular.kV,
+                    result.angular.kA, result.angularFit);
+    robotLog().info("Effective track width: {} in, set to {} in", result.trackWidth, drivetrain.trackWidth);
+    return result;
+}
+
+void DriveCharacterizer::writeSamples(const char* path) const {
+    if (!pros::usd::is_installed()) {
+        robotLog().warn("Can't write the characterization samples, there is no SD card");
+        return;
+    }
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+        robotLog().error("Can't open {} to write the characterization samples", path);
+        return;
+    }
+    std::fputs("test,time,power,velocity,heading\n", file);
+    for (const Sample& sample : samples)
+        std::fprintf(file, "%u,%lu,%.1f,%.3f,%.3f\n", sample.test, (unsigned long)sample.time, sample.power,
+                     sample.velocity, sample.heading);
+    std::fclose(file);
+}
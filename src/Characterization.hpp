@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "MotionProfile.hpp"
+
+/**
+ * @brief Settings for a drivetrain characterization
+ */
+struct CharacterizationSettings {
+        /** how fast the quasistatic tests ramp up the power, in power per second. 5 by default */
+        float rampRate = 5;
+        /** power the dynamic tests step to, out of 127. 60 by default */
+        float stepPower = 60;
+        /** furthest each driving test can go, in inches. 36 by default */
+        float maxDistance = 36;
+        /** furthest each turning test can turn, in degrees. 360 by default */
+        float maxRotation = 360;
+        /** longest each test can run, in milliseconds. 10000 by default */
+        int timeout = 10000;
+        /** whether to run the turning tests too. true by default */
+        bool angular = true;
+        /** file to write every sample to, to fit on a computer instead. nullptr to not write one */
+        const char* logPath = "/usd/characterize.csv";
+};
+
+/**
+ * @brief What a drivetrain characterization measured
+ */
+struct CharacterizationResult {
+        /** whether every test ran, and the fits could be solved */
+        bool success = false;
+        /** feedforward for driving, in power per inch per second of wheel speed */
+        Feedforward lateral;
+        /** feedforward for turning in place, in power per degree per second */
+        Feedforward angular;
+        /**
+         * track width the drivetrain turns like, in inches. Wider than the real one, since the wheels scrub sideways
+         * when turning
+         */
+        float trackWidth = 0;
+        /** how much of the power each fit explains, from 0 to 1 */
+        float lateralFit = 0;
+        float angularFit = 0;
+};
+
+/**
+ * @brief Measures the feedforward gains of the drivetrain, for RobotChassis::setFeedforward
+ *
+ * Runs the quasistatic and dynamic tests of the SysId method: each way, the power ramps up slowly so the robot moves
+ * at the speed the power holds it at, then steps up so the robot accelerates. Every tick records the power, the
+ * wheel velocity and the heading. Then power = kS * sign(velocity) + kV * velocity + kA * acceleration is fitted by
+ * least squares, once for driving and once for turning in place. The turning tests also measure how much wider the
+ * drivetrain turns than its track width.
+ *
+ * The driving tests need maxDistance of room in front of and behind the robot. Odometry must be running, and no
+ * motion may run during a characterization.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void opcontrol() {
+ *     chassis.getCalibration().wait();
+ *     DriveCharacterizer characterizer(&chassis, drivetrain);
+ *     CharacterizationResult result = characterizer.characterize();
+ *     if (result.success) chassis.setFeedforward(result.lateral, result.angular);
+ * }
+ * @endcode
+ */
+class DriveCharacterizer {
+    public:
+        /**
+         * @brief A tick of a test
+         */
+        struct Sample {
+                /** which test, from 0: quasistatic then dynamic, forwards then backwards, driving then turning */
+                std::uint8_t test;
+                /** in milliseconds since the test started */
+                std::uint32_t time;
+                /** power given to the left side, out of 127. The right side gets minus this when turning */
+                float power;
+                /** wheel velocity, in inches per second. Left minus right over 2 when turning */
+                float velocity;
+                /** heading, in degrees */
+                float heading;
+        };
+
+        /**
+         * @brief DriveCharacterizer constructor
+         *
+         * @param chassis chassis that provides the heading
+         * @param drivetrain drivetrain to characterize
+         */
+        DriveCharacterizer(lemlib::Chassis* chassis, lemlib::Drivetrain drivetrain);
+        /**
+         * @brief Run every test and fit the gains. Blocks until done, which takes tens of seconds
+         */
+        CharacterizationResult characterize(CharacterizationSettings settings = {});
+        /**
+         * @brief Get the samples of the last characterization
+         */
+        const std::vector<Sample>& getSamples() const;
+    private:
+        /**
+         * @brief Run a test, recording every tick
+         *
+         * @param test number of the test
+         * @param turning whether to turn in place, instead of driving
+         * @param dynamic whether to step the power, instead of ramping it
+         * @param direction 1 for forwards or clockwise, -1 for backwards or counterclockwise
+         * @return false if the drivetrain never moved
+         */
+        bool runTest(std::uint8_t test, bool turning, bool dynamic, float direction,
+                     const CharacterizationSettings& settings);
+        /**
+         * @brief Average wheel velocity of a side, in inches per second
+         */
+        float getVelocity(pros::MotorGroup* motors) const;
+        void writeSamples(const char* path) const;
+
+        lemlib::Chassis* chassis;
+        lemlib::Drivetrain drivetrain;
+        std::vector<Sample> samples;
+};
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cinttypes>
+#include <mutex>
+#include "pros/rtos.h"
+#include "RobotLog.hpp"
+#include "CpuProfiler.hpp"
+
+CpuProfiler& cpuProfiler() {
+    static CpuProfiler profiler;
+    return profiler;
+}
+
+#ifdef CPU_PROFILING
+void CpuProfiler::start(std::uint32_t interval) {
+    if (task != nullptr) return;
+    // below the control loops, it only reads what they measured
+    task = new pros::Task([this, interval] { taskLoop(interval); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT,
+                          "CPU Profiler");
+}
+
+void CpuProfiler::beginTrace(const char* path) {
+    tracePath = path;
+    traceRequested = true;
+}
+
+void CpuProfiler::endTrace() { traceRequested = false; }
+
+std::size_t CpuProfiler::getStats(std::array<CpuZoneStats, MAX_ZONES>& stats) {
+    std::lock_guard<pros::Mutex> lock(statsMutex);
+    stats = this->stats;
+    return statsCount;
+}
+
+std::uint32_t CpuProfiler::getDropped() const { return dropped; }
+
+void CpuProfiler::record(const char* name, std::uint64_t start, std::uint32_t duration) {
+    TaskEvents* events = currentTask();
+    if (events == nullptr) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const std::uint32_t head = events->head.load(std::memory_order_relaxed);
+    if (head - events->tail.load(std::memory_order_acquire) >= EVENTS_PER_TASK) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events->events[head % EVENTS_PER_TASK] = {name, duration, start};
+    // publish the event after it has been written
+    events->head.store(head + 1, std::memory_order_release);
+}
+
+CpuProfiler::TaskEvents* CpuProfiler::currentTask() {
+    const pros::task_t current = pros::c::task_get_current();
+    const std::size_t count = taskCount.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; i++) {
+        if (tasks[i].task.load(std::memory_order_relaxed) == current) return &tasks[i];
+    }
+    const std::size_t index = taskCount.fetch_add(1);
+    if (index >= MAX_TASKS) {
+        taskCount = MAX_TASKS;
+        return nullptr;
+    }
+    tasks[index].task = current;
+    return &tasks[index];
+}
+
+std::size_t CpuProfiler::bucket(std::uint32_t duration) {
+    if (duration < 16) return duration;
+    const int exponent = 31 - __builtin_clz(duration);
+    return 16 + (exponent - 4) * 8 + ((duration >> (exponent - 3)) & 7);
+}
+
+std::uint32_t CpuProfiler::bucketLimit(std::size_t bucket) {
+    if (bucket < 16) return bucket;
+    const int exponent = (bucket - 16) / 8 + 4;
+    const std::uint32_t width = std::uint32_t(1) << (exponent - 3);
+    return (8 + (bucket - 16) % 8) * width + (width - 1);
+}
+
+void CpuProfiler::taskLoop(std::uint32_t interval) {
+    std::uint32_t prevTime = pros::millis();
+    std::uint32_t intervalStart = prevTime;
+    while (true) {
+        updateTrace();
+        // drain often, so the buffers of busy tasks don't fill up
+        const std::size_t count = std::min(taskCount.load(std::memory_order_acquire), MAX_TASKS);
+        for (std::size_t i = 0; i < count; i++) {
+            TaskEvents& events = tasks[i];
+            std::uint32_t tail = events.tail.load(std::memory_order_relaxed);
+            const std::uint32_t head = events.head.load(std::memory_order_acquire);
+            for (; tail != head; tail++) aggregate(events.events[tail % EVENTS_PER_TASK], i);
+            events.tail.store(tail, std::memory_order_release);
+        }
+        if (pros::millis() - intervalStart >= interval) {
+            publish();
+            intervalStart = pros::millis();
+        }
+        pros::Task::delay_until(&prevTime, 50);
+    }
+}
+
+void CpuProfiler::aggregate(const Event& event, std::size_t task) {
+    std::size_t index = 0;
+    while (index < zoneCount && zones[index].name != event.name) index++;
+    if (index == zoneCount) {
+        if (zoneCount == MAX_ZONES) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        zones[zoneCount++].name = event.name;
+    }
+    Zone& zone = zones[index];
+    zone.min = zone.count == 0 ? event.duration : std::min(zone.min, event.duration);
+    zone.max = std::max(zone.max, event.duration);
+    zone.sum += event.duration;
+    zone.count++;
+    zone.histogram[bucket(event.duration)]++;
+
+    if (traceFile == nullptr) return;
+    std::fprintf(traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ",\"dur\":%" PRIu32 ",\"pid\":1,\"tid\":%u}",
+                 firstTraceEvent ? "\n" : ",\n", event.name, event.start, event.duration, unsigned(task));
+    firstTraceEvent = false;
+}
+
+void CpuProfiler::publish() {
+    std::array<CpuZoneStats, MAX_ZONES> published = {};
+    for (std::size_t i = 0; i < zoneCount; i++) {
+        Zone& zone = zones[i];
+        CpuZoneStats& stats = published[i];
+        stats.name = zone.name;
+        stats.count = zone.count;
+        if (zone.count != 0) {
+            stats.min = zone.min;
+            stats.mean = zone.sum / zone.count;
+            stats.max = zone.max;
+            // the first bucket that holds 99% of the durations
+            const std::uint32_t target = zone.count - zone.count / 100;
+            std::uint32_t seen = 0;
+            std::size_t bucket = 0;
+            while ((seen += zone.histogram[bucket]) < target) bucket++;
+            stats.p99 = std::min(bucketLimit(bucket), zone.max);
+            robotLog().debug("{}: {} runs, min {}us, mean {}us, p99 {}us, max {}us", stats.name, stats.count,
+                             stats.min, stats.mean, stats.p99, stats.max);
+        }
+        // start the next interval
+        zone = Zone();
+        zone.name = stats.name;
+    }
+    std::lock_guard<pros::Mutex> lock(statsMutex);
+    stats = published;
+    statsCount = zoneCount;
+}
+
+void CpuProfiler::updateTrace() {
+    const bool requested = traceRequested;
+    if (requested && traceFile == nullptr) {
+        const char* path = tracePath;
+        traceFile = std::fopen(path, "w");
+        if (traceFile == nullptr) {
+            robotLog().error("Can't open {} to write a trace", path);
+            traceRequested = false;
+            return;
+        }
+        std::fputs("{\"traceEvents\":[", traceFile);
+        firstTraceEvent = true;
+    } else if (!requested && traceFile != nullptr) {
+        // name each task's row of the timeline
+        const std::size_t count = std::min(taskCount.load(std::memory_order_acquire), MAX_TASKS);
+        for (std::size_t i = 0; i < count; i++) {
+            std::fprintf(traceFile,
+                         "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                         firstTraceEvent ? "\n" : ",\n", unsigned(i), pros::c::task_get_name(tasks[i].task));
+            firstTraceEvent = false;
+        }
+        std::fputs("\n]}\n", traceFile);
+        std::fclose(traceFile);
+        traceFile = nullptr;
+    }
+}
+#endif
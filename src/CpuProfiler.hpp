@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include "pros/rtos.hpp"
+
+/**
+ * @brief How long a zone took over the last aggregation interval. Times are in microseconds
+ */
+struct CpuZoneStats {
+        /** name of the zone */
+        const char* name = nullptr;
+        /** number of times the zone ran */
+        std::uint32_t count = 0;
+        std::uint32_t min = 0;
+        std::uint32_t mean = 0;
+        /** 99th percentile, rounded up to within an eighth */
+        std::uint32_t p99 = 0;
+        std::uint32_t max = 0;
+};
+
+/**
+ * @brief Measures how long named zones of code take, on every task, and exports a timeline
+ *
+ * Mark a zone with CPU_ZONE("name") at the start of a scope: its start time and duration are measured with
+ * pros::micros and pushed to a buffer owned by the calling task, which costs two clock reads and a few stores and
+ * never blocks. A low priority task drains the buffers, and every interval publishes the min, mean, 99th percentile
+ * and max of each zone. While a trace is running, it also writes every zone to a file in the Chrome trace event
+ * format, which can be opened in chrome://tracing or ui.perfetto.dev to see every task on one timeline.
+ *
+ * Zones are only measured when the project is built with -DCPU_PROFILING (add it to EXTRA_CXXFLAGS in the
+ * Makefile). Otherwise CPU_ZONE and every method compile to nothing.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     cpuProfiler().start();
+ * }
+ *
+ * void autonomous() {
+ *     cpuProfiler().beginTrace("/usd/auton.json");
+ *     chassis.moveToPose(24, 24, 90, 2000);
+ *     chassis.waitUntilDone();
+ *     cpuProfiler().endTrace();
+ * }
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         {
+ *             CPU_ZONE("tank");
+ *             chassis.tank(leftY, rightY);
+ *         }
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class CpuProfiler {
+    public:
+        /** the maximum number of tasks that can be measured */
+        static constexpr std::size_t MAX_TASKS = 8;
+        /** the maximum number of zones */
+        static constexpr std::size_t MAX_ZONES = 32;
+        /** zones each task can measure before the profiler drains them */
+        static constexpr std::size_t EVENTS_PER_TASK = 512;
+#ifdef CPU_PROFILING
+        /**
+         * @brief Start the task that aggregates the zones
+         *
+         * @param interval how often the stats are published, in milliseconds. 1000 by default
+         */
+        void start(std::uint32_t interval = 1000);
+        /**
+         * @brief Start writing every zone to a Chrome trace file. Returns straight away, the file is opened by the
+         * profiler's task
+         *
+         * @param path the file. Must outlive the trace, like a string literal
+         */
+        void beginTrace(const char* path);
+        /**
+         * @brief Finish the trace file. Returns straight away
+         */
+        void endTrace();
+        /**
+         * @brief Get the stats of every zone over the last interval
+         *
+         * @return std::size_t the number of zones
+         */
+        std::size_t getStats(std::array<CpuZoneStats, MAX_ZONES>& stats);
+        /**
+         * @brief Get the number of zones that weren't measured, because their task's buffer was full, there were
+         * too many tasks or too many zones
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @brief Record a zone on the calling task. Called by CpuZone
+         */
+        void record(const char* name, std::uint64_t start, std::uint32_t duration);
+#else
+        void start(std::uint32_t = 1000) {}
+
+        void beginTrace(const char*) {}
+
+        void endTrace() {}
+
+        std::size_t getStats(std::array<CpuZoneStats, MAX_ZONES>&) { return 0; }
+
+        std::uint32_t getDropped() const { return 0; }
+#endif
+    private:
+#ifdef CPU_PROFILING
+        /** buckets of the duration histograms. Durations under 16us get a bucket each, longer ones 8 per power of 2 */
+        static constexpr std::size_t BUCKETS = 16 + 28 * 8;
+
+        /**
+         * @brief A measured zone
+         */
+        struct Event {
+                const char* name;
+                std::uint32_t duration;
+                std::uint64_t start;
+        };
+
+        /**
+         * @brief The zones measured by one task, waiting to be drained
+         */
+        struct TaskEvents {
+                std::atomic<pros::task_t> task {nullptr};
+                std::array<Event, EVENTS_PER_TASK> events;
+                /** written by the task */
+                std::atomic<std::uint32_t> head {0};
+                /** written by the profiler */
+                std::atomic<std::uint32_t> tail {0};
+        };
+
+        /**
+         * @brief A zone's durations over the current interval
+         */
+        struct Zone {
+                const char* name = nullptr;
+                std::uint32_t count = 0;
+                std::uint32_t min = 0;
+                std::uint32_t max = 0;
+                std::uint64_t sum = 0;
+                std::array<std::uint32_t, BUCKETS> histogram = {};
+        };
+
+        static std::size_t bucket(std::uint32_t duration);
+        static std::uint32_t bucketLimit(std::size_t bucket);
+
+        /**
+         * @brief Find the calling task's buffer, giving it one if it hasn't got one yet
+         */
+        TaskEvents* currentTask();
+        /**
+         * @brief The function run inside the profiler's task
+         */
+        void taskLoop(std::uint32_t interval);
+        /**
+         * @brief Add an event to its zone, and to the trace
+         */
+        void aggregate(const Event& event, std::size_t task);
+        /**
+         * @brief Publish the stats of the interval, and start the next one
+         */
+        void publish();
+        /**
+         * @brief Open or close the trace file, as requested
+         */
+        void updateTrace();
+
+        std::array<TaskEvents, MAX_TASKS> tasks;
+        std::atomic<std::size_t> taskCount = 0;
+        std::atomic<std::uint32_t> dropped = 0;
+        pros::Task* task = nullptr;
+
+        // only used by the profiler's task
+        std::array<Zone, MAX_ZONES> zones;
+        std::size_t zoneCount = 0;
+        FILE* traceFile = nullptr;
+        bool firstTraceEvent = true;
+
+        std::atomic<const char*> tracePath = nullptr;
+        std::atomic<bool> traceRequested = false;
+
+        pros::Mutex statsMutex;
+        std::array<CpuZoneStats, MAX_ZONES> stats;
+        std::size_t statsCount = 0;
+#endif
+};
+
+/**
+ * @brief Get the profiler
+ */
+CpuProfiler& cpuProfiler();
+
+/**
+ * @brief Measures the scope it is declared in. Use CPU_ZONE
+ */
+class CpuZone {
+    public:
+#ifdef CPU_PROFILING
+        CpuZone(const char* name)
+            : name(name),
+              start(pros::micros()) {}
+
+        ~CpuZone() { end(); }
+
+        /**
+         * @brief End the zone before the end of the scope, for example before waiting for the next tick
+         */
+        void end() {
+            if (name == nullptr) return;
+            cpuProfiler().record(name, start, pros::micros() - start);
+            name = nullptr;
+        }
+    private:
+        const char* name;
+        std::uint64_t start;
+#else
+        CpuZone(const char*) {}
+
+        void end() {}
+#endif
+};
+
+#define CPU_ZONE_CONCAT_(a, b) a##b
+#define CPU_ZONE_CONCAT(a, b) CPU_ZONE_CONCAT_(a, b)
+/**
+ * @brief Measure the rest of the scope as a zone
+ *
+ * @param name name of the zone. Must be a string literal
+ */
+#define CPU_ZONE(name) CpuZone CPU_ZONE_CONCAT(cpuZone, __LINE__)(name)
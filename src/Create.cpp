@@ -1,5 +1,6 @@
 #include "main.h" // IWYU pragma: keep
 #include "lemlib/api.hpp" // IWYU pragma: keep
+#include "Create.hpp"
 
 // Initlizing the controller object
 pros::Controller controller(pros::E_CONTROLLER_MASTER);
@@ -14,6 +15,11 @@ pros::Motor IO3 (3, pros::MotorGearset::blue);
 pros::Motor IO4 (4, pros::MotorGearset::green);
 // Intake/Outtake motors on ports 2, 3, and 4 (all forwards)
 
+// velocity loops for the Intake & Outtake motors, they recover from octoballs faster than move_velocity
+VelocityController IO2Velocity(&IO2);
+VelocityController IO3Velocity(&IO3);
+VelocityController IO4Velocity(&IO4);
+
 // Creating the components for the chassis
 pros::MotorGroup leftmotors({-11, 17, -15}, pros::MotorGearset::blue); // left motors use 600 RPM cartridges
 pros::MotorGroup rightmotors({16, -14, 13}, pros::MotorGearset::blue); // right motors use 600 RPM cartridges
@@ -80,21 +86,41 @@ lemlib::ExpoDriveCurve steer_curve(3, // joystick deadband out of 127
                                   1.019 // expo curve gain
 );
 
+// odometry from the drive motor encoders, using the time each encoder was sampled at
+TimestampedOdom timestampedOdom(drivetrain, &imu);
+
+// odometry runs every 10ms, above the priority of the LCD and logger tasks
+OdomScheduler odomScheduler(10, // period, in milliseconds
+                            TASK_PRIORITY_DEFAULT + 2, // task priority
+                            [] { timestampedOdom.update(); } // we have no tracking wheels
+);
+
 // create the chassis
-lemlib::Chassis chassis(drivetrain,
-                        lateral_controller,
-                        angular_controller,
-                        sensors,
-                        &throttle_curve, 
-                        &steer_curve
+RobotChassis chassis(drivetrain,
+                     lateral_controller,
+                     angular_controller,
+                     sensors,
+                     &odomScheduler,
+                     &throttle_curve, 
+                     &steer_curve
 );
 
+// binary telemetry over serial, decoded on the computer by tools/telemetry_decode. Off until enabled in initialize
+TelemetryStream telemetry;
+
+// pose telemetry, in inches and degrees
+TelemetryRecord<float, float, float> poseTelemetry =
+    telemetry.addRecord<float, float, float>("pose", {"x", "y", "theta"});
+
+// log files on the SD card, decoded on the computer by tools/sdlog_decode
+SdLogSink sdLog;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Creating A motor Group for the outtake motors
 void IO_velocities(int bottom, int middle, int top)
 {
-    IO2.move_velocity(bottom);
-    IO3.move_velocity(middle);
-    IO4.move_velocity(top);
+    IO2Velocity.setVelocity(bottom);
+    IO3Velocity.setVelocity(middle);
+    IO4Velocity.setVelocity(top);
 }
\ No newline at end of file
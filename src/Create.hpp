@@ -1,6 +1,11 @@
 #pragma once
 #include "main.h" // IWYU pragma: keep
 #include "lemlib/api.hpp" // IWYU pragma: keep
+#include "RobotChassis.hpp"
+#include "SdLogSink.hpp"
+#include "Telemetry.hpp"
+#include "TimestampedOdom.hpp"
+#include "VelocityController.hpp"
 
 //controller 
 extern pros::Controller controller;
@@ -14,6 +19,11 @@ extern pros::Motor IO2;
 extern pros::Motor IO3;
 extern pros::Motor IO4;
 
+// velocity loops for the Intake & Outtake motors
+extern VelocityController IO2Velocity;
+extern VelocityController IO3Velocity;
+extern VelocityController IO4Velocity;
+
 // Optical sensors
 extern pros::Optical optical_sensor;
 
@@ -29,8 +39,21 @@ extern lemlib::ControllerSettings angular_controller;
 extern lemlib::ExpoDriveCurve throttle_curve;
 extern lemlib::ExpoDriveCurve steer_curve;
 
+// odometry from the drive motor encoders
+extern TimestampedOdom timestampedOdom;
+
+// runs odometry at a fixed rate
+extern OdomScheduler odomScheduler;
+
 // create the chassis
-extern lemlib::Chassis chassis;
+extern RobotChassis chassis;
+
+// binary telemetry over serial
+extern TelemetryStream telemetry;
+extern TelemetryRecord<float, float, float> poseTelemetry;
+
+// log files on the SD card, one per run and one per match
+extern SdLogSink sdLog;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#define FMT_HEADER_ONLY
+#include "fmt/core.h"
+
+/**
+ * The records LogBuffer keeps in its rings, shared with the host benchmark in tools/log_bench. This doesn't depend on
+ * PROS.
+ *
+ * A record is a LogFormatter followed by its payload. The formatter turns the payload into text when the buffer task
+ * writes it: text that was formatted on the logging task is copied by copyLogText, and a DeferredLog holds a format
+ * string and the raw arguments, which are only formatted then.
+ */
+
+/**
+ * @brief Turns the payload of a record into text
+ *
+ * @return std::size_t length of the text written to out, at most capacity
+ */
+using LogFormatter = std::size_t (*)(const char* payload, std::size_t size, char* out, std::size_t capacity);
+
+/**
+ * @brief The formatter of text records, which copies the payload
+ */
+inline std::size_t copyLogText(const char* payload, std::size_t size, char* out, std::size_t capacity) {
+    const std::size_t length = std::min(size, capacity);
+    std::memcpy(out, payload, length);
+    return length;
+}
+
+/**
+ * @brief A message whose arguments are copied now and formatted later
+ *
+ * The arguments are copied as they are, so they must be trivially copyable, like numbers, enums and lemlib::Pose, and
+ * not pointers, which may not point to anything by the time they're formatted. The format string must be checked at
+ * compile time: a fmt::runtime string may not outlive the call, and is rejected by LogBuffer::printDeferred.
+ *
+ * @tparam T the types of the arguments
+ */
+template <typename... T> class DeferredLog {
+    public:
+        static_assert(((std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>) && ...),
+                      "deferred arguments must be trivially copyable values");
+
+        /**
+         * @brief Copy the format string and the arguments into the payload
+         */
+        DeferredLog(fmt::format_string<T...> format, const T&... args) {
+            const fmt::string_view formatString = format.get();
+            std::memcpy(payload.data(), &formatString, sizeof(formatString));
+            std::size_t offset = sizeof(formatString);
+            ((std::memcpy(payload.data() + offset, &args, sizeof(T)), offset += sizeof(T)), ...);
+        }
+
+        std::string_view getPayload() const { return std::string_view(payload.data(), payload.size()); }
+
+        /**
+         * @brief The formatter of these records, a LogFormatter
+         */
+        static std::size_t format(const char* payload, std::size_t, char* out, std::size_t capacity) {
+            fmt::string_view format;
+            std::memcpy(&format, payload, sizeof(format));
+            std::size_t offset = sizeof(format);
+            // copy each argument back out of the payload, in order
+            [[maybe_unused]] const auto take = [&]<typename U>() {
+                std::array<char, sizeof(U)> bytes;
+                std::memcpy(bytes.data(), payload + offset, sizeof(U));
+                offset += sizeof(U);
+                return std::bit_cast<U>(bytes);
+            };
+            const std::tuple<T...> args {take.template operator()<T>()...};
+            return std::apply(
+                [&](const T&... values) {
+                    const auto result = fmt::vformat_to_n(out, capacity, format, fmt::make_format_args(values...));
+                    return std::min(result.size, capacity);
+                },
+                args);
+        }
+    private:
+        std::array<char, sizeof(fmt::string_view) + (sizeof(T) + ... + 0)> payload;
+};
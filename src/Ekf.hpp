@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Gate for Ekf::update that rejects as many good measurements of any size as a sigma gate does in 1D
+ *
+ * A good measurement of M values has a squared Mahalanobis distance that follows a chi-square distribution with M
+ * degrees of freedom. The gate is where that distribution has the same tail as a normal distribution past sigma
+ * standard deviations: 9 for 3 sigma in 1D, but 11.8 in 2D and 14.2 in 3D.
+ *
+ * This solves for the gate numerically, so call it once, not every update.
+ *
+ * @param dof number of values measured
+ * @param sigma gate for a single value, in standard deviations
+ * @return float the largest squared Mahalanobis distance to accept
+ */
+inline float chiSquareGate(std::size_t dof, float sigma) {
+    // chance a good single value is within sigma standard deviations
+    const double probability = std::erf(sigma / std::sqrt(2.0));
+    // chi-square cdf, the regularized lower incomplete gamma function P(dof / 2, distance / 2), by its series
+    auto cdf = [dof](double distance) {
+        const double a = dof / 2.0;
+        const double x = distance / 2;
+        if (x <= 0) return 0.0;
+        double term = 1 / a;
+        double sum = term;
+        for (int n = 1; n < 500 && term > sum * 1e-12; n++) {
+            term *= x / (a + n);
+            sum += term;
+        }
+        return sum * std::exp(a * std::log(x) - x - std::lgamma(a));
+    };
+    // the cdf only grows, so bisect
+    double low = 0;
+    double high = 10 * (sigma * sigma + dof);
+    for (int i = 0; i < 64; i++) {
+        const double mid = (low + high) / 2;
+        if (cdf(mid) < probability) low = mid;
+        else high = mid;
+    }
+    return float((low + high) / 2);
+}
+
+/**
+ * @brief A fixed size extended Kalman filter
+ *
+ * Only holds the state and covariance, and does the linear algebra. The model lives in the user: it moves the state
+ * itself, then calls predict with the Jacobian of the model, and calls update with the innovation and Jacobian of
+ * each measurement.
+ *
+ * Measurements are gated: if the squared Mahalanobis distance of the innovation from what the filter expects is above
+ * the gate, the measurement is rejected as an outlier. That distance grows with the number of values measured, so
+ * each size of measurement needs its own gate, see chiSquareGate.
+ *
+ * Everything is fixed size, so nothing allocates. This doesn't depend on PROS.
+ *
+ * @tparam N number of states
+ */
+template <std::size_t N> class Ekf {
+    public:
+        using Vector = std::array<float, N>;
+        using Matrix = std::array<std::array<float, N>, N>;
+        template <std::size_t M> using MeasurementMatrix = std::array<std::array<float, N>, M>;
+        template <std::size_t M> using SquareMatrix = std::array<std::array<float, M>, M>;
+
+        /** state estimate */
+        Vector x = {};
+        /** state covariance */
+        Matrix P = {};
+
+        /**
+         * @brief Propagate the covariance through the model. The state must already have been moved
+         *
+         * @param F Jacobian of the model with respect to the state
+         * @param Q process noise covariance
+         */
+        void predict(const Matrix& F, const Matrix& Q) {
+            // P = F P F^T + Q
+            Matrix FP = {};
+            for (std::size_t i = 0; i < N; i++)
+                for (std::size_t j = 0; j < N; j++)
+                    for (std::size_t k = 0; k < N; k++) FP[i][j] += F[i][k] * P[k][j];
+            for (std::size_t i = 0; i < N; i++) {
+                for (std::size_t j = 0; j < N; j++) {
+                    float sum = Q[i][j];
+                    for (std::size_t k = 0; k < N; k++) sum += FP[i][k] * F[j][k];
+                    P[i][j] = sum;
+                }
+            }
+        }
+
+        /**
+         * @brief Correct the state with a measurement
+         *
+         * @tparam M number of values measured
+         * @param innovation measured value minus the value the state predicts. Angles must already be wrapped
+         * @param H Jacobian of the measurement with respect to the state
+         * @param R measurement noise covariance
+         * @param gate largest squared Mahalanobis distance accepted. chiSquareGate(M, sigma) for the same chance of
+         * rejecting a good measurement whatever its size
+         * @return true if the measurement was used, false if it was rejected as an outlier
+         */
+        template <std::size_t M> bool update(const std::array<float, M>& innovation, const MeasurementMatrix<M>& H,
+                                             const SquareMatrix<M>& R, float gate) {
+            // PHt = P H^T
+            std::array<std::array<float, M>, N> PHt = {};
+            for (std::size_t i = 0; i < N; i++)
+                for (std::size_t j = 0; j < M; j++)
+                    for (std::size_t k = 0; k < N; k++) PHt[i][j] += P[i][k] * H[j][k];
+            // innovation covariance S = H P H^T + R
+            SquareMatrix<M> S = R;
+            for (std::size_t i = 0; i < M; i++)
+                for (std::size_t j = 0; j < M; j++)
+                    for (std::size_t k = 0; k < N; k++) S[i][j] += H[i][k] * PHt[k][j];
+            SquareMatrix<M> Sinv;
+            if (!invert(S, Sinv)) return false;
+
+            // reject outliers
+            float distance = 0;
+            for (std::size_t i = 0; i < M; i++)
+                for (std::size_t j = 0; j < M; j++) distance += innovation[i] * Sinv[i][j] * innovation[j];
+            if (distance > gate) return false;
+
+            // gain K = P H^T S^-1
+            std::array<std::array<float, M>, N> K = {};
+            for (std::size_t i = 0; i < N; i++)
+                for (std::size_t j = 0; j < M; j++)
+                    for (std::size_t k = 0; k < M; k++) K[i][j] += PHt[i][k] * Sinv[k][j];
+            // x = x + K y
+            for (std::size_t i = 0; i < N; i++)
+                for (std::size_t j = 0; j < M; j++) x[i] += K[i][j] * innovation[j];
+            // P = P - K H P, which is P - K (P H^T)^T
+            for (std::size_t i = 0; i < N; i++)
+                for (std::size_t j = 0; j < N; j++)
+                    for (std::size_t k = 0; k < M; k++) P[i][j] -= K[i][k] * PHt[j][k];
+            // keep P symmetric despite rounding
+            for (std::size_t i = 0; i < N; i++) {
+                for (std::size_t j = i + 1; j < N; j++) {
+                    const float average = (P[i][j] + P[j][i]) / 2;
+                    P[i][j] = average;
+                    P[j][i] = average;
+                }
+            }
+            return true;
+        }
+    private:
+        /**
+         * @brief Invert a small matrix with Gauss-Jordan elimination
+         *
+         * @return false if the matrix is singular
+         */
+        template <std::size_t M> static bool invert(SquareMatrix<M> a, SquareMatrix<M>& inverse) {
+            inverse = {};
+            for (std::size_t i = 0; i < M; i++) inverse[i][i] = 1;
+            for (std::size_t col = 0; col < M; col++) {
+                // partial pivoting
+                std::size_t pivot = col;
+                for (std::size_t row = col + 1; row < M; row++)
+                    if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+                if (std::fabs(a[pivot][col]) < 1e-12f) return false;
+                std::swap(a[col], a[pivot]);
+                std::swap(inverse[col], inverse[pivot]);
+                const float scale = 1 / a[col][col];
+                for (std::size_t j = 0; j < M; j++) {
+                    a[col][j] *= scale;
+                    inverse[col][j] *= scale;
+                }
+                for (std::size_t row = 0; row < M; row++) {
+                    if (row == col) continue;
+                    const float factor = a[row][col];
+                    for (std::size_t j = 0; j < M; j++) {
+                        a[row][j] -= factor * a[col][j];
+                        inverse[row][j] -= factor * inverse[col][j];
+                    }
+                }
+            }
+            return true;
+        }
+};
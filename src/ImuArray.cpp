@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+#include "ImuArray.hpp"
+
+ImuArray::ImuArray(std::initializer_list<pros::Imu*> imus, ImuArraySettings settings)
+    : pros::Imu((*imus.begin())->get_port()),
+      settings(settings) {
+    for (pros::Imu* imu : imus) {
+        if (count >= MAX_IMUS) break;
+        sensors[count++].imu = imu;
+    }
+}
+
+void ImuArray::fault(Sensor& sensor, std::uint32_t now) {
+    // only count new faults, not an IMU that is still unplugged
+    if (sensor.tracking) sensor.faults++;
+    sensor.tracking = false;
+    sensor.faultedUntil = now + settings.recoveryTime;
+}
+
+void ImuArray::update() {
+    const std::uint32_t now = pros::millis();
+    const float dt = prevTime == 0 ? 0 : (now - prevTime) / 1000.0f;
+    prevTime = now;
+    if (resetRequested) {
+        resetRequested = false;
+        for (std::size_t i = 0; i < count; i++) sensors[i] = {.imu = sensors[i].imu, .faults = sensors[i].faults};
+        stillSince = 0;
+        prevDelta = 0;
+    }
+
+    // read every IMU that is working
+    std::array<float, MAX_IMUS> deltas = {};
+    std::array<float, MAX_IMUS> rates = {};
+    std::array<Sensor*, MAX_IMUS> voters = {};
+    std::size_t voterCount = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        Sensor& sensor = sensors[i];
+        if (sensor.imu->get_status() == pros::ImuStatus::error || sensor.imu->is_calibrating()) {
+            fault(sensor, now);
+            continue;
+        }
+        if (now < sensor.faultedUntil) continue;
+        const double rotation = sensor.imu->get_rotation();
+        const float rate = sensor.imu->get_gyro_rate().z;
+        if (!std::isfinite(rotation) || !std::isfinite(rate)) {
+            fault(sensor, now);
+            continue;
+        }
+        // the IMU just started working, it can vote next update
+        if (!sensor.tracking) {
+            sensor.prevRotation = rotation;
+            sensor.tracking = true;
+            continue;
+        }
+        deltas[voterCount] = rotation - sensor.prevRotation;
+        rates[voterCount] = rate;
+        voters[voterCount++] = &sensor;
+        sensor.prevRotation = rotation;
+    }
+    if (voterCount == 0 || dt <= 0) {
+        // nothing to go on, hold the heading
+        rate = 0;
+        prevDelta = 0;
+        return;
+    }
+
+    // the robot is stationary if the gyros have read almost nothing for a while
+    std::array<float, MAX_IMUS> sorted = {};
+    for (std::size_t i = 0; i < voterCount; i++) sorted[i] = std::fabs(rates[i]);
+    std::sort(sorted.begin(), sorted.begin() + voterCount);
+    if (sorted[voterCount / 2] > settings.stationaryRate) stillSince = 0;
+    else if (stillSince == 0) stillSince = now;
+    const bool stationary = stillSince != 0 && now - stillSince >= settings.stationaryTime;
+
+    for (std::size_t i = 0; i < voterCount; i++) deltas[i] -= voters[i]->drift * dt;
+
+    // vote. With 3 or more IMUs the median is trusted, with less the robot can't have turned much faster or slower
+    // than last update
+    float reference = stationary ? 0 : prevDelta;
+    if (voterCount >= 3) {
+        for (std::size_t i = 0; i < voterCount; i++) sorted[i] = deltas[i];
+        std::sort(sorted.begin(), sorted.begin() + voterCount);
+        reference = voterCount % 2 == 1 ? sorted[voterCount / 2]
+                                        : (sorted[voterCount / 2 - 1] + sorted[voterCount / 2]) / 2;
+    }
+    float weightedSum = 0;
+    float totalWeight = 0;
+    for (std::size_t i = 0; i < voterCount; i++) {
+        Sensor& sensor = *voters[i];
+        const float residual = deltas[i] - reference;
+        // a lone IMU has nothing to disagree with
+        if (voterCount > 1 && std::fabs(residual) > settings.glitchThreshold) {
+            fault(sensor, now);
+            continue;
+        }
+        const float weight = 1 / (sensor.variance + 1e-6f);
+        weightedSum += weight * deltas[i];
+        totalWeight += weight;
+        sensor.variance += settings.biasSmoothing * (residual * residual - sensor.variance);
+    }
+    // every IMU disagreed with the last update, so the robot really did change speed
+    if (totalWeight == 0) {
+        for (std::size_t i = 0; i < voterCount; i++) {
+            voters[i]->tracking = true;
+            voters[i]->faultedUntil = 0;
+            voters[i]->faults--;
+        }
+        for (std::size_t i = 0; i < voterCount; i++) sorted[i] = deltas[i];
+        std::sort(sorted.begin(), sorted.begin() + voterCount);
+        weightedSum = sorted[voterCount / 2];
+        totalWeight = 1;
+    }
+
+    if (stationary) {
+        // any change in rotation now is drift the estimate missed. Hold the heading
+        for (std::size_t i = 0; i < voterCount; i++)
+            if (voters[i]->tracking) voters[i]->drift += settings.biasSmoothing * deltas[i] / dt;
+        rate = 0;
+        prevDelta = 0;
+        return;
+    }
+
+    const float delta = weightedSum / totalWeight;
+    rotation += delta;
+    rate = delta / dt;
+    prevDelta = delta;
+}
+
+std::int32_t ImuArray::reset(bool blocking) const {
+    std::int32_t result = PROS_ERR;
+    // start every IMU before waiting for any of them, so they calibrate at the same time
+    for (std::size_t i = 0; i < count; i++)
+        if (sensors[i].imu->reset(false) != PROS_ERR) result = 1;
+    offset = -rotation;
+    resetRequested = true;
+    if (blocking && result != PROS_ERR) {
+        // calibration sets the calibrating flag a little after it starts
+        pros::delay(50);
+        while (is_calibrating()) pros::delay(10);
+    }
+    return result;
+}
+
+double ImuArray::get_rotation() const { return rotation + offset; }
+
+double ImuArray::get_heading() const {
+    const double heading = std::fmod(get_rotation(), 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+pros::imu_gyro_s_t ImuArray::get_gyro_rate() const {
+    pros::imu_gyro_s_t gyro = pros::Imu::get_gyro_rate();
+    gyro.z = rate;
+    return gyro;
+}
+
+std::int32_t ImuArray::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t ImuArray::tare_heading() const { return set_heading(0); }
+
+std::int32_t ImuArray::set_rotation(const double target) const {
+    offset = target - rotation;
+    return 1;
+}
+
+std::int32_t ImuArray::set_heading(const double target) const {
+    if (target < 0 || target > 360) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    // keep the number of full turns, like pros::Imu::set_heading
+    return set_rotation(get_rotation() - get_heading() + target);
+}
+
+pros::ImuStatus ImuArray::get_status() const {
+    if (is_calibrating()) return pros::ImuStatus::calibrating;
+    for (std::size_t i = 0; i < count; i++)
+        if (sensors[i].imu->get_status() != pros::ImuStatus::error) return pros::ImuStatus::ready;
+    return pros::ImuStatus::error;
+}
+
+bool ImuArray::is_calibrating() const {
+    for (std::size_t i = 0; i < count; i++)
+        if (sensors[i].imu->get_status() != pros::ImuStatus::error && sensors[i].imu->is_calibrating()) return true;
+    return false;
+}
+
+std::size_t ImuArray::size() const { return count; }
+
+bool ImuArray::isHealthy(std::size_t i) const {
+    return i < count && sensors[i].tracking && pros::millis() >= sensors[i].faultedUntil;
+}
+
+std::uint32_t ImuArray::getFaults(std::size_t i) const { return i < count ? sensors[i].faults : 0; }
+
+float ImuArray::getDrift(std::size_t i) const { return i < count ? sensors[i].drift : 0; }
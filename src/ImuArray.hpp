@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include "pros/imu.hpp"
+
+/**
+ * @brief Settings for ImuArray
+ */
+struct ImuArraySettings {
+        /** the robot is stationary when the gyros read less than this, in degrees per second. 1 by default */
+        float stationaryRate = 1;
+        /** how long the gyros have to read less than stationaryRate for the robot to be stationary, in
+         * milliseconds. 250 by default */
+        std::uint32_t stationaryTime = 250;
+        /** how quickly the drift estimate follows new drift while stationary. Between 0 and 1. 0.02 by default */
+        float biasSmoothing = 0.02;
+        /** an IMU that disagrees with the others by more than this in one update is faulted, in degrees.
+         * 2 by default */
+        float glitchThreshold = 2;
+        /** how long a faulted IMU is ignored for, in milliseconds. 1000 by default */
+        std::uint32_t recoveryTime = 1000;
+};
+
+/**
+ * @brief Several IMUs, fused into one heading
+ *
+ * Each update, every IMU's change in rotation is corrected for its drift, then the IMUs vote. With 3 or more IMUs,
+ * any IMU that disagrees with the median by more than the glitch threshold is faulted. With 2, any IMU that
+ * disagrees with how fast the robot was turning is. The rest are averaged, weighted by how closely each one has
+ * agreed with the others, so a noisy IMU counts for less.
+ *
+ * A faulted IMU, or one that reports an error or is calibrating, is ignored for the recovery time. Since the IMUs
+ * vote on changes in rotation, an IMU that was bumped rejoins without pulling the heading with it.
+ *
+ * While the robot is stationary, any change in rotation is drift. It is used to estimate each IMU's drift rate,
+ * which is subtracted while the robot moves, and the heading is held.
+ *
+ * ImuArray is a pros::Imu, so it can be used anywhere a single IMU can, like lemlib::OdomSensors. update() must be
+ * called regularly, by the OdomScheduler. Only the methods used for heading are fused, everything else is read from
+ * the first IMU.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Imu imu1(10);
+ * pros::Imu imu2(9);
+ * pros::Imu imu3(8);
+ * ImuArray imus({&imu1, &imu2, &imu3});
+ * lemlib::OdomSensors sensors(nullptr, nullptr, nullptr, nullptr, &imus);
+ * TimestampedOdom timestampedOdom(drivetrain, &imus);
+ * OdomScheduler odomScheduler(10, TASK_PRIORITY_DEFAULT + 2, [] {
+ *     imus.update();
+ *     timestampedOdom.update();
+ * });
+ * @endcode
+ */
+class ImuArray : public pros::Imu {
+    public:
+        /** the maximum number of IMUs */
+        static constexpr std::size_t MAX_IMUS = 4;
+
+        /**
+         * @brief Construct a new ImuArray
+         *
+         * @param imus the IMUs. There must be at least 1, and at most MAX_IMUS
+         * @param settings settings for drift estimation and voting
+         */
+        ImuArray(std::initializer_list<pros::Imu*> imus, ImuArraySettings settings = {});
+        /**
+         * @brief Read every IMU and update the fused heading
+         */
+        void update();
+        /**
+         * @brief Calibrate every IMU at the same time
+         *
+         * @param blocking whether to wait until calibration finishes
+         * @return std::int32_t 1 if at least one IMU started calibrating, PROS_ERR otherwise
+         */
+        std::int32_t reset(bool blocking = false) const override;
+        /**
+         * @brief Get the fused rotation, in degrees. Doesn't wrap
+         */
+        double get_rotation() const override;
+        /**
+         * @brief Get the fused heading, in degrees from 0 to 360
+         */
+        double get_heading() const override;
+        /**
+         * @brief Get the fused, drift corrected turn rate around z, in degrees per second
+         *
+         * x and y are read from the first IMU
+         */
+        pros::imu_gyro_s_t get_gyro_rate() const override;
+        std::int32_t tare_rotation() const override;
+        std::int32_t tare_heading() const override;
+        std::int32_t set_rotation(const double target) const override;
+        std::int32_t set_heading(const double target) const override;
+        /**
+         * @brief Get the status of the array
+         *
+         * @return pros::ImuStatus error if every IMU has faulted, calibrating if any is calibrating, ready otherwise
+         */
+        pros::ImuStatus get_status() const override;
+        /**
+         * @brief Whether any IMU is calibrating
+         */
+        bool is_calibrating() const override;
+        /**
+         * @brief Get the number of IMUs
+         */
+        std::size_t size() const;
+        /**
+         * @brief Whether an IMU is currently used in the vote
+         *
+         * @param i index of the IMU, in the order they were passed to the constructor
+         */
+        bool isHealthy(std::size_t i) const;
+        /**
+         * @brief Get the number of times an IMU has been faulted
+         *
+         * @param i index of the IMU, in the order they were passed to the constructor
+         */
+        std::uint32_t getFaults(std::size_t i) const;
+        /**
+         * @brief Get the estimated drift rate of an IMU, in degrees per second
+         *
+         * @param i index of the IMU, in the order they were passed to the constructor
+         */
+        float getDrift(std::size_t i) const;
+    private:
+        /**
+         * @brief One IMU and what is known about it
+         */
+        struct Sensor {
+                pros::Imu* imu = nullptr;
+                /** rotation at the last update */
+                double prevRotation = 0;
+                /** whether prevRotation is valid */
+                bool tracking = false;
+                /** estimated drift, in degrees per second */
+                float drift = 0;
+                /** how much this IMU disagrees with the vote each update, in degrees squared */
+                float variance = 0.01;
+                /** the IMU is ignored until this time, in milliseconds */
+                std::uint32_t faultedUntil = 0;
+                std::uint32_t faults = 0;
+        };
+
+        /**
+         * @brief Stop using an IMU for a while
+         */
+        void fault(Sensor& sensor, std::uint32_t now);
+
+        ImuArraySettings settings;
+        std::array<Sensor, MAX_IMUS> sensors = {};
+        std::size_t count = 0;
+
+        std::uint32_t prevTime = 0;
+        /** fused rotation, in degrees */
+        double rotation = 0;
+        /** offset applied by set_rotation and tare */
+        mutable double offset = 0;
+        /** reset() was called, so the drift estimates are stale */
+        mutable bool resetRequested = false;
+        /** fused turn rate, in degrees per second */
+        float rate = 0;
+        /** fused change in rotation in the last update */
+        float prevDelta = 0;
+        /** when the gyros started reading less than the stationary rate, 0 if they aren't */
+        std::uint32_t stillSince = 0;
+};
@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <cstring>
+#include "LogBuffer.hpp"
+
+LogBuffer::LogBuffer(std::function<void(std::string_view)> write, OverflowPolicy policy)
+    : write(std::move(write)),
+      rings {Ring(policy), Ring(policy)} {
+    task = new pros::Task([this] { taskLoop(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Log Buffer");
+}
+
+bool LogBuffer::push(LogLane lane, LogFormatter formatter, std::string_view payload) {
+    return getRing(lane).push(
+        {std::string_view(reinterpret_cast<const char*>(&formatter), sizeof(formatter)), payload});
+}
+
+void LogBuffer::waitForRoom(std::size_t size, LogLane lane) {
+    while (!getRing(lane).hasRoom(sizeof(LogFormatter) + size + CAPACITY / 2)) pros::delay(rate);
+}
+
+void LogBuffer::setRate(std::uint32_t rate) { this->rate = rate; }
+
+void LogBuffer::setBandwidth(std::uint32_t bytesPerSecond) { bandwidth = bytesPerSecond; }
+
+bool LogBuffer::buffersEmpty() const {
+    return getRing(LogLane::PRIORITY).isEmpty() && getRing(LogLane::BULK).isEmpty();
+}
+
+std::uint32_t LogBuffer::getDropped() const {
+    return getRing(LogLane::PRIORITY).getDropped() + getRing(LogLane::BULK).getDropped();
+}
+
+std::uint32_t LogBuffer::getHighWater(LogLane lane) const { return getRing(lane).getHighWater(); }
+
+std::uint32_t LogBuffer::getThroughput() const { return throughput; }
+
+float LogBuffer::getWriteLoad() const { return writeLoad; }
+
+std::size_t LogBuffer::popToBatch(Ring& ring) {
+    std::size_t length;
+    if (!ring.pop(record, length)) return 0;
+    if (BATCH_SIZE - batchLength < MAX_MESSAGE) flush();
+    LogFormatter formatter;
+    std::memcpy(&formatter, record, sizeof(formatter));
+    const std::size_t size = formatter(record + sizeof(formatter), length - sizeof(formatter), batch + batchLength,
+                                       BATCH_SIZE - batchLength);
+    batchLength += size;
+    return size;
+}
+
+void LogBuffer::flush() {
+    if (batchLength == 0) return;
+    const std::uint64_t start = pros::micros();
+    write(std::string_view(batch, batchLength));
+    windowWriteTime += pros::micros() - start;
+    windowBytes += batchLength;
+    batchLength = 0;
+}
+
+void LogBuffer::taskLoop() {
+    std::uint32_t prevTime = pros::millis();
+    std::uint32_t windowStart = prevTime;
+    // bytes the budget allows right now. Can go negative, a message that doesn't fit is paid back over the next ticks
+    std::int32_t budget = 0;
+    while (true) {
+        const std::uint32_t bytesPerSecond = bandwidth;
+        const std::int32_t perTick = bytesPerSecond * rate / 1000;
+        // the budget doesn't build up while there is nothing to write, so it never allows a burst of more than a tick
+        budget = std::min(budget + perTick, perTick);
+
+        // report drops once there is time to write, so the output says where messages are missing
+        const std::uint32_t drops = getDropped();
+        if (getRing(LogLane::BULK).getPolicy() == OverflowPolicy::REPORT_DROPPED && drops != reportedDrops) {
+            const auto result = fmt::format_to_n(batch + batchLength, BATCH_SIZE - batchLength,
+                                                 "[log] {} messages dropped\n", drops - reportedDrops);
+            const std::size_t size = std::min(result.size, BATCH_SIZE - batchLength);
+            batchLength += size;
+            if (bytesPerSecond != 0) budget -= size;
+            reportedDrops = drops;
+        }
+        // at most a ring's worth of each lane per tick, so producers that keep up with the task can't starve it
+        // warnings and errors first, and whatever the budget
+        for (std::size_t size, total = 0; total < CAPACITY && (size = popToBatch(getRing(LogLane::PRIORITY)));) {
+            total += size;
+            if (bytesPerSecond != 0) budget -= size;
+        }
+        for (std::size_t size, total = 0;
+             total < CAPACITY && (bytesPerSecond == 0 || budget > 0) && (size = popToBatch(getRing(LogLane::BULK)));) {
+            total += size;
+            if (bytesPerSecond != 0) budget -= size;
+        }
+        flush();
+
+        // measure the throughput once a second
+        const std::uint32_t now = pros::millis();
+        if (now - windowStart >= 1000) {
+            throughput = std::uint64_t(windowBytes) * 1000 / (now - windowStart);
+            writeLoad = std::min(float(windowWriteTime) / ((now - windowStart) * 1000.0f), 1.0f);
+            windowStart = now;
+            windowBytes = 0;
+            windowWriteTime = 0;
+        }
+        pros::Task::delay_until(&prevTime, rate);
+    }
+}
+
+LogBuffer& bufferedLog() {
+    static LogBuffer buffer([](std::string_view message) {
+        std::fwrite(message.data(), 1, message.size(), stdout);
+        std::fflush(stdout);
+    });
+    return buffer;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string_view>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/message.hpp"
+#include "DeferredLog.hpp"
+#include "LogRing.hpp"
+
+/**
+ * @brief Which ring of a LogBuffer a message goes in
+ */
+enum class LogLane {
+    /** written before any bulk message, even when over the bandwidth budget. For warnings and errors */
+    PRIORITY,
+    /** written within the bandwidth budget. For telemetry and debug output */
+    BULK
+};
+
+/**
+ * @brief The lane for a message of a log level. Warnings and above take the priority lane
+ */
+inline LogLane logLane(lemlib::Level level) { return level >= lemlib::Level::WARN ? LogLane::PRIORITY : LogLane::BULK; }
+
+/**
+ * @brief A drop-in replacement for lemlib::Buffer that never blocks the tasks logging to it
+ *
+ * lemlib::Buffer keeps a std::deque of std::string behind a mutex, so every message allocates, and a task logging
+ * from a control loop can wait on the mutex while the buffer task is writing. LogBuffer copies messages into a fixed
+ * size LogRing instead: pushing never blocks or allocates, and if the ring is full the overflow policy drops a
+ * message rather than growing.
+ *
+ * Every rate milliseconds, a task takes messages out in order and writes them together, in as few writes as
+ * possible. With a bandwidth budget, it only writes as many bytes as the budget allows, so over a slow link like the
+ * V5 radio messages wait in the ring, where the overflow policy handles them, instead of backing up in the link and
+ * arriving seconds late. Messages in the priority lane are written first and don't wait for the budget, so warnings
+ * and errors aren't stuck behind telemetry. getThroughput and getWriteLoad show what the link is actually carrying:
+ * a write load close to 1 means writes are blocking, and the budget should be lowered.
+ *
+ * printDeferred doesn't format on the calling task at all. It copies the format string pointer and the raw
+ * arguments into the ring, and the buffer task formats them when the message is written. Use it from control
+ * loops, where formatting a few floats costs more than the rest of the tick. `make log_bench` measures what each way of
+ * logging costs the calling task, on the host.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // over the radio, send at most 2000 bytes a second
+ * bufferedLog().setBandwidth(2000);
+ * bufferedLog().print("pose: {}, {}\n", pose.x, pose.y);
+ * bufferedLog().print(LogLane::PRIORITY, "intake jammed\n");
+ * // in a control loop: only copies the pose and the error, they're formatted by the buffer task
+ * bufferedLog().printDeferred("pose: {}, error: {:.2f}\n", chassis.getPose(), error);
+ * // check whether the link keeps up
+ * pros::lcd::print(5, "log: %lu B/s, dropped: %lu", bufferedLog().getThroughput(), bufferedLog().getDropped());
+ * @endcode
+ */
+class LogBuffer {
+    public:
+        /** size of each lane's ring, in bytes */
+        static constexpr std::size_t CAPACITY = 8192;
+        using Ring = LogRing<CAPACITY>;
+        /** most bytes written at once */
+        static constexpr std::size_t BATCH_SIZE = 4096;
+
+        /**
+         * @brief Construct a new LogBuffer, and start its task
+         *
+         * @param write function the task calls with each message
+         * @param policy what to do with a message when the ring is full. DROP_NEWEST by default
+         */
+        LogBuffer(std::function<void(std::string_view)> write,
+                  OverflowPolicy policy = OverflowPolicy::DROP_NEWEST);
+        LogBuffer(const LogBuffer&) = delete;
+        LogBuffer& operator=(const LogBuffer&) = delete;
+        /**
+         * @brief Push a message. Never blocks or allocates
+         *
+         * @return true if the message was pushed, false if it was dropped
+         */
+        bool pushToBuffer(std::string_view message, LogLane lane = LogLane::BULK) {
+            return push(lane, copyLogText, message);
+        }
+        /**
+         * @brief Format and push a message, in the bulk lane
+         */
+        template <typename... T> bool print(fmt::format_string<T...> format, T&&... args) {
+            return print(LogLane::BULK, format, std::forward<T>(args)...);
+        }
+        /**
+         * @brief Format and push a message
+         */
+        template <typename... T> bool print(LogLane lane, fmt::format_string<T...> format, T&&... args) {
+            // format into the stack, not a std::string
+            char message[MAX_MESSAGE];
+            const auto result = fmt::format_to_n(message, sizeof(message), format, std::forward<T>(args)...);
+            return pushToBuffer(std::string_view(message, std::min(result.size, sizeof(message))), lane);
+        }
+        /**
+         * @brief Push a message to be formatted later on the buffer task, in the bulk lane
+         */
+        template <typename... T> bool printDeferred(fmt::format_string<T...> format, const T&... args) {
+            return printDeferred(LogLane::BULK, format, args...);
+        }
+        /**
+         * @brief Push a message to be formatted later, on the buffer task. Never blocks or allocates
+         *
+         * The arguments are copied as they are, so they must be trivially copyable, like numbers, enums and
+         * lemlib::Pose, and not pointers, which may not point to anything by the time they're formatted.
+         *
+         * @param lane the lane to push to
+         * @param format the format string. Must be a string literal, it is formatted after this returns
+         * @param args the arguments
+         * @return true if the message was pushed, false if it was dropped
+         */
+        template <typename... T> bool printDeferred(LogLane lane, fmt::format_string<T...> format, const T&... args) {
+            const DeferredLog<T...> message(format, args...);
+            return push(lane, DeferredLog<T...>::format, message.getPayload());
+        }
+        /**
+         * @brief A fmt::runtime format string may be gone by the time the message is formatted, so it can't be deferred
+         */
+        template <typename... T> bool printDeferred(fmt::runtime_format_string<char>, const T&...) = delete;
+        template <typename... T> bool printDeferred(LogLane, fmt::runtime_format_string<char>, const T&...) = delete;
+        /**
+         * @brief Wait until a message fits in a lane with half of the ring to spare, so a background task with a lot
+         * to write goes at the pace of the budget, and leaves room for everything else
+         *
+         * @param size length of the message, in bytes
+         * @param lane the lane it will be pushed to
+         */
+        void waitForRoom(std::size_t size, LogLane lane = LogLane::BULK);
+        /**
+         * @brief Set how often messages are written, in milliseconds. 50 by default, like lemlib::Buffer
+         */
+        void setRate(std::uint32_t rate);
+        /**
+         * @brief Set the most bytes written per second, not counting the priority lane. 0, the default, is no limit
+         */
+        void setBandwidth(std::uint32_t bytesPerSecond);
+        /**
+         * @brief Whether every message has been written
+         */
+        bool buffersEmpty() const;
+        /**
+         * @brief Get the number of messages dropped because a ring was full
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @brief Get the most bytes a lane's ring has held at once
+         */
+        std::uint32_t getHighWater(LogLane lane = LogLane::BULK) const;
+        /**
+         * @brief Get the bytes written per second, measured over the last second
+         */
+        std::uint32_t getThroughput() const;
+        /**
+         * @brief Get the fraction of the last second the task spent waiting on writes, from 0 to 1
+         */
+        float getWriteLoad() const;
+    private:
+        /** longest message, after the formatter at the start of each record in the ring */
+        static constexpr std::size_t MAX_MESSAGE = Ring::MAX_MESSAGE - sizeof(LogFormatter);
+        static_assert(BATCH_SIZE >= MAX_MESSAGE, "a message must fit in a batch");
+
+        /**
+         * @brief Push a record: the formatter, then its payload
+         */
+        bool push(LogLane lane, LogFormatter formatter, std::string_view payload);
+        /**
+         * @brief The function run inside the buffer's task
+         */
+        void taskLoop();
+        /**
+         * @brief Pop a message from a ring and format it onto the batch, writing the batch first if it is too full
+         *
+         * @return std::size_t length of the message, or 0 if the ring had none ready
+         */
+        std::size_t popToBatch(Ring& ring);
+        /**
+         * @brief Write the batch, and time how long it took
+         */
+        void flush();
+
+        Ring& getRing(LogLane lane) { return rings[static_cast<std::size_t>(lane)]; }
+
+        const Ring& getRing(LogLane lane) const { return rings[static_cast<std::size_t>(lane)]; }
+
+        std::function<void(std::string_view)> write;
+        std::atomic<std::uint32_t> rate = 50;
+        std::atomic<std::uint32_t> bandwidth = 0;
+        std::array<Ring, 2> rings;
+        std::atomic<std::uint32_t> throughput = 0;
+        std::atomic<float> writeLoad = 0;
+
+        // only used by the task
+        /** drops already reported, with REPORT_DROPPED */
+        std::uint32_t reportedDrops = 0;
+        /** the record popped from a ring */
+        char record[Ring::MAX_MESSAGE] = {};
+        /** messages waiting to be written together */
+        char batch[BATCH_SIZE] = {};
+        std::size_t batchLength = 0;
+        /** bytes written, and microseconds spent writing, since the start of the measurement window */
+        std::uint32_t windowBytes = 0;
+        std::uint64_t windowWriteTime = 0;
+        pros::Task* task = nullptr;
+};
+
+/**
+ * @brief Get a LogBuffer that writes to stdout, like lemlib::bufferedStdout. robotLog() writes to it
+ */
+LogBuffer& bufferedLog();
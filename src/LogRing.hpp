@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+
+/**
+ * @brief What a LogRing does with a message when it is full
+ */
+enum class OverflowPolicy {
+    /** drop the new message */
+    DROP_NEWEST,
+    /** drop the oldest messages to make room. If the oldest message is still being written, drop the new one */
+    DROP_OLDEST,
+    /** drop the new message, and report how many were dropped in the output once there is room */
+    REPORT_DROPPED
+};
+
+/**
+ * @brief A fixed size, lock-free ring of messages, for many producers and one consumer
+ *
+ * Producers reserve space with a compare and swap on the head, copy their message in, then publish its header.
+ * They never block and never allocate: if the ring is full, the overflow policy decides which message is dropped.
+ * The consumer reads published messages in order from the tail, and stops at the first one still being written.
+ *
+ * Each message is a header word followed by the bytes, padded to a word. The header holds the length, and a tag made
+ * from the lap of the ring the message was written on, so a header left over from an earlier lap is never mistaken
+ * for a published message. A message that would wrap around the end of the ring is preceded by padding instead.
+ *
+ * With DROP_OLDEST, a producer can drop a message while the consumer is copying it. The consumer only keeps a message
+ * if it was the one to move the tail past it, so a message overwritten while it was copied is thrown away.
+ *
+ * This doesn't depend on PROS.
+ *
+ * @tparam CAPACITY size of the ring in bytes. A power of 2
+ */
+template <std::size_t CAPACITY> class LogRing {
+    public:
+        static_assert(CAPACITY >= 64 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of 2");
+        static_assert(CAPACITY / 4 <= (1 << 17), "capacity is too large for the lap tags");
+
+        /** longest message that can be pushed, in bytes */
+        static constexpr std::size_t MAX_MESSAGE = std::min<std::size_t>(CAPACITY / 4, 0xFFFE);
+
+        /**
+         * @brief Construct a new LogRing
+         *
+         * @param policy what to do with a message when the ring is full
+         */
+        LogRing(OverflowPolicy policy = OverflowPolicy::DROP_NEWEST)
+            : policy(policy) {}
+
+        /**
+         * @brief Push a message. Never blocks
+         *
+         * @return true if the message was pushed, false if it was dropped
+         */
+        bool push(std::string_view message) { return push({message}); }
+
+        /**
+         * @brief Push a message made of several parts, without joining them first. Never blocks
+         *
+         * @return true if the message was pushed, false if it was dropped
+         */
+        bool push(std::initializer_list<std::string_view> parts) {
+            std::size_t length = 0;
+            for (std::string_view part : parts) length += part.size();
+            if (length > MAX_MESSAGE) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            const std::uint32_t size = 1 + (length + 3) / 4;
+            std::uint32_t start = head.load(std::memory_order_relaxed);
+            std::uint32_t padding;
+            std::uint32_t end;
+            while (true) {
+                // a message can't wrap around the end of the ring, so pad to the start instead
+                padding = start % WORDS + size > WORDS ? WORDS - start % WORDS : 0;
+                end = start + padding + size;
+                const std::uint32_t oldest = tail.load(std::memory_order_acquire);
+                if (end - oldest > WORDS) {
+                    if (policy == OverflowPolicy::DROP_OLDEST && dropOldest(oldest)) {
+                        start = head.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (head.compare_exchange_weak(start, end, std::memory_order_relaxed)) break;
+            }
+            if (padding != 0) publish(start, PADDING);
+            start += padding;
+            // the space between the header and the end of the ring is contiguous
+            char* bytes = reinterpret_cast<char*>(&words[(start + 1) % WORDS]);
+            for (std::string_view part : parts) {
+                std::memcpy(bytes, part.data(), part.size());
+                bytes += part.size();
+            }
+            publish(start, length);
+            // track the most the ring has held
+            const std::uint32_t used = end - tail.load(std::memory_order_relaxed);
+            // if the tail passed the end, this message was already dropped again
+            if (used > WORDS) return true;
+            std::uint32_t highest = highWater.load(std::memory_order_relaxed);
+            while (used * 4 > highest && !highWater.compare_exchange_weak(highest, used * 4, std::memory_order_relaxed));
+            return true;
+        }
+
+        /**
+         * @brief Pop the oldest message. Only one task may pop
+         *
+         * @param out buffer of at least MAX_MESSAGE bytes for the message
+         * @param length set to the length of the message
+         * @return true if a message was popped, false if there is no message ready
+         */
+        bool pop(char* out, std::size_t& length) {
+            while (true) {
+                const std::uint32_t oldest = tail.load(std::memory_order_acquire);
+                const std::uint32_t newest = head.load(std::memory_order_acquire);
+                if (oldest == newest) return false;
+                const std::uint32_t header = headerAt(oldest).load(std::memory_order_acquire);
+                const std::uint32_t size = sizeOf(oldest, newest, header);
+                if (size == 0) {
+                    // a producer dropped the message and is writing over its header, try the new tail
+                    if (tail.load(std::memory_order_acquire) != oldest) continue;
+                    // the message hasn't been published yet
+                    return false;
+                }
+                length = header & 0xFFFF;
+                if (length != PADDING) std::memcpy(out, &words[(oldest + 1) % WORDS], length);
+                // a producer may have dropped the message while it was copied, then it is garbage
+                std::uint32_t expected = oldest;
+                if (!tail.compare_exchange_strong(expected, oldest + size, std::memory_order_acq_rel)) continue;
+                if (length != PADDING) return true;
+            }
+        }
+
+        /**
+         * @brief Whether a message of a length would fit right now, if no other task pushes first
+         */
+        bool hasRoom(std::size_t length) const {
+            const std::uint32_t start = head.load(std::memory_order_relaxed);
+            const std::uint32_t size = 1 + (length + 3) / 4;
+            const std::uint32_t padding = start % WORDS + size > WORDS ? WORDS - start % WORDS : 0;
+            return start + padding + size - tail.load(std::memory_order_acquire) <= WORDS;
+        }
+
+        /**
+         * @brief Whether there are no messages in the ring
+         */
+        bool isEmpty() const { return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Get the number of messages dropped
+         */
+        std::uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the most bytes the ring has held at once, including headers and padding
+         */
+        std::uint32_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the overflow policy
+         */
+        OverflowPolicy getPolicy() const { return policy; }
+    private:
+        static constexpr std::uint32_t WORDS = CAPACITY / 4;
+        /** length of a header that pads to the end of the ring */
+        static constexpr std::uint32_t PADDING = 0xFFFF;
+
+        /**
+         * @brief Tag of a header written at a position. The top bit is set so an empty ring has no valid headers
+         */
+        static std::uint32_t tag(std::uint32_t position) { return 0x8000 | ((position / WORDS) & 0x7FFF); }
+
+        std::atomic_ref<std::uint32_t> headerAt(std::uint32_t position) {
+            return std::atomic_ref<std::uint32_t>(words[position % WORDS]);
+        }
+
+        void publish(std::uint32_t position, std::uint32_t length) {
+            headerAt(position).store(tag(position) << 16 | length, std::memory_order_release);
+        }
+
+        /**
+         * @brief Size in words of the message a header starts, including the header
+         *
+         * A header read while a producer overwrites it can't be trusted, even with the right tag, so its length must
+         * fit in a message and the message must end at or before the head.
+         *
+         * @param position where the header is
+         * @param newest the head, read before the header
+         * @return std::uint32_t the size, or 0 if the header isn't a published message
+         */
+        static std::uint32_t sizeOf(std::uint32_t position, std::uint32_t newest, std::uint32_t header) {
+            if (header >> 16 != tag(position)) return 0;
+            const std::uint32_t length = header & 0xFFFF;
+            if (length != PADDING && length > MAX_MESSAGE) return 0;
+            const std::uint32_t size = length == PADDING ? WORDS - position % WORDS : 1 + (length + 3) / 4;
+            return size <= newest - position ? size : 0;
+        }
+
+        /**
+         * @brief Drop the oldest message, if it has been published
+         *
+         * @return true if the tail moved, so there may be room now
+         */
+        bool dropOldest(std::uint32_t oldest) {
+            const std::uint32_t newest = head.load(std::memory_order_acquire);
+            const std::uint32_t header = headerAt(oldest).load(std::memory_order_acquire);
+            const std::uint32_t size = sizeOf(oldest, newest, header);
+            if (size == 0) return false;
+            if (tail.compare_exchange_strong(oldest, oldest + size, std::memory_order_acq_rel) &&
+                (header & 0xFFFF) != PADDING)
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const OverflowPolicy policy;
+        alignas(4) std::array<std::uint32_t, WORDS> words = {};
+        /** positions are in words, and only ever increase. The index in the ring is the position modulo WORDS */
+        std::atomic<std::uint32_t> head = 0;
+        std::atomic<std::uint32_t> tail = 0;
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> highWater = 0;
+};
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include "MotionProfile.hpp"
+
+ProfileConstraints ProfileConstraints::fromDrivetrain(const lemlib::Drivetrain& drivetrain, float accelTime,
+                                                      float jerkTime) {
+    const float maxVel = drivetrain.rpm / 60 * drivetrain.wheelDiameter * M_PI;
+    const float maxAccel = maxVel / accelTime;
+    return {.maxVel = maxVel, .maxAccel = maxAccel, .maxJerk = jerkTime > 0 ? maxAccel / jerkTime : 0};
+}
+
+float Feedforward::calculate(float velocity, float acceleration) const {
+    const float staticFriction = velocity > 0 ? kS : velocity < 0 ? -kS : 0;
+    return staticFriction + kV * velocity + kA * acceleration;
+}
+
+MotionProfile::State MotionProfile::Ramp::sample(float t) const {
+    const float sign = endVel >= startVel ? 1 : -1;
+    const float accel = std::fabs(peakAccel);
+    const float jerk = jerkTime > 0 ? accel / jerkTime : 0;
+    t = std::clamp(t, 0.0f, duration());
+    // jerk phase, acceleration is building up
+    if (t < jerkTime) {
+        return {.position = startVel * t + sign * jerk * t * t * t / 6,
+                .velocity = startVel + sign * jerk * t * t / 2,
+                .acceleration = sign * jerk * t};
+    }
+    const float vel1 = startVel + sign * accel * jerkTime / 2;
+    const float pos1 = startVel * jerkTime + sign * accel * jerkTime * jerkTime / 6;
+    // constant acceleration phase
+    t -= jerkTime;
+    if (t < accelTime) {
+        return {.position = pos1 + vel1 * t + sign * accel * t * t / 2,
+                .velocity = vel1 + sign * accel * t,
+                .acceleration = sign * accel};
+    }
+    const float vel2 = vel1 + sign * accel * accelTime;
+    const float pos2 = pos1 + vel1 * accelTime + sign * accel * accelTime * accelTime / 2;
+    // jerk phase, acceleration is going back to 0
+    t -= accelTime;
+    return {.position = pos2 + vel2 * t + sign * (accel * t * t / 2 - jerk * t * t * t / 6),
+            .velocity = vel2 + sign * (accel * t - jerk * t * t / 2),
+            .acceleration = sign * (accel - jerk * t)};
+}
+
+MotionProfile::Ramp MotionProfile::makeRamp(float startVel, float endVel) const {
+    Ramp ramp {.startVel = startVel, .endVel = endVel};
+    const float deltaVel = std::fabs(endVel - startVel);
+    if (deltaVel == 0) return ramp;
+    const float sign = endVel > startVel ? 1 : -1;
+    const float accel = constraints.maxAccel;
+    const float jerk = constraints.maxJerk;
+    if (jerk <= 0) { // trapezoidal
+        ramp.accelTime = deltaVel / accel;
+        ramp.peakAccel = sign * accel;
+    } else if (deltaVel >= accel * accel / jerk) { // reaches max acceleration
+        ramp.jerkTime = accel / jerk;
+        ramp.accelTime = deltaVel / accel - accel / jerk;
+        ramp.peakAccel = sign * accel;
+    } else { // never reaches max acceleration
+        ramp.jerkTime = std::sqrt(deltaVel / jerk);
+        ramp.peakAccel = sign * jerk * ramp.jerkTime;
+    }
+    return ramp;
+}
+
+MotionProfile::MotionProfile(float distance, ProfileConstraints constraints, float startVel, float endVel)
+    : constraints(constraints) {
+    distance = std::max(distance, 0.0f);
+    startVel = std::clamp(startVel, 0.0f, constraints.maxVel);
+    endVel = std::clamp(endVel, 0.0f, constraints.maxVel);
+    constexpr int ITERATIONS = 30;
+
+    // even without cruising, the end velocity can't be reached. Find the closest one that can
+    const float minPeak = std::max(startVel, endVel);
+    if (makeRamp(startVel, minPeak).distance() + makeRamp(minPeak, endVel).distance() > distance) {
+        float reachable = startVel;
+        float unreachable = endVel;
+        for (int i = 0; i < ITERATIONS; i++) {
+            const float mid = (reachable + unreachable) / 2;
+            if (makeRamp(startVel, mid).distance() <= distance) reachable = mid;
+            else unreachable = mid;
+        }
+        endVel = reachable;
+        accel = makeRamp(startVel, std::max(startVel, endVel));
+        decel = makeRamp(std::max(startVel, endVel), endVel);
+        this->distance = accel.distance() + decel.distance();
+        return;
+    }
+
+    // find the highest peak velocity that fits in the distance
+    float peakVel = constraints.maxVel;
+    auto rampDistance = [&](float peak) { return makeRamp(startVel, peak).distance() + makeRamp(peak, endVel).distance(); };
+    if (rampDistance(peakVel) > distance) {
+        float low = minPeak;
+        float high = constraints.maxVel;
+        for (int i = 0; i < ITERATIONS; i++) {
+            const float mid = (low + high) / 2;
+            if (rampDistance(mid) <= distance) low = mid;
+            else high = mid;
+        }
+        peakVel = low;
+    }
+    accel = makeRamp(startVel, peakVel);
+    decel = makeRamp(peakVel, endVel);
+    // cruise for whatever distance is left
+    if (peakVel > 0) cruiseTime = std::max(distance - accel.distance() - decel.distance(), 0.0f) / peakVel;
+    this->distance = accel.distance() + peakVel * cruiseTime + decel.distance();
+}
+
+MotionProfile::State MotionProfile::sample(float t) const {
+    if (t < accel.duration()) return accel.sample(t);
+    t -= accel.duration();
+    const float accelDistance = accel.distance();
+    if (t < cruiseTime) return {.position = accelDistance + accel.endVel * t, .velocity = accel.endVel};
+    t -= cruiseTime;
+    State state = decel.sample(t);
+    state.position += accelDistance + accel.endVel * cruiseTime;
+    if (t >= decel.duration()) state.acceleration = 0;
+    return state;
+}
+
+float MotionProfile::getDuration() const { return accel.duration() + cruiseTime + decel.duration(); }
+
+float MotionProfile::getDistance() const { return distance; }
+
+float MotionProfile::getEndVelocity() const { return decel.endVel; }
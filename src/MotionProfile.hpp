@@ -0,0 +1,151 @@
+#pragma once
+
+#include "lemlib/chassis/chassis.hpp"
+
+/**
+ * @brief Limits of a motion profile
+ *
+ * Units are inches and seconds. A maxJerk of 0 generates a trapezoidal profile, anything else an S-curve.
+ */
+struct ProfileConstraints {
+        /** maximum velocity, in inches per second */
+        float maxVel;
+        /** maximum acceleration, in inches per second squared */
+        float maxAccel;
+        /** maximum jerk, in inches per second cubed. 0 for a trapezoidal profile */
+        float maxJerk = 0;
+
+        /**
+         * @brief Derive profile constraints from a drivetrain
+         *
+         * The maximum velocity is the free speed of the wheels. The acceleration and jerk limits are set so that the
+         * robot takes accelTime to reach full speed, and jerkTime to reach full acceleration.
+         *
+         * @param drivetrain the drivetrain
+         * @param accelTime time to accelerate from 0 to full speed, in seconds. 0.5 by default
+         * @param jerkTime time to reach full acceleration, in seconds. 0 for a trapezoidal profile. 0.1 by default
+         * @return ProfileConstraints
+         *
+         * @b Example
+         * @code {.cpp}
+         * // 360rpm on 3.25" wheels is 61.3 in/s, reached in 0.5s
+         * ProfileConstraints constraints = ProfileConstraints::fromDrivetrain(drivetrain);
+         * @endcode
+         */
+        static ProfileConstraints fromDrivetrain(const lemlib::Drivetrain& drivetrain, float accelTime = 0.5,
+                                                 float jerkTime = 0.1);
+};
+
+/**
+ * @brief Voltage feedforward gains
+ *
+ * Outputs are in the same -127 to 127 units as pros::Motor::move
+ */
+struct Feedforward {
+        /** output needed to overcome static friction */
+        float kS = 0;
+        /** output per inch per second of velocity */
+        float kV = 0;
+        /** output per inch per second squared of acceleration */
+        float kA = 0;
+
+        /**
+         * @brief Calculate the feedforward output
+         *
+         * @param velocity target velocity, in inches per second
+         * @param acceleration target acceleration, in inches per second squared
+         * @return float
+         */
+        float calculate(float velocity, float acceleration) const;
+};
+
+/**
+ * @brief A time-optimal 1D motion profile, trapezoidal or S-curve
+ *
+ * The profile accelerates from the start velocity to the highest velocity it can reach, cruises, then decelerates to
+ * the end velocity, respecting the velocity, acceleration and jerk limits. Profiles are generated in constant time
+ * and never allocate, so they can be generated at the start of a motion.
+ *
+ * @b Example
+ * @code {.cpp}
+ * MotionProfile profile(48, {.maxVel = 60, .maxAccel = 120, .maxJerk = 1200});
+ * for (float t = 0; t < profile.getDuration(); t += 0.01) {
+ *     MotionProfile::State state = profile.sample(t);
+ *     printf("%f %f %f\n", state.position, state.velocity, state.acceleration);
+ * }
+ * @endcode
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief A point on the profile
+         */
+        struct State {
+                float position = 0;
+                float velocity = 0;
+                float acceleration = 0;
+        };
+
+        /**
+         * @brief Generate a new motion profile
+         *
+         * If the end velocity can't be reached in the given distance, the profile ends at the closest velocity it can
+         * reach instead
+         *
+         * @param distance distance to travel, in inches. Must not be negative
+         * @param constraints velocity, acceleration and jerk limits
+         * @param startVel velocity at the start of the profile, in inches per second. 0 by default
+         * @param endVel velocity at the end of the profile, in inches per second. 0 by default
+         */
+        MotionProfile(float distance, ProfileConstraints constraints, float startVel = 0, float endVel = 0);
+        /**
+         * @brief Get the state of the profile at a given time. Times past the end return the final state
+         *
+         * @param t time since the start of the profile, in seconds
+         */
+        State sample(float t) const;
+        /**
+         * @brief Get the total duration of the profile, in seconds
+         */
+        float getDuration() const;
+        /**
+         * @brief Get the distance the profile travels, in inches
+         */
+        float getDistance() const;
+        /**
+         * @brief Get the velocity at the end of the profile, in inches per second
+         */
+        float getEndVelocity() const;
+    private:
+        /**
+         * @brief A jerk-limited change of velocity
+         *
+         * Jerk is applied for jerkTime, then acceleration is held for accelTime, then jerk is applied the other way
+         * for jerkTime
+         */
+        struct Ramp {
+                float startVel = 0;
+                float endVel = 0;
+                float jerkTime = 0;
+                float accelTime = 0;
+                /** signed peak acceleration */
+                float peakAccel = 0;
+
+                float duration() const { return 2 * jerkTime + accelTime; }
+
+                float distance() const { return (startVel + endVel) / 2 * duration(); }
+
+                State sample(float t) const;
+        };
+
+        /**
+         * @brief Make the fastest ramp between two velocities
+         */
+        Ramp makeRamp(float startVel, float endVel) const;
+
+        ProfileConstraints constraints;
+        Ramp accel;
+        Ramp decel;
+        float cruiseTime = 0;
+        float distance;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * The recording format written by MotionRecorder, shared by the robot and the host decoder. This doesn't depend on
+ * PROS.
+ *
+ * A recording is a MotionRecordHeader followed by its samples, for each motion. On the SD card, recordings are
+ * appended to one file. Over serial, each recording is the base64 of the same bytes, split into lines of at most 256
+ * characters: the first line starts with "MREC ", and the rest with "MREC+ ". Other output can come between the lines.
+ */
+
+/**
+ * @brief One control tick of a motion
+ *
+ * Written to the output as is, so the layout is fixed: little endian, no padding. Poses are in inches and degrees,
+ * like chassis.getPose(), and voltages are in millivolts.
+ */
+struct MotionSample {
+        /** bits of flags */
+        enum Flag : std::uint16_t {
+            LATERAL_SMALL_EXIT = 1 << 0,
+            LATERAL_LARGE_EXIT = 1 << 1,
+            ANGULAR_SMALL_EXIT = 1 << 2,
+            ANGULAR_LARGE_EXIT = 1 << 3,
+            /** the robot is close to the target, and settling */
+            CLOSE = 1 << 4,
+            /** a turn has passed the target once, and is settling */
+            SETTLING = 1 << 5
+        };
+
+        /** microseconds since the motion started */
+        std::uint32_t time;
+        float targetX;
+        float targetY;
+        float targetTheta;
+        float x;
+        float y;
+        float theta;
+        /** inches */
+        float lateralError;
+        /** degrees */
+        float angularError;
+        float lateralP;
+        float lateralI;
+        float lateralD;
+        float angularP;
+        float angularI;
+        float angularD;
+        std::int16_t leftCommand;
+        std::int16_t rightCommand;
+        /** mean voltage of the motors on each side */
+        std::int16_t leftVoltage;
+        std::int16_t rightVoltage;
+        std::uint16_t flags;
+        std::uint16_t reserved;
+};
+
+static_assert(sizeof(MotionSample) == 72, "MotionSample must not have padding");
+
+/**
+ * @brief Written before the samples of each motion
+ */
+struct MotionRecordHeader {
+        /** "MREC" */
+        static constexpr std::uint32_t MAGIC = 0x4345524D;
+        static constexpr std::uint16_t VERSION = 1;
+
+        std::uint32_t magic = MAGIC;
+        std::uint16_t version = VERSION;
+        /** size of each sample, in bytes */
+        std::uint16_t sampleSize = sizeof(MotionSample);
+        /** number of motions recorded before this one */
+        std::uint32_t index = 0;
+        /** the type of motion, RobotChassis::Motion::Type */
+        std::uint32_t type = 0;
+        /** milliseconds since the program started */
+        std::uint32_t startTime = 0;
+        /** number of samples following the header */
+        std::uint32_t count = 0;
+        /** number of samples at the start of the motion that were overwritten before they could be written */
+        std::uint32_t dropped = 0;
+};
+
+static_assert(sizeof(MotionRecordHeader) == 28, "MotionRecordHeader must not have padding");
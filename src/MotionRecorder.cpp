@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstdio>
+#include "pros/misc.hpp"
+#include "LogBuffer.hpp"
+#include "RobotLog.hpp"
+#include "MotionRecorder.hpp"
+
+MotionRecorder::MotionRecorder(const char* path)
+    : path(path) {}
+
+void MotionRecorder::setOutput(Output output) {
+    this->output = output;
+    if (output == Output::NONE || writerTask != nullptr) return;
+    // below the control loops, writing to the SD card can take a while
+    writerTask = new pros::Task([this] { writerLoop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT,
+                                "Motion Recorder");
+}
+
+void MotionRecorder::begin(std::uint32_t type) {
+    motionStart = head.load(std::memory_order_relaxed);
+    motionStartTime = pros::millis();
+    motionStartMicros = pros::micros();
+    motionType = type;
+}
+
+void MotionRecorder::record(MotionSample sample) {
+    const std::uint32_t sequence = head.load(std::memory_order_relaxed);
+    sample.time = pros::micros() - motionStartMicros;
+    ring[sequence % CAPACITY] = sample;
+    // publish the sample after it has been written
+    head.store(sequence + 1, std::memory_order_release);
+}
+
+void MotionRecorder::end() {
+    const std::uint32_t index = motionCount++;
+    if (output == Output::NONE || writerTask == nullptr) return;
+    const std::uint32_t tail = pendingTail.load(std::memory_order_acquire);
+    const std::uint32_t pendingIndex = pendingHead.load(std::memory_order_relaxed);
+    if (pendingIndex - tail >= MAX_PENDING) {
+        droppedMotions++;
+        return;
+    }
+    MotionRecordHeader header;
+    header.index = index;
+    header.type = motionType;
+    header.startTime = motionStartTime;
+    header.count = head.load(std::memory_order_relaxed) - motionStart;
+    pending[pendingIndex % MAX_PENDING] = {.header = header, .start = motionStart};
+    pendingHead.store(pendingIndex + 1, std::memory_order_release);
+    writerTask->notify();
+}
+
+std::uint32_t MotionRecorder::getDroppedMotions() const { return droppedMotions; }
+
+std::uint32_t MotionRecorder::getWrittenMotions() const { return writtenMotions; }
+
+bool MotionRecorder::isWriting() const { return writtenMotions != pendingHead.load(std::memory_order_acquire); }
+
+void MotionRecorder::writerLoop() {
+    while (true) {
+        pros::Task::notify_take(true, TIMEOUT_MAX);
+        std::uint32_t tail = pendingTail.load(std::memory_order_relaxed);
+        while (tail != pendingHead.load(std::memory_order_acquire)) {
+            const Pending motion = pending[tail % MAX_PENDING];
+            pendingTail.store(++tail, std::memory_order_release);
+            write(motion);
+            writtenMotions++;
+        }
+    }
+}
+
+/**
+ * @brief Encodes a stream of bytes as base64 lines, and pushes them to bufferedLog()
+ *
+ * Each line is a whole message of the buffer, so other output can only come between lines, never inside one
+ */
+class Base64Writer {
+    public:
+        void write(const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const std::uint8_t*>(data);
+            for (std::size_t i = 0; i < size; i++) {
+                group[groupSize++] = bytes[i];
+                if (groupSize == 3) flushGroup();
+            }
+        }
+
+        void finish() {
+            if (groupSize != 0) flushGroup();
+            if (lineSize != 0) flushLine();
+        }
+    private:
+        void flushGroup() {
+            static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            if (lineSize == 0) {
+                // the first line starts the recording, the rest continue it
+                const std::string_view prefix = first ? "MREC " : "MREC+ ";
+                std::copy(prefix.begin(), prefix.end(), line);
+                lineSize = prefix.size();
+                first = false;
+            }
+            const std::uint32_t bits = group[0] << 16 | group[1] << 8 | group[2];
+            for (std::size_t i = 0; i < 4; i++)
+                line[lineSize++] = i <= groupSize ? ALPHABET[(bits >> (18 - 6 * i)) & 0x3F] : '=';
+            group = {};
+            groupSize = 0;
+            if (lineSize >= LINE_LENGTH) flushLine();
+        }
+
+        void flushLine() {
+            line[lineSize++] = '\n';
+            // a recording is a lot of output, wait for the budget instead of dropping its lines
+            bufferedLog().waitForRoom(lineSize);
+            bufferedLog().pushToBuffer(std::string_view(line, lineSize));
+            lineSize = 0;
+        }
+
+        /** characters of base64 before a line is pushed, 192 bytes of the recording */
+        static constexpr std::size_t LINE_LENGTH = 256;
+
+        std::array<std::uint8_t, 3> group = {};
+        std::size_t groupSize = 0;
+        bool first = true;
+        char line[8 + LINE_LENGTH] = {};
+        std::size_t lineSize = 0;
+};
+
+void MotionRecorder::write(Pending motion) {
+    // samples a ring or more behind the head have been overwritten by later ones. The one exactly a ring behind
+    // shares its slot with the head, which the motion task may be writing
+    const std::uint32_t end = motion.start + motion.header.count;
+    std::uint32_t first = motion.start;
+    std::uint32_t headNow = head.load(std::memory_order_acquire);
+    if (headNow - first >= CAPACITY) first = headNow - CAPACITY + 1;
+    if (first - motion.start > motion.header.count) first = end;
+    for (std::uint32_t sequence = first; sequence != end; sequence++)
+        copy[sequence - first] = ring[sequence % CAPACITY];
+    // the motion task kept recording while copying, drop anything it overwrote. The fence keeps the copy from being
+    // read after the head
+    std::atomic_thread_fence(std::memory_order_acquire);
+    headNow = head.load(std::memory_order_relaxed);
+    std::size_t offset = 0;
+    if (headNow - first >= CAPACITY) {
+        offset = std::min<std::uint32_t>(headNow - CAPACITY + 1 - first, end - first);
+        first += offset;
+    }
+    motion.header.dropped = first - motion.start;
+    motion.header.count = end - first;
+
+    if (output == Output::SERIAL) {
+        Base64Writer writer;
+        writer.write(&motion.header, sizeof(motion.header));
+        writer.write(&copy[offset], motion.header.count * sizeof(MotionSample));
+        writer.finish();
+        return;
+    }
+    if (output != Output::SD) return;
+    if (!pros::usd::is_installed()) {
+        robotLog().warn("Can't write motion {}, there is no SD card", motion.header.index);
+        return;
+    }
+    FILE* file = std::fopen(path, "ab");
+    if (file == nullptr) {
+        robotLog().error("Can't open {} to write motion {}", path, motion.header.index);
+        return;
+    }
+    std::fwrite(&motion.header, sizeof(motion.header), 1, file);
+    std::fwrite(&copy[offset], sizeof(MotionSample), motion.header.count, file);
+    std::fclose(file);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "pros/rtos.hpp"
+#include "MotionRecordFormat.hpp"
+
+/**
+ * @brief Records every control tick of every motion, and writes them out after each motion ends
+ *
+ * The motion task writes samples into a fixed size ring buffer, which costs a copy per tick and never blocks or
+ * allocates. When a motion ends, a writer task copies its samples out of the ring and writes them, with a header,
+ * to a file on the SD card or as base64 lines over serial. If a motion is longer than the ring, only its latest
+ * samples are kept.
+ *
+ * Over serial, a recording is the base64 of exactly what would have been written to the file, in lines pushed to
+ * bufferedLog(), so it shares the bandwidth budget with the rest of the output. The writer task waits for room in the
+ * buffer instead of dropping lines. Decode them with tools/mrec_decode --serial.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     chassis.calibrate();
+ *     // append every motion to /usd/motions.bin
+ *     chassis.getRecorder().setOutput(MotionRecorder::Output::SD);
+ * }
+ * @endcode
+ */
+class MotionRecorder {
+    public:
+        /** number of samples the ring holds. 20 seconds of motion */
+        static constexpr std::size_t CAPACITY = 2048;
+        /** number of finished motions that can wait to be written */
+        static constexpr std::size_t MAX_PENDING = 8;
+
+        /**
+         * @brief Where recordings are written
+         */
+        enum class Output { NONE, SD, SERIAL };
+
+        /**
+         * @brief Construct a new MotionRecorder. Nothing is written until setOutput is called
+         *
+         * @param path file the recordings are appended to when writing to the SD card
+         */
+        MotionRecorder(const char* path = "/usd/motions.bin");
+        /**
+         * @brief Set where recordings are written. Starts the writer task the first time
+         */
+        void setOutput(Output output);
+        /**
+         * @brief Start recording a motion. Called by the motion task
+         *
+         * @param type the type of motion
+         */
+        void begin(std::uint32_t type);
+        /**
+         * @brief Record a tick of the current motion. Called by the motion task
+         *
+         * @param sample the sample. Its time is filled in
+         */
+        void record(MotionSample sample);
+        /**
+         * @brief Finish recording the current motion, and hand it to the writer task. Called by the motion task
+         */
+        void end();
+        /**
+         * @brief Get the number of motions that weren't written because too many were waiting
+         */
+        std::uint32_t getDroppedMotions() const;
+        /**
+         * @brief Get the number of motions written
+         */
+        std::uint32_t getWrittenMotions() const;
+        /**
+         * @brief Whether finished motions are still waiting to be written, or being written
+         */
+        bool isWriting() const;
+    private:
+        /**
+         * @brief A finished motion waiting to be written
+         */
+        struct Pending {
+                MotionRecordHeader header;
+                /** sequence number of the first sample */
+                std::uint32_t start = 0;
+        };
+
+        /**
+         * @brief The function run inside the writer task
+         */
+        void writerLoop();
+        /**
+         * @brief Copy a motion out of the ring and write it
+         */
+        void write(Pending pending);
+
+        const char* path;
+        std::atomic<Output> output = Output::NONE;
+        pros::Task* writerTask = nullptr;
+
+        std::array<MotionSample, CAPACITY> ring = {};
+        /** sequence number of the next sample. The ring index is this modulo CAPACITY */
+        std::atomic<std::uint32_t> head = 0;
+
+        std::uint32_t motionCount = 0;
+        std::uint32_t motionStart = 0;
+        std::uint32_t motionStartTime = 0;
+        std::uint64_t motionStartMicros = 0;
+        std::uint32_t motionType = 0;
+
+        std::array<Pending, MAX_PENDING> pending = {};
+        std::atomic<std::uint32_t> pendingHead = 0;
+        std::atomic<std::uint32_t> pendingTail = 0;
+        std::atomic<std::uint32_t> droppedMotions = 0;
+        /** motions handed to the writer task that it has finished writing */
+        std::atomic<std::uint32_t> writtenMotions = 0;
+
+        /** samples copied out of the ring by the writer task, so the ring can keep filling while they're written */
+        std::array<MotionSample, CAPACITY> copy = {};
+};
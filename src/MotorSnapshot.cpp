@@ -0,0 +1,28 @@
+#include <algorithm>
+#include "pros/error.h"
+#include "pros/motors.h"
+#include "pros/rtos.hpp"
+#include "MotorSnapshot.hpp"
+
+void snapshot(const pros::AbstractMotor& motors, MotorSnapshot& out, std::uint32_t fields) {
+    out.size = std::min<int>(motors.size(), MotorSnapshot::MAX_MOTORS);
+    out.time = pros::millis();
+    out.valid = 0;
+    for (int i = 0; i < out.size; i++) {
+        // the c api takes signed ports, so reversed motors are handled by the port itself
+        const std::int8_t port = motors.get_port(i);
+        const std::int32_t rawPosition = pros::c::motor_get_raw_position(port, &out.rawTimestamp[i]);
+        if (rawPosition == PROS_ERR) continue; // disconnected or not a motor
+        out.rawPosition[i] = rawPosition;
+        if (fields & MotorSnapshot::POSITION) out.position[i] = pros::c::motor_get_position(port);
+        if (fields & MotorSnapshot::VELOCITY) out.velocity[i] = pros::c::motor_get_actual_velocity(port);
+        if (fields & MotorSnapshot::CURRENT) out.current[i] = pros::c::motor_get_current_draw(port);
+        if (fields & MotorSnapshot::VOLTAGE) out.voltage[i] = pros::c::motor_get_voltage(port);
+        if (fields & MotorSnapshot::TEMPERATURE) out.temperature[i] = pros::c::motor_get_temperature(port);
+        if (fields & MotorSnapshot::TORQUE) out.torque[i] = pros::c::motor_get_torque(port);
+        if (fields & MotorSnapshot::POWER) out.power[i] = pros::c::motor_get_power(port);
+        if (fields & MotorSnapshot::EFFICIENCY) out.efficiency[i] = pros::c::motor_get_efficiency(port);
+        if (fields & MotorSnapshot::FAULTS) out.faults[i] = pros::c::motor_get_faults(port);
+        out.valid |= 1u << i;
+    }
+}
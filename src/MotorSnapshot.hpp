@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "pros/abstract_motor.hpp"
+
+/**
+ * @brief All the telemetry of a motor or motor group, read in a single pass
+ *
+ * Every get_*_all method of pros::MotorGroup returns a new std::vector, so a control loop polling position, velocity,
+ * current and temperature of a group allocates four times per tick. A snapshot is a fixed size struct of arrays that
+ * is owned by the caller and filled in place, so reading it never allocates.
+ *
+ * Values are in the same units as the matching pros::MotorGroup getter. A motor that could not be read has its bit
+ * cleared in the valid mask, and its values are left at whatever they were. A loop that only needs some of the values
+ * can read just those fields, the others are left at whatever they were too.
+ *
+ * @b Example
+ * @code {.cpp}
+ * MotorSnapshot left; // declare once, outside the control loop
+ * while (true) {
+ *     snapshot(leftmotors, left);
+ *     for (int i = 0; i < left.size; i++) printf("motor %d: %f rpm\n", i, left.velocity[i]);
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+struct MotorSnapshot {
+        /** the maximum number of motors a snapshot can hold. Extra motors in a group are ignored */
+        static constexpr int MAX_MOTORS = 8;
+
+        /**
+         * @brief The values to read. The raw position is always read, it's how a disconnected motor is found
+         */
+        enum Field : std::uint32_t {
+            POSITION = 1 << 0,
+            VELOCITY = 1 << 1,
+            CURRENT = 1 << 2,
+            VOLTAGE = 1 << 3,
+            TEMPERATURE = 1 << 4,
+            TORQUE = 1 << 5,
+            POWER = 1 << 6,
+            EFFICIENCY = 1 << 7,
+            FAULTS = 1 << 8,
+            RAW_POSITION = 0,
+            ALL = 0xFFFFFFFF
+        };
+
+        /** number of motors in the snapshot */
+        int size = 0;
+        /** time the snapshot was taken, in milliseconds */
+        std::uint32_t time = 0;
+        /** bit i is set if motor i was read successfully */
+        std::uint32_t valid = 0;
+
+        /** position, in the motor's encoder units */
+        std::array<double, MAX_MOTORS> position {};
+        /** raw encoder count */
+        std::array<std::int32_t, MAX_MOTORS> rawPosition {};
+        /** time the raw encoder count was sampled at by the motor, in milliseconds */
+        std::array<std::uint32_t, MAX_MOTORS> rawTimestamp {};
+        /** velocity, in rpm */
+        std::array<double, MAX_MOTORS> velocity {};
+        /** current draw, in mA */
+        std::array<std::int32_t, MAX_MOTORS> current {};
+        /** voltage, in mV */
+        std::array<std::int32_t, MAX_MOTORS> voltage {};
+        /** temperature, in degrees Celsius */
+        std::array<double, MAX_MOTORS> temperature {};
+        /** torque, in Nm */
+        std::array<double, MAX_MOTORS> torque {};
+        /** power, in W */
+        std::array<double, MAX_MOTORS> power {};
+        /** efficiency, in percent */
+        std::array<double, MAX_MOTORS> efficiency {};
+        /** fault flags, see pros::motor_fault_e_t */
+        std::array<std::uint32_t, MAX_MOTORS> faults {};
+
+        /**
+         * @brief whether motor i was read successfully
+         */
+        bool isValid(int i) const { return valid & (1u << i); }
+};
+
+/**
+ * @brief Read the telemetry of a motor or motor group into a snapshot, without allocating
+ *
+ * @param motors the motor or motor group to read
+ * @param out the snapshot to fill
+ * @param fields which values to read, a mask of MotorSnapshot::Field. All of them by default
+ */
+void snapshot(const pros::AbstractMotor& motors, MotorSnapshot& out, std::uint32_t fields = MotorSnapshot::ALL);
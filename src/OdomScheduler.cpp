@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include "CpuProfiler.hpp"
+#include "LogBuffer.hpp"
+#include "OdomScheduler.hpp"
+
+OdomScheduler::OdomScheduler(std::uint32_t period, std::uint32_t priority, std::function<void()> update)
+    : period(std::max<std::uint32_t>(period, 1)),
+      priority(priority),
+      update(std::move(update)) {
+    stats.period = this->period;
+}
+
+void OdomScheduler::start() {
+    if (task != nullptr) return;
+    // create the log buffer now, not on the first overrun in the loop
+    bufferedLog();
+    task = new pros::Task([this] { taskLoop(); }, priority, TASK_STACK_DEPTH_DEFAULT, "Odom Scheduler");
+}
+
+void OdomScheduler::setPeriod(std::uint32_t period) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    this->period = std::max<std::uint32_t>(period, 1);
+    periodChanged = true;
+}
+
+void OdomScheduler::setUpdate(std::function<void()> update) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    pendingUpdate = std::move(update);
+    updateChanged = true;
+}
+
+std::uint32_t OdomScheduler::getPeriod() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return period;
+}
+
+OdomTimingStats OdomScheduler::getStats() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return stats;
+}
+
+void OdomScheduler::resetStats() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    stats = OdomTimingStats();
+    stats.period = period;
+    jitterSum = 0;
+}
+
+bool OdomScheduler::isRunning() const { return task != nullptr; }
+
+std::uint32_t OdomScheduler::getAllocatingTicks() const { return allocationCheck.getFailedTicks(); }
+
+void OdomScheduler::taskLoop() {
+    std::uint32_t currentPeriod = getPeriod();
+    std::uint32_t prevTime = pros::millis();
+    // when the last tick woke up, or 0 if the next interval shouldn't be measured
+    std::uint64_t prevWakeTime = 0;
+    // whether the last tick overran too, so a run of overruns is only logged once
+    bool overrunning = false;
+    while (true) {
+        // prevTime is advanced to the tick we were scheduled to wake up at
+        pros::Task::delay_until(&prevTime, currentPeriod);
+        // the microsecond timer and the millisecond tick count don't share an epoch, so the jitter is measured between
+        // consecutive wake ups, on the microsecond timer alone
+        const std::uint64_t wakeTime = pros::micros();
+        const bool measured = prevWakeTime != 0;
+        const std::int64_t interval = std::int64_t(wakeTime - prevWakeTime);
+        const std::uint32_t jitter = measured ? std::llabs(interval - std::int64_t(currentPeriod) * 1000) : 0;
+        prevWakeTime = wakeTime;
+
+        allocationCheck.beginTick();
+        {
+            CPU_ZONE("odom update");
+            update();
+        }
+        allocationCheck.endTick();
+
+        const std::uint32_t execTime = pros::micros() - wakeTime;
+        // if the next tick is already due, we overran. Resynchronize instead of running a burst of late ticks
+        const bool overrun = pros::millis() >= prevTime + currentPeriod;
+        if (overrun) {
+            prevTime = pros::millis();
+            // the overrun is counted, the wait after it isn't jitter
+            prevWakeTime = 0;
+            // formatted later by the log task, this tick is already late
+            if (!overrunning)
+                bufferedLog().printDeferred(LogLane::PRIORITY,
+                                            "[WARN] Odometry overran its {} ms period, taking {} us\n", currentPeriod,
+                                            execTime);
+        }
+        overrunning = overrun;
+
+        std::lock_guard<pros::Mutex> lock(mutex);
+        // moved, not copied, so switching doesn't allocate in the loop
+        if (updateChanged) {
+            update = std::move(pendingUpdate);
+            updateChanged = false;
+        }
+        if (periodChanged) {
+            currentPeriod = period;
+            periodChanged = false;
+            stats = OdomTimingStats();
+            stats.period = currentPeriod;
+            jitterSum = 0;
+            prevWakeTime = 0;
+            continue;
+        }
+        stats.ticks++;
+        if (overrun) stats.overruns++;
+        stats.lastExecTime = execTime;
+        stats.worstExecTime = std::max(stats.worstExecTime, execTime);
+        if (!measured) continue;
+        stats.measuredTicks++;
+        stats.lastJitter = jitter;
+        stats.maxJitter = std::max(stats.maxJitter, jitter);
+        jitterSum += jitter;
+        stats.meanJitter = float(jitterSum) / stats.measuredTicks;
+        if (jitter < 100) stats.jitterHistogram[0]++;
+        else if (jitter < 250) stats.jitterHistogram[1]++;
+        else if (jitter < 500) stats.jitterHistogram[2]++;
+        else if (jitter < 1000) stats.jitterHistogram[3]++;
+        else if (jitter < 2000) stats.jitterHistogram[4]++;
+        else stats.jitterHistogram[5]++;
+    }
+}
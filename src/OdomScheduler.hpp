@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "AllocationCheck.hpp"
+
+/**
+ * @brief Timing statistics of the odometry task
+ *
+ * All times are in microseconds unless stated otherwise. Jitter is how far the time between two consecutive wake ups
+ * was from the period. It isn't measured on the first tick, or on the tick after an overrun.
+ */
+struct OdomTimingStats {
+        /** the period the task is scheduled at, in milliseconds */
+        std::uint32_t period = 0;
+        /** number of ticks run since the stats were last reset */
+        std::uint32_t ticks = 0;
+        /** number of ticks the jitter was measured on */
+        std::uint32_t measuredTicks = 0;
+        /** number of ticks that finished after the next tick was already due */
+        std::uint32_t overruns = 0;
+        /** jitter of the latest tick */
+        std::uint32_t lastJitter = 0;
+        /** largest jitter seen */
+        std::uint32_t maxJitter = 0;
+        /** mean jitter over the measured ticks */
+        float meanJitter = 0;
+        /** execution time of the odometry update on the latest tick */
+        std::uint32_t lastExecTime = 0;
+        /** worst case execution time of the odometry update */
+        std::uint32_t worstExecTime = 0;
+        /** jitter histogram. Buckets are <100, <250, <500, <1000, <2000 and >=2000 microseconds */
+        std::array<std::uint32_t, 6> jitterHistogram {};
+};
+
+/**
+ * @brief Runs odometry at a fixed rate
+ *
+ * LemLib's own tracking task sleeps for 10ms after every call to lemlib::update(), so its real period stretches by
+ * however long the update took and however long it was preempted for. This scheduler instead wakes on an absolute
+ * schedule using pros::Task::delay_until, and measures the jitter, overruns and execution time of every tick.
+ *
+ * By default each tick calls lemlib::update(), but any odometry update function can be scheduled instead.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // run odometry every 5ms, above the default task priority
+ * OdomScheduler odomScheduler(5, TASK_PRIORITY_DEFAULT + 2);
+ * // started by RobotChassis::calibrate, or manually after lemlib::setSensors
+ * odomScheduler.start();
+ * // later
+ * OdomTimingStats stats = odomScheduler.getStats();
+ * printf("max jitter: %lu us, overruns: %lu\n", stats.maxJitter, stats.overruns);
+ * @endcode
+ */
+class OdomScheduler {
+    public:
+        /**
+         * @brief Construct a new odometry scheduler. The task is not started until start() is called
+         *
+         * @param period time between odometry updates, in milliseconds. 10 by default
+         * @param priority priority of the odometry task. Should be above any task that may preempt it
+         * @param update the odometry update to run every tick. lemlib::update by default
+         */
+        OdomScheduler(std::uint32_t period = 10, std::uint32_t priority = TASK_PRIORITY_DEFAULT + 2,
+                      std::function<void()> update = lemlib::update);
+
+        OdomScheduler(const OdomScheduler&) = delete;
+        OdomScheduler& operator=(const OdomScheduler&) = delete;
+
+        /**
+         * @brief Start the odometry task. Does nothing if it is already running
+         *
+         * @note lemlib::setSensors must have been called first
+         */
+        void start();
+        /**
+         * @brief Change the period of the odometry task. Takes effect on the next tick and resets the stats
+         *
+         * @param period time between odometry updates, in milliseconds
+         */
+        void setPeriod(std::uint32_t period);
+        /**
+         * @brief Change the odometry update run every tick, like switching to a PoseEstimator once its sensors are
+         * found. Takes effect on the next tick
+         *
+         * @param update the new odometry update
+         */
+        void setUpdate(std::function<void()> update);
+        /**
+         * @brief Get the period of the odometry task, in milliseconds
+         */
+        std::uint32_t getPeriod();
+        /**
+         * @brief Get a copy of the timing stats
+         */
+        OdomTimingStats getStats();
+        /**
+         * @brief Reset the timing stats. Useful to only measure a single autonomous routine
+         */
+        void resetStats();
+        /**
+         * @brief whether the odometry task has been started
+         */
+        bool isRunning() const;
+        /**
+         * @brief Get the number of odometry ticks that allocated on the heap
+         *
+         * @note always 0 unless the project is built with -DALLOCATION_CHECKS
+         */
+        std::uint32_t getAllocatingTicks() const;
+    private:
+        /**
+         * @brief The function run inside the odometry task
+         */
+        void taskLoop();
+
+        std::uint32_t period;
+        std::uint32_t priority;
+        std::function<void()> update;
+        bool periodChanged = false;
+        /** update to switch to on the next tick */
+        std::function<void()> pendingUpdate;
+        bool updateChanged = false;
+
+        OdomTimingStats stats;
+        std::uint64_t jitterSum = 0;
+
+        AllocationCheck allocationCheck {"odometry"};
+
+        pros::Mutex mutex;
+        pros::Task* task = nullptr;
+};
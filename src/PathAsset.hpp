@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "lemlib/asset.hpp"
+
+/**
+ * Binary path assets
+ *
+ * Paths exported from path.jerryio are text, which LemLib parses into a std::vector every time a path is followed.
+ * tools/path2bin converts them ahead of time into a packed binary asset (run `make paths`), which is linked into the
+ * program like any other file in static/ and read in place on the robot.
+ *
+ * Layout, little endian:
+ * - PathHeader
+ * - PathHeader::count PathPoints
+ *
+ * The checksum is the CRC-32 of the points, so a truncated or stale asset is rejected instead of followed.
+ *
+ * This header is shared with the host tools, so it must not depend on PROS.
+ */
+
+/**
+ * @brief Header at the start of a binary path asset
+ */
+struct PathHeader {
+        /** PATH_MAGIC */
+        std::uint32_t magic;
+        /** PATH_VERSION */
+        std::uint16_t version;
+        /** sizeof(PathPoint), so points can be extended without breaking old readers */
+        std::uint16_t pointSize;
+        /** number of points */
+        std::uint32_t count;
+        /** length of the path, in inches */
+        float length;
+        /** CRC-32 of the points */
+        std::uint32_t checksum;
+};
+
+/**
+ * @brief A point in a binary path asset
+ */
+struct PathPoint {
+        /** x position, in inches */
+        float x;
+        /** y position, in inches */
+        float y;
+        /** target speed, between 0 and 127. The last point of a path has a speed of 0 */
+        float speed;
+        /** signed curvature of the path at this point. Positive curvature is clockwise */
+        float curvature;
+        /** distance along the path from the first point, in inches */
+        float distance;
+};
+
+static_assert(sizeof(PathHeader) == 20, "PathHeader must be packed");
+static_assert(sizeof(PathPoint) == 20, "PathPoint must be packed");
+
+/** "PATH" */
+constexpr std::uint32_t PATH_MAGIC = 0x48544150;
+constexpr std::uint16_t PATH_VERSION = 1;
+
+/**
+ * @brief Calculate the CRC-32 of a block of memory
+ *
+ * @param data the data
+ * @param size size of the data, in bytes
+ * @param crc CRC of the data before this block, to checksum data in several parts. 0 by default
+ * @return std::uint32_t
+ */
+inline std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0) {
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+/**
+ * @brief A read-only view of a binary path asset
+ *
+ * The points are read straight from the linked asset. Nothing is copied or allocated, so views are cheap to pass
+ * around by value.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // "static/skills.bin" is generated from "static/skills.txt" by `make paths`
+ * ASSET(skills_bin);
+ * // the path is checked once, here
+ * PathView skillsPath(skills_bin);
+ *
+ * void autonomous() {
+ *     chassis.follow(skillsPath, 10, 4000);
+ *     chassis.follow(skillsPath, 10, 4000, false);
+ * }
+ * @endcode
+ */
+class PathView {
+    public:
+        /**
+         * @brief Construct an empty path
+         */
+        PathView() = default;
+        /**
+         * @brief Construct a view of a binary path asset
+         *
+         * The asset is checked once here. If the header or checksum don't match, the view is empty and getError()
+         * says why
+         *
+         * @param path the asset, declared with ASSET()
+         */
+        explicit PathView(const asset& path) {
+            PathHeader header;
+            if (path.size < sizeof(header)) {
+                error = "asset is too small to be a binary path";
+                return;
+            }
+            std::memcpy(&header, path.buf, sizeof(header));
+            if (header.magic != PATH_MAGIC) {
+                error = "asset is not a binary path, convert it with `make paths`";
+                return;
+            }
+            if (header.version != PATH_VERSION || header.pointSize != sizeof(PathPoint)) {
+                error = "unsupported binary path version";
+                return;
+            }
+            const std::size_t pointsSize = std::size_t(header.count) * sizeof(PathPoint);
+            if (header.count == 0 || path.size < sizeof(header) + pointsSize) {
+                error = "binary path is empty or truncated";
+                return;
+            }
+            if (crc32(path.buf + sizeof(header), pointsSize) != header.checksum) {
+                error = "binary path checksum does not match";
+                return;
+            }
+            points = path.buf + sizeof(header);
+            count = header.count;
+            length = header.length;
+            error = nullptr;
+        }
+
+        /**
+         * @brief Whether the view contains a valid path
+         */
+        bool isValid() const { return count != 0; }
+
+        /**
+         * @brief Get why the asset was rejected
+         *
+         * @return const char* nullptr if the path is valid
+         */
+        const char* getError() const { return error; }
+
+        /**
+         * @brief Get the number of points in the path
+         */
+        std::size_t size() const { return count; }
+
+        /**
+         * @brief Get the length of the path, in inches
+         */
+        float getLength() const { return length; }
+
+        /**
+         * @brief Get a point of the path
+         *
+         * Linked assets are only byte aligned, so the point is copied out instead of returned by reference
+         *
+         * @param i index of the point. Must be less than size()
+         */
+        PathPoint operator[](std::size_t i) const {
+            PathPoint point;
+            std::memcpy(&point, points + i * sizeof(PathPoint), sizeof(PathPoint));
+            return point;
+        }
+    private:
+        const std::uint8_t* points = nullptr;
+        std::uint32_t count = 0;
+        float length = 0;
+        const char* error = "path is empty";
+};
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/util.hpp"
+#include "RobotLog.hpp"
+#include "PathBuilder.hpp"
+
+PathBuilder::PathBuilder(ProfileConstraints constraints)
+    : constraints(constraints) {}
+
+void PathBuilder::Segment::evaluate(float t, int derivative, float& outX, float& outY) const {
+    outX = 0;
+    outY = 0;
+    // Horner's method on the derivative of the polynomial
+    for (int k = 5; k >= derivative; k--) {
+        float factor = 1;
+        for (int i = 0; i < derivative; i++) factor *= k - i;
+        outX = outX * t + x[k] * factor;
+        outY = outY * t + y[k] * factor;
+    }
+}
+
+PathBuilder::Segment PathBuilder::makeSegment(lemlib::Pose start, lemlib::Pose end, float startHeading,
+                                              float endHeading, PathSettings settings) {
+    // tangents, scaled by the distance between the waypoints so the shape doesn't depend on the scale
+    const float scale = settings.tangentScale * start.distance(end);
+    const float m0x = std::sin(startHeading) * scale;
+    const float m0y = std::cos(startHeading) * scale;
+    const float m1x = std::sin(endHeading) * scale;
+    const float m1y = std::cos(endHeading) * scale;
+
+    Segment segment;
+    auto fit = [&](std::array<float, 6>& a, float p0, float m0, float m1, float p1) {
+        a[0] = p0;
+        a[1] = m0;
+        if (settings.spline == PathSettings::Spline::CUBIC_BEZIER) {
+            // control points at p0 + m0 / 3 and p1 - m1 / 3
+            a[2] = -3 * p0 - 2 * m0 + 3 * p1 - m1;
+            a[3] = 2 * p0 + m0 - 2 * p1 + m1;
+        } else {
+            // no acceleration at either end, so curvature is 0 at the waypoints and continuous between segments
+            a[3] = -10 * p0 - 6 * m0 - 4 * m1 + 10 * p1;
+            a[4] = 15 * p0 + 8 * m0 + 7 * m1 - 15 * p1;
+            a[5] = -6 * p0 - 3 * m0 - 3 * m1 + 6 * p1;
+        }
+    };
+    fit(segment.x, start.x, m0x, m1x, end.x);
+    fit(segment.y, start.y, m0y, m1y, end.y);
+    return segment;
+}
+
+bool PathBuilder::push(PathPoint point) {
+    if (count >= MAX_POINTS) return false;
+    storage.points[count++] = point;
+    return true;
+}
+
+PathView PathBuilder::build(std::span<const lemlib::Pose> waypoints, PathSettings settings) {
+    count = 0;
+    if (waypoints.size() < 2) {
+        robotLog().error("Can't build a path with less than 2 waypoints");
+        return {};
+    }
+    settings.spacing = std::max(settings.spacing, 0.1f);
+
+    // heading at a waypoint, in radians. If it isn't set, point from the previous waypoint to the next
+    auto heading = [&](std::size_t i) -> float {
+        if (!std::isnan(waypoints[i].theta)) return lemlib::degToRad(waypoints[i].theta);
+        const lemlib::Pose& prev = waypoints[i == 0 ? 0 : i - 1];
+        const lemlib::Pose& next = waypoints[std::min(i + 1, waypoints.size() - 1)];
+        return std::atan2(next.x - prev.x, next.y - prev.y);
+    };
+
+    // sample each segment at even distances along the path
+    constexpr int STEPS = 64;
+    float segmentStart = 0;
+    float nextDistance = 0;
+    for (std::size_t i = 0; i + 1 < waypoints.size(); i++) {
+        const Segment segment = makeSegment(waypoints[i], waypoints[i + 1], heading(i), heading(i + 1), settings);
+
+        // arc length table, to find t for a distance along the segment
+        std::array<float, STEPS + 1> lengths;
+        lengths[0] = 0;
+        float prevX, prevY;
+        segment.evaluate(0, 0, prevX, prevY);
+        for (int j = 1; j <= STEPS; j++) {
+            float x, y;
+            segment.evaluate(float(j) / STEPS, 0, x, y);
+            lengths[j] = lengths[j - 1] + std::hypot(x - prevX, y - prevY);
+            prevX = x;
+            prevY = y;
+        }
+
+        int j = 0;
+        while (nextDistance < segmentStart + lengths[STEPS]) {
+            const float local = nextDistance - segmentStart;
+            while (lengths[j + 1] < local) j++;
+            const float span = lengths[j + 1] - lengths[j];
+            const float t = (j + (span > 0 ? (local - lengths[j]) / span : 0)) / STEPS;
+
+            PathPoint point {.distance = nextDistance};
+            float dx, dy, ddx, ddy;
+            segment.evaluate(t, 0, point.x, point.y);
+            segment.evaluate(t, 1, dx, dy);
+            segment.evaluate(t, 2, ddx, ddy);
+            // signed curvature, positive clockwise
+            const float speed = std::hypot(dx, dy);
+            point.curvature = speed > 0 ? -(dx * ddy - dy * ddx) / (speed * speed * speed) : 0;
+            if (!push(point)) {
+                robotLog().error("Path has more than {} points, increase the spacing", MAX_POINTS);
+                count = 0;
+                return {};
+            }
+            nextDistance += settings.spacing;
+        }
+        segmentStart += lengths[STEPS];
+    }
+
+    // end exactly on the last waypoint, then extend the path past it
+    const lemlib::Pose& last = waypoints.back();
+    const float endHeading = heading(waypoints.size() - 1);
+    const PathPoint end {.x = last.x, .y = last.y, .distance = segmentStart};
+    const PathPoint extension {.x = last.x + std::sin(endHeading) * END_EXTENSION,
+                               .y = last.y + std::cos(endHeading) * END_EXTENSION,
+                               .distance = segmentStart + END_EXTENSION};
+    if (!push(end) || !push(extension)) {
+        robotLog().error("Path has more than {} points, increase the spacing", MAX_POINTS);
+        count = 0;
+        return {};
+    }
+    const std::size_t endIndex = count - 2;
+
+    // speed limit in curves, so the robot doesn't slip sideways
+    const float maxVel = constraints.maxVel * std::clamp<float>(settings.maxSpeed, 0, 127) / 127;
+    const float minVel = std::min(constraints.maxVel * std::clamp<float>(settings.minSpeed, 0, 127) / 127, maxVel);
+    PathPoint* points = storage.points;
+    for (std::size_t i = 0; i < endIndex; i++) {
+        const float curvature = std::fabs(points[i].curvature);
+        points[i].speed = curvature > 0 ? std::min(maxVel, std::sqrt(settings.maxLateralAccel / curvature)) : maxVel;
+    }
+    // accelerate from the minimum speed at the start, and decelerate to a stop at the end
+    points[0].speed = std::min(points[0].speed, minVel);
+    for (std::size_t i = 1; i < endIndex; i++) {
+        const float ds = points[i].distance - points[i - 1].distance;
+        points[i].speed = std::min(points[i].speed,
+                                   std::sqrt(points[i - 1].speed * points[i - 1].speed + 2 * constraints.maxAccel * ds));
+    }
+    float nextSpeed = 0;
+    for (std::size_t i = endIndex; i-- > 0;) {
+        const float ds = points[i + 1].distance - points[i].distance;
+        points[i].speed = std::min(points[i].speed, std::sqrt(nextSpeed * nextSpeed + 2 * constraints.maxAccel * ds));
+        nextSpeed = points[i].speed;
+    }
+    // convert to motor power. The end of the path has a speed of 0
+    for (std::size_t i = 0; i < endIndex; i++)
+        points[i].speed = std::max(points[i].speed, minVel) * 127 / constraints.maxVel;
+
+    storage.header = {.magic = PATH_MAGIC,
+                      .version = PATH_VERSION,
+                      .pointSize = sizeof(PathPoint),
+                      .count = std::uint32_t(count),
+                      .length = extension.distance,
+                      .checksum = crc32(points, count * sizeof(PathPoint))};
+    return PathView(asset {reinterpret_cast<std::uint8_t*>(&storage), sizeof(PathHeader) + count * sizeof(PathPoint)});
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include "lemlib/pose.hpp"
+#include "MotionProfile.hpp"
+#include "PathAsset.hpp"
+#include "PathIndex.hpp"
+
+/**
+ * @brief Settings for PathBuilder::build
+ */
+struct PathSettings {
+        /** the kind of spline between waypoints */
+        enum class Spline {
+            /** cubic Bézier. Curvature jumps at the waypoints */
+            CUBIC_BEZIER,
+            /** quintic Hermite with no acceleration at the waypoints. Curvature is continuous */
+            QUINTIC_HERMITE
+        };
+
+        /** the kind of spline between waypoints. Quintic Hermite by default */
+        Spline spline = Spline::QUINTIC_HERMITE;
+        /** distance between points of the path, in inches. 1 by default */
+        float spacing = 1;
+        /** how far the waypoint headings pull the path, as a fraction of the distance between waypoints. Higher
+         * values result in curvier paths. 1 by default */
+        float tangentScale = 1;
+        /** the maximum speed the robot can travel at. Value between 0-127. 127 by default */
+        float maxSpeed = 127;
+        /** the speed the robot won't go below, except at the end of the path. Value between 0-127. 20 by default */
+        float minSpeed = 20;
+        /** the maximum sideways acceleration in turns, in inches per second squared. Limits the speed in curves.
+         * 100 by default */
+        float maxLateralAccel = 100;
+};
+
+/**
+ * @brief Builds paths on the robot, from waypoints
+ *
+ * Splines are fit through the waypoints, then sampled at points evenly spaced along the path with their curvature.
+ * The speed at each point is limited by the curvature, so the robot slows down in turns, then by the acceleration
+ * limit, so it speeds up and slows down smoothly.
+ *
+ * The path is written into a buffer inside the builder, in the binary path format, so it can be followed straight
+ * away. Building a path never allocates, and takes well under a millisecond for a typical path.
+ *
+ * @b Example
+ * @code {.cpp}
+ * PathBuilder pathBuilder(ProfileConstraints::fromDrivetrain(drivetrain));
+ *
+ * void autonomous() {
+ *     // waypoint headings are in degrees, like moveToPose. NaN lets the builder choose the heading
+ *     const lemlib::Pose waypoints[] = {{0, 0, 0}, {24, 24, NAN}, {24, 48, 0}};
+ *     chassis.follow(pathBuilder.build(waypoints), 10, 4000);
+ * }
+ * @endcode
+ */
+class PathBuilder {
+    public:
+        /** most points a path can have */
+        static constexpr std::size_t MAX_POINTS = PathIndex::MAX_POINTS;
+        /** length of the straight line added past the end of the path, so the lookahead circle always has
+         * something to intersect. Same as path.jerryio */
+        static constexpr float END_EXTENSION = 20;
+
+        /**
+         * @brief Construct a new PathBuilder
+         *
+         * @param constraints velocity and acceleration limits of the drivetrain. The maximum velocity is what a speed
+         * of 127 maps to
+         */
+        PathBuilder(ProfileConstraints constraints);
+        /**
+         * @brief Build a path through the waypoints
+         *
+         * The path is only valid until the next call to build
+         *
+         * @param waypoints the waypoints. Headings are in degrees, 0 is forwards and increases clockwise. A NaN
+         * heading is replaced by the direction from the previous waypoint to the next
+         * @param settings struct to simulate named parameters
+         * @return PathView the path, or an empty path if there are less than 2 waypoints, or the path is too long
+         */
+        PathView build(std::span<const lemlib::Pose> waypoints, PathSettings settings = {});
+    private:
+        /**
+         * @brief One spline between two waypoints, as polynomial coefficients in t from 0 to 1
+         */
+        struct Segment {
+                std::array<float, 6> x = {};
+                std::array<float, 6> y = {};
+
+                /** get the nth derivative of the position at t */
+                void evaluate(float t, int derivative, float& outX, float& outY) const;
+        };
+
+        /**
+         * @brief Fit the spline between two waypoints
+         */
+        static Segment makeSegment(lemlib::Pose start, lemlib::Pose end, float startHeading, float endHeading,
+                                   PathSettings settings);
+        /**
+         * @brief Append a point, failing if the buffer is full
+         */
+        bool push(PathPoint point);
+
+        ProfileConstraints constraints;
+        std::size_t count = 0;
+
+        /**
+         * @brief The path, laid out as a binary path asset
+         */
+        struct Storage {
+                PathHeader header;
+                PathPoint points[MAX_POINTS];
+        } storage;
+
+        static_assert(offsetof(Storage, points) == sizeof(PathHeader), "points must follow the header");
+};
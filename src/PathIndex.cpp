@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include "PathIndex.hpp"
+
+void PathIndex::build(const PathView& path) {
+    this->path = path;
+    cursor = 0;
+    gridValid = path.isValid() && path.size() <= MAX_POINTS;
+    if (!gridValid) return;
+
+    // bounding box of the path
+    float maxX = path[0].x;
+    float maxY = path[0].y;
+    minX = maxX;
+    minY = maxY;
+    for (std::size_t i = 1; i < path.size(); i++) {
+        const PathPoint point = path[i];
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+    // square cells, so the search radius is the same in both directions
+    cellSize = std::max({maxX - minX, maxY - minY, 1.0f}) / GRID_SIZE;
+
+    // counting sort of the points by cell
+    cellStart.fill(0);
+    for (std::size_t i = 0; i < path.size(); i++) {
+        const PathPoint point = path[i];
+        cellStart[cellCoord(point.y, minY) * GRID_SIZE + cellCoord(point.x, minX) + 1]++;
+    }
+    for (std::size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+    std::array<std::uint16_t, GRID_SIZE * GRID_SIZE> fill;
+    std::copy(cellStart.begin(), cellStart.end() - 1, fill.begin());
+    for (std::size_t i = 0; i < path.size(); i++) {
+        const PathPoint point = path[i];
+        cellPoints[fill[cellCoord(point.y, minY) * GRID_SIZE + cellCoord(point.x, minX)]++] = i;
+    }
+}
+
+std::size_t PathIndex::cellCoord(float value, float min) const {
+    const int cell = (value - min) / cellSize;
+    return std::clamp<int>(cell, 0, GRID_SIZE - 1);
+}
+
+PathIndex::Closest PathIndex::findClosest(float x, float y, float reacquireDistance) {
+    if (!path.isValid()) return {};
+
+    // search forwards from the cursor, until WINDOW points in a row are no closer
+    Closest best {cursor, std::hypot(path[cursor].x - x, path[cursor].y - y)};
+    std::size_t end = std::min(cursor + WINDOW + 1, path.size());
+    for (std::size_t i = cursor + 1; i < end; i++) {
+        const PathPoint point = path[i];
+        const float distance = std::hypot(point.x - x, point.y - y);
+        if (distance < best.distance) {
+            best = {i, distance};
+            end = std::min(i + WINDOW + 1, path.size());
+        }
+    }
+
+    // the robot has been knocked off the path, search all of it
+    if (best.distance > reacquireDistance) {
+        if (gridValid) best = gridClosest(x, y);
+        else {
+            for (std::size_t i = 0; i < path.size(); i++) {
+                const PathPoint point = path[i];
+                const float distance = std::hypot(point.x - x, point.y - y);
+                if (distance < best.distance) best = {i, distance};
+            }
+        }
+    }
+
+    cursor = best.index;
+    return best;
+}
+
+PathIndex::Closest PathIndex::gridClosest(float x, float y) const {
+    const int cellX = cellCoord(x, minX);
+    const int cellY = cellCoord(y, minY);
+    Closest best {0, INFINITY};
+    // search rings of cells around the robot's cell
+    for (int r = 0; r < int(GRID_SIZE); r++) {
+        for (int dy = -r; dy <= r; dy++) {
+            const int cy = cellY + dy;
+            if (cy < 0 || cy >= int(GRID_SIZE)) continue;
+            // only the edges of the ring, the inside has already been searched
+            const int step = (dy == -r || dy == r) ? 1 : std::max(2 * r, 1);
+            for (int dx = -r; dx <= r; dx += step) {
+                const int cx = cellX + dx;
+                if (cx < 0 || cx >= int(GRID_SIZE)) continue;
+                const std::size_t cell = cy * GRID_SIZE + cx;
+                for (std::size_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                    const PathPoint point = path[cellPoints[k]];
+                    const float distance = std::hypot(point.x - x, point.y - y);
+                    // prefer the earlier point if two are equally close
+                    if (distance < best.distance || (distance == best.distance && cellPoints[k] < best.index))
+                        best = {cellPoints[k], distance};
+                }
+            }
+        }
+        // every point in the next ring is further than r cells away
+        if (best.distance <= r * cellSize) break;
+    }
+    return best;
+}
+
+std::optional<PathIndex::Lookahead> PathIndex::findLookahead(float x, float y, float lookahead, Closest closest,
+                                                             std::size_t start) const {
+    if (!path.isValid()) return std::nullopt;
+    const float maxDistance = path[closest.index].distance + M_PI * (lookahead + closest.distance);
+    for (std::size_t i = std::max(closest.index, start); i + 1 < path.size(); i++) {
+        const PathPoint p1 = path[i];
+        if (p1.distance > maxDistance) break;
+        const PathPoint p2 = path[i + 1];
+        // intersect the segment with the circle
+        const float dx = p2.x - p1.x;
+        const float dy = p2.y - p1.y;
+        const float fx = p1.x - x;
+        const float fy = p1.y - y;
+        const float a = dx * dx + dy * dy;
+        const float b = 2 * (fx * dx + fy * dy);
+        const float c = fx * fx + fy * fy - lookahead * lookahead;
+        float discriminant = b * b - 4 * a * c;
+        if (discriminant < 0 || a == 0) continue;
+        discriminant = std::sqrt(discriminant);
+        const float t1 = (-b - discriminant) / (2 * a);
+        const float t2 = (-b + discriminant) / (2 * a);
+        // prioritize further down the path
+        float t = -1;
+        if (t2 >= 0 && t2 <= 1) t = t2;
+        else if (t1 >= 0 && t1 <= 1) t = t1;
+        if (t != -1) return Lookahead {.index = i, .x = p1.x + dx * t, .y = p1.y + dy * t};
+    }
+    return std::nullopt;
+}
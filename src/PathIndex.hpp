@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include "PathAsset.hpp"
+
+/**
+ * @brief Spatial index over a path, for pure pursuit
+ *
+ * Pure pursuit needs the point of the path closest to the robot and the intersection of the path with the lookahead
+ * circle every tick. Scanning the whole path for both is O(n) per tick, which adds up on long skills paths.
+ *
+ * The closest point is tracked with a cursor that only moves forwards. Each tick, points are searched from the
+ * cursor until they stop getting closer, so the cost only depends on how far the robot moved since the last tick.
+ * If the robot is knocked off the path, further than the reacquire distance from the point the cursor found, the
+ * closest point is looked up in a uniform grid over the path instead, and the cursor jumps there. Unlike a full
+ * scan, the cursor sticks to the part of the path the robot is on when a later part of the path passes close by.
+ *
+ * The index is built into fixed buffers in O(n), so building it and querying it never allocate. It doesn't depend
+ * on PROS, so it can be benchmarked on the host (`make bench`).
+ *
+ * @b Example
+ * @code {.cpp}
+ * PathIndex index;
+ * index.build(path);
+ * PathIndex::Closest closest = index.findClosest(pose.x, pose.y, 10);
+ * std::optional<PathIndex::Lookahead> lookahead = index.findLookahead(pose.x, pose.y, 10, closest);
+ * @endcode
+ */
+class PathIndex {
+    public:
+        /** longest path the grid can index. Longer paths fall back to a linear search when reacquiring */
+        static constexpr std::size_t MAX_POINTS = 4096;
+        /** number of grid cells along each side of the path's bounding box */
+        static constexpr std::size_t GRID_SIZE = 32;
+        /** number of points past the best point found so far that are checked before the search stops */
+        static constexpr std::size_t WINDOW = 8;
+
+        /**
+         * @brief The point of the path closest to the robot
+         */
+        struct Closest {
+                /** index of the point */
+                std::size_t index = 0;
+                /** distance between the robot and the point, in inches */
+                float distance = 0;
+        };
+
+        /**
+         * @brief Where the path intersects the lookahead circle
+         */
+        struct Lookahead {
+                /** index of the first point of the segment the intersection is on */
+                std::size_t index = 0;
+                float x = 0;
+                float y = 0;
+        };
+
+        /**
+         * @brief Build the index for a path, and reset the cursor to the start of the path
+         *
+         * @param path the path. Must stay alive as long as the index is used
+         */
+        void build(const PathView& path);
+        /**
+         * @brief Find the point of the path closest to the robot, and move the cursor to it
+         *
+         * @param x x position of the robot
+         * @param y y position of the robot
+         * @param reacquireDistance if the point found by the cursor is further than this, search the whole path
+         * @return Closest
+         */
+        Closest findClosest(float x, float y, float reacquireDistance);
+        /**
+         * @brief Find the first intersection of the path with the lookahead circle, past the closest point
+         *
+         * Only segments up to about half a lookahead circumference further along the path than the closest point are
+         * considered, so the search is bounded even if the robot is far from the path
+         *
+         * @param x x position of the robot
+         * @param y y position of the robot
+         * @param lookahead radius of the lookahead circle, in inches
+         * @param closest the closest point, from findClosest
+         * @param start index of the first segment to consider. 0 by default
+         * @return std::optional<Lookahead> std::nullopt if the path doesn't intersect the circle
+         */
+        std::optional<Lookahead> findLookahead(float x, float y, float lookahead, Closest closest,
+                                               std::size_t start = 0) const;
+    private:
+        /**
+         * @brief Find the closest point by searching the grid outwards from the robot's cell
+         */
+        Closest gridClosest(float x, float y) const;
+        /**
+         * @brief Get the grid cell a coordinate is in, clamped to the grid
+         */
+        std::size_t cellCoord(float value, float min) const;
+
+        PathView path;
+        std::size_t cursor = 0;
+        bool gridValid = false;
+        float minX = 0;
+        float minY = 0;
+        float cellSize = 1;
+        /** index into cellPoints of the first point of each cell, and one past the end */
+        std::array<std::uint16_t, GRID_SIZE * GRID_SIZE + 1> cellStart = {};
+        /** path indices sorted by cell */
+        std::array<std::uint16_t, MAX_POINTS> cellPoints = {};
+};
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+#include "PoseEstimator.hpp"
+
+/** inches per meter, the GPS reports meters */
+constexpr float METERS_TO_INCHES = 39.3701;
+
+PoseEstimator::PoseEstimator(TimestampedOdom* odom, pros::Imu* imu, EstimatorSettings settings)
+    : odom(odom),
+      imu(imu),
+      settings(settings) {
+    for (std::size_t size = 1; size < gates.size(); size++) gates[size] = chiSquareGate(size, settings.gate);
+}
+
+void PoseEstimator::addGps(pros::Gps* gps) { this->gps = gps; }
+
+bool PoseEstimator::addDistance(pros::Distance* sensor, lemlib::Pose offset) {
+    if (distanceSensorCount >= MAX_DISTANCE_SENSORS) return false;
+    distanceSensors[distanceSensorCount++] = {sensor, offset};
+    return true;
+}
+
+void PoseEstimator::reset(lemlib::Pose pose) {
+    ekf.x = {pose.x, pose.y, pose.theta, 0, 0};
+    ekf.P = {};
+    ekf.P[X][X] = 0.25;
+    ekf.P[Y][Y] = 0.25;
+    ekf.P[THETA][THETA] = 1e-4;
+    ekf.P[V][V] = 1;
+    ekf.P[OMEGA][OMEGA] = 0.01;
+    // the IMU measures rotation since it was calibrated, line it up with the new heading
+    if (imu != nullptr) {
+        const float rotation = imu->get_rotation();
+        if (std::isfinite(rotation)) imuOffset = pose.theta - lemlib::degToRad(rotation);
+    }
+    lastPose = pose;
+}
+
+void PoseEstimator::update() {
+    const std::uint64_t now = pros::micros();
+    const lemlib::Pose pose = lemlib::getPose(true);
+    if (!initialized) {
+        reset(pose);
+        odom->poll();
+        prevTime = now;
+        initialized = true;
+        return;
+    }
+    // chassis.setPose() was called since the last update
+    if (pose.x != lastPose.x || pose.y != lastPose.y || pose.theta != lastPose.theta) reset(pose);
+
+    // the wheels are only read here, the estimate is what gets written to lemlib
+    const bool wheelsFresh = odom->poll();
+    predict((now - prevTime) / 1000000.0f);
+    prevTime = now;
+
+    // the speeds only change when the motors have new samples, fusing them again would count them twice
+    if (wheelsFresh) fuseWheels();
+    if (imu != nullptr) fuseImu();
+    if (gps != nullptr) fuseGps();
+    for (std::size_t i = 0; i < distanceSensorCount; i++) fuseDistance(distanceSensors[i]);
+
+    lastPose = lemlib::Pose(ekf.x[X], ekf.x[Y], ekf.x[THETA]);
+    lemlib::setPose(lastPose, true);
+}
+
+void PoseEstimator::predict(float dt) {
+    if (dt <= 0) return;
+    const float theta = ekf.x[THETA];
+    const float v = ekf.x[V];
+    // constant velocity model
+    ekf.x[X] += v * std::sin(theta) * dt;
+    ekf.x[Y] += v * std::cos(theta) * dt;
+    ekf.x[THETA] += ekf.x[OMEGA] * dt;
+
+    Ekf<STATES>::Matrix F = {};
+    for (int i = 0; i < STATES; i++) F[i][i] = 1;
+    F[X][THETA] = v * std::cos(theta) * dt;
+    F[X][V] = std::sin(theta) * dt;
+    F[Y][THETA] = -v * std::sin(theta) * dt;
+    F[Y][V] = std::cos(theta) * dt;
+    F[THETA][OMEGA] = dt;
+
+    // unexpected accelerations, integrated over the time step
+    Ekf<STATES>::Matrix Q = {};
+    const float accel = settings.accelNoise * dt;
+    const float angularAccel = settings.angularAccelNoise * dt;
+    Q[X][X] = Q[Y][Y] = (accel * dt / 2) * (accel * dt / 2) + settings.slipNoise * settings.slipNoise * dt;
+    Q[THETA][THETA] = (angularAccel * dt / 2) * (angularAccel * dt / 2);
+    Q[V][V] = accel * accel;
+    Q[OMEGA][OMEGA] = angularAccel * angularAccel;
+    ekf.predict(F, Q);
+}
+
+void PoseEstimator::fuseWheels() {
+    const lemlib::Pose speed = odom->getLocalSpeed();
+    Ekf<STATES>::MeasurementMatrix<2> H = {};
+    H[0][V] = 1;
+    H[1][OMEGA] = 1;
+    Ekf<STATES>::SquareMatrix<2> R = {};
+    R[0][0] = settings.wheelSpeedNoise * settings.wheelSpeedNoise;
+    R[1][1] = settings.wheelTurnNoise * settings.wheelTurnNoise;
+    const std::array<float, 2> innovation = {speed.y - ekf.x[V], speed.theta - ekf.x[OMEGA]};
+    if (ekf.update<2>(innovation, H, R, gates[2])) {
+        stats.wheelAccepted++;
+        wheelRejections = 0;
+        return;
+    }
+    stats.wheelRejected++;
+    // the robot changed speed faster than the model allows, so let the wheels back in
+    if (++wheelRejections >= settings.maxRejections) {
+        ekf.P[V][V] += innovation[0] * innovation[0];
+        ekf.P[OMEGA][OMEGA] += innovation[1] * innovation[1];
+        wheelRejections = 0;
+    }
+}
+
+void PoseEstimator::fuseImu() {
+    const float rotation = imu->get_rotation();
+    if (!std::isfinite(rotation)) return;
+    // rotation doesn't wrap, and neither does the heading of the estimate
+    Ekf<STATES>::MeasurementMatrix<1> H = {};
+    H[0][THETA] = 1;
+    const Ekf<STATES>::SquareMatrix<1> R = {{{settings.imuNoise * settings.imuNoise}}};
+    const float innovation = lemlib::degToRad(rotation) + imuOffset - ekf.x[THETA];
+    if (ekf.update<1>({innovation}, H, R, gates[1])) {
+        stats.imuAccepted++;
+        imuRejections = 0;
+        return;
+    }
+    stats.imuRejected++;
+    if (++imuRejections >= settings.maxRejections) {
+        ekf.P[THETA][THETA] += innovation * innovation;
+        imuRejections = 0;
+    }
+}
+
+void PoseEstimator::fuseGps() {
+    const pros::gps_status_s_t status = gps->get_position_and_orientation();
+    const float error = gps->get_error() * METERS_TO_INCHES;
+    if (!std::isfinite(error) || error > settings.maxGpsError) return;
+    // only fuse each reading once
+    if (status.x == lastGpsX && status.y == lastGpsY) return;
+    lastGpsX = status.x;
+    lastGpsY = status.y;
+
+    const float heading = lemlib::degToRad(gps->get_heading());
+    if (!std::isfinite(heading)) return;
+    Ekf<STATES>::MeasurementMatrix<3> H = {};
+    H[0][X] = 1;
+    H[1][Y] = 1;
+    H[2][THETA] = 1;
+    // trust the GPS as much as it says it can be trusted
+    const float noise = std::max(error, settings.minGpsNoise);
+    Ekf<STATES>::SquareMatrix<3> R = {};
+    R[0][0] = R[1][1] = noise * noise;
+    R[2][2] = settings.gpsHeadingNoise * settings.gpsHeadingNoise;
+    const std::array<float, 3> innovation = {float(status.x * METERS_TO_INCHES) - ekf.x[X],
+                                             float(status.y * METERS_TO_INCHES) - ekf.x[Y],
+                                             std::remainder(heading - ekf.x[THETA], float(2 * M_PI))};
+    if (ekf.update<3>(innovation, H, R, gates[3])) {
+        stats.gpsAccepted++;
+        gpsRejections = 0;
+        return;
+    }
+    stats.gpsRejected++;
+    // the GPS keeps disagreeing, so the estimate is the one that's wrong. Grow its uncertainty to let the GPS in
+    if (++gpsRejections >= settings.maxRejections) {
+        ekf.P[X][X] += innovation[0] * innovation[0];
+        ekf.P[Y][Y] += innovation[1] * innovation[1];
+        gpsRejections = 0;
+    }
+}
+
+void PoseEstimator::fuseDistance(const DistanceSensor& distance) {
+    const std::int32_t millimeters = distance.sensor->get_distance();
+    // 9999 means nothing is in range
+    if (millimeters == PROS_ERR || millimeters <= 0 || millimeters >= 9999) return;
+    if (distance.sensor->get_confidence() < settings.minDistanceConfidence) return;
+    const float range = millimeters / 25.4f;
+    const float expected = expectedRange(ekf.x, distance.offset);
+    if (!std::isfinite(expected)) return;
+
+    // numerical Jacobian, the wall the sensor is facing makes the analytical one messy
+    Ekf<STATES>::MeasurementMatrix<1> H = {};
+    for (int i : {X, Y, THETA}) {
+        constexpr float EPSILON = 1e-3;
+        Ekf<STATES>::Vector state = ekf.x;
+        state[i] += EPSILON;
+        const float shifted = expectedRange(state, distance.offset);
+        if (!std::isfinite(shifted)) return;
+        H[0][i] = (shifted - expected) / EPSILON;
+    }
+    const float noise = settings.distanceNoise + settings.distanceNoiseScale * range;
+    const Ekf<STATES>::SquareMatrix<1> R = {{{noise * noise}}};
+    if (ekf.update<1>({range - expected}, H, R, gates[1])) stats.distanceAccepted++;
+    else stats.distanceRejected++;
+}
+
+float PoseEstimator::expectedRange(const Ekf<STATES>::Vector& state, lemlib::Pose offset) const {
+    // position of the sensor on the field
+    const float theta = state[THETA];
+    const float x = state[X] + offset.x * std::cos(theta) + offset.y * std::sin(theta);
+    const float y = state[Y] - offset.x * std::sin(theta) + offset.y * std::cos(theta);
+    // direction the sensor faces
+    const float direction = theta + lemlib::degToRad(offset.theta);
+    const float dx = std::sin(direction);
+    const float dy = std::cos(direction);
+
+    // distance along the ray to the walls in front of the sensor
+    const float wall = settings.fieldHalfWidth;
+    float range = INFINITY;
+    if (std::fabs(dx) > 1e-3) range = std::min(range, ((dx > 0 ? wall : -wall) - x) / dx);
+    if (std::fabs(dy) > 1e-3) range = std::min(range, ((dy > 0 ? wall : -wall) - y) / dy);
+    return range > 0 ? range : INFINITY;
+}
+
+lemlib::Pose PoseEstimator::getStdDev() const {
+    return lemlib::Pose(std::sqrt(ekf.P[X][X]), std::sqrt(ekf.P[Y][Y]), std::sqrt(ekf.P[THETA][THETA]));
+}
+
+EstimatorStats PoseEstimator::getStats() const { return stats; }
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include "pros/distance.hpp"
+#include "pros/gps.hpp"
+#include "pros/imu.hpp"
+#include "lemlib/pose.hpp"
+#include "Ekf.hpp"
+#include "TimestampedOdom.hpp"
+
+/**
+ * @brief Noise and gating settings for PoseEstimator
+ *
+ * Noise values are standard deviations.
+ */
+struct EstimatorSettings {
+        /** how quickly the robot's speed can change unexpectedly, in inches per second squared. 60 by default */
+        float accelNoise = 60;
+        /** how quickly the robot's turn rate can change unexpectedly, in radians per second squared. 10 by default */
+        float angularAccelNoise = 10;
+        /** how much the robot slips and skids without the wheels noticing, in inches per square root second.
+         * 1 by default */
+        float slipNoise = 1;
+        /** noise of the wheel speed, in inches per second. 2 by default */
+        float wheelSpeedNoise = 2;
+        /** noise of the wheel turn rate, in radians per second. 0.2 by default */
+        float wheelTurnNoise = 0.2;
+        /** noise of the IMU heading, in radians. 0.01 by default */
+        float imuNoise = 0.01;
+        /** GPS readings with a reported error above this are ignored, in inches. 4 by default */
+        float maxGpsError = 4;
+        /** smallest noise used for GPS positions, however low the reported error is, in inches. 0.5 by default */
+        float minGpsNoise = 0.5;
+        /** noise of the GPS heading, in radians. 0.05 by default */
+        float gpsHeadingNoise = 0.05;
+        /** noise of distance sensors, in inches, plus distanceNoiseScale times the range. 0.5 by default */
+        float distanceNoise = 0.5;
+        /** noise of distance sensors, as a fraction of the range. 0.03 by default */
+        float distanceNoiseScale = 0.03;
+        /** distance sensor readings with a confidence below this are ignored. Between 0 and 63. 32 by default */
+        int minDistanceConfidence = 32;
+        /** distance from the center of the field to each wall, in inches. 70.2 by default */
+        float fieldHalfWidth = 70.2;
+        /** single value measurements further than this many standard deviations from the estimate are rejected.
+         * Measurements of 2 and 3 values are gated so they are rejected as often. 3 by default */
+        float gate = 3;
+        /** after this many readings in a row from a source are rejected, the estimate is assumed to have drifted and
+         * its uncertainty is grown to let the source back in. 5 by default */
+        int maxRejections = 5;
+};
+
+/**
+ * @brief Number of measurements the estimator used and rejected, from each source
+ */
+struct EstimatorStats {
+        std::uint32_t wheelAccepted = 0;
+        std::uint32_t wheelRejected = 0;
+        std::uint32_t imuAccepted = 0;
+        std::uint32_t imuRejected = 0;
+        std::uint32_t gpsAccepted = 0;
+        std::uint32_t gpsRejected = 0;
+        std::uint32_t distanceAccepted = 0;
+        std::uint32_t distanceRejected = 0;
+};
+
+/**
+ * @brief Estimates the robot's pose by fusing wheel odometry with the IMU, GPS sensors and distance sensors
+ *
+ * An extended Kalman filter tracks the position, heading, speed and turn rate of the robot with a constant velocity
+ * model. Every update, each source that has a new reading corrects the estimate, weighted by how noisy it is: wheel
+ * speeds from TimestampedOdom when the motors have new samples, the IMU heading, the GPS position and heading weighted by the error the GPS reports,
+ * and the distance from each distance sensor to the field wall it is facing. Readings that disagree with the
+ * estimate by more than the gate are rejected, so a GPS that loses sight of the field strip or a distance sensor
+ * that sees another robot doesn't pull the pose away. If a source is rejected several times in a row, it is the
+ * estimate that has drifted, like when the robot turns harder than the model expects, so the estimate's uncertainty
+ * is grown until the source is accepted again.
+ *
+ * GPS and distance sensors measure against the field, so they assume the pose is in field coordinates: inches from
+ * the center of the field, like the GPS. Set the GPS offset with pros::Gps::set_offset so it reports the center of
+ * the robot.
+ *
+ * The estimator writes the fused pose to lemlib every update, so everything that uses chassis.getPose() uses it.
+ * chassis.setPose() still works, it resets the estimate.
+ *
+ * @b Example
+ * @code {.cpp}
+ * PoseEstimator poseEstimator(&timestampedOdom, &imu);
+ * // run the estimator instead of plain wheel odometry
+ * OdomScheduler odomScheduler(10, TASK_PRIORITY_DEFAULT + 2, [] { poseEstimator.update(); });
+ *
+ * void initialize() {
+ *     poseEstimator.addGps(&gps);
+ *     // distance sensor 6 inches forwards of the center of the robot, facing backwards
+ *     poseEstimator.addDistance(&backDistance, lemlib::Pose(0, 6, 180));
+ *     chassis.calibrate();
+ * }
+ * @endcode
+ */
+class PoseEstimator {
+    public:
+        /** the maximum number of distance sensors */
+        static constexpr std::size_t MAX_DISTANCE_SENSORS = 4;
+
+        /**
+         * @brief Construct a new PoseEstimator
+         *
+         * @param odom wheel odometry. The estimator polls it, so it must not also be updated
+         * @param imu the IMU. nullptr if there is none
+         * @param settings noise and gating settings
+         */
+        PoseEstimator(TimestampedOdom* odom, pros::Imu* imu = nullptr, EstimatorSettings settings = {});
+        /**
+         * @brief Fuse a GPS sensor
+         *
+         * @param gps the GPS sensor
+         */
+        void addGps(pros::Gps* gps);
+        /**
+         * @brief Fuse a distance sensor
+         *
+         * @param sensor the distance sensor
+         * @param offset position of the sensor relative to the center of the robot, in inches (x is right, y is
+         * forwards), and the direction it faces, in degrees clockwise from forwards
+         * @return false if there are already MAX_DISTANCE_SENSORS
+         */
+        bool addDistance(pros::Distance* sensor, lemlib::Pose offset);
+        /**
+         * @brief Run one step of the estimator. Should be called by the OdomScheduler
+         */
+        void update();
+        /**
+         * @brief Reset the estimate to a pose, with the robot stationary
+         *
+         * @param pose the pose, in inches and radians like lemlib::getPose(true)
+         */
+        void reset(lemlib::Pose pose);
+        /**
+         * @brief Get the standard deviation of the estimate
+         *
+         * @return lemlib::Pose x and y in inches, theta in radians
+         */
+        lemlib::Pose getStdDev() const;
+        /**
+         * @brief Get how many measurements were used and rejected
+         */
+        EstimatorStats getStats() const;
+    private:
+        /** indices of the state */
+        enum State { X, Y, THETA, V, OMEGA, STATES };
+
+        /**
+         * @brief A distance sensor and where it is on the robot
+         */
+        struct DistanceSensor {
+                pros::Distance* sensor = nullptr;
+                lemlib::Pose offset = {0, 0, 0};
+        };
+
+        void predict(float dt);
+        void fuseWheels();
+        void fuseImu();
+        void fuseGps();
+        void fuseDistance(const DistanceSensor& distance);
+        /**
+         * @brief Distance a sensor should read, from a state, to the nearest wall in front of it
+         *
+         * @return float the distance in inches, or infinity if the sensor isn't facing a wall
+         */
+        float expectedRange(const Ekf<STATES>::Vector& state, lemlib::Pose offset) const;
+
+        TimestampedOdom* odom;
+        pros::Imu* imu;
+        pros::Gps* gps = nullptr;
+        EstimatorSettings settings;
+        std::array<DistanceSensor, MAX_DISTANCE_SENSORS> distanceSensors = {};
+        std::size_t distanceSensorCount = 0;
+
+        Ekf<STATES> ekf;
+        /** squared Mahalanobis distance gates, by the number of values measured */
+        std::array<float, 4> gates = {};
+        EstimatorStats stats;
+        bool initialized = false;
+        std::uint64_t prevTime = 0;
+        /** the pose written to lemlib last update, to detect chassis.setPose() */
+        lemlib::Pose lastPose = {0, 0, 0};
+        /** IMU rotation to heading offset */
+        float imuOffset = 0;
+        /** last GPS position, to only fuse new readings */
+        double lastGpsX = NAN;
+        double lastGpsY = NAN;
+        /** readings rejected in a row from each source */
+        int wheelRejections = 0;
+        int imuRejections = 0;
+        int gpsRejections = 0;
+};
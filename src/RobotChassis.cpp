@@ -0,0 +1,888 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/timer.hpp"
+#include "CpuProfiler.hpp"
+#include "RobotLog.hpp"
+#include "RobotChassis.hpp"
+
+RobotChassis::RobotChassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings lateralSettings,
+                           lemlib::ControllerSettings angularSettings, lemlib::OdomSensors sensors,
+                           OdomScheduler* odomScheduler, lemlib::DriveCurve* throttleCurve,
+                           lemlib::DriveCurve* steerCurve)
+    : lemlib::Chassis(drivetrain, lateralSettings, angularSettings, sensors, throttleCurve, steerCurve),
+      odomScheduler(odomScheduler),
+      profileConstraints(ProfileConstraints::fromDrivetrain(drivetrain)),
+      feedforward({.kV = 127 / profileConstraints.maxVel}) {}
+
+/** how long an IMU usually takes to calibrate, in milliseconds, for the progress estimate */
+constexpr float IMU_CALIBRATION_TIME = 2000;
+
+void RobotChassis::calibrate(bool calibrateIMU) { calibrateAsync({.calibrateIMU = calibrateIMU}).wait(); }
+
+CalibrationHandle& RobotChassis::calibrateAsync(CalibrationSettings settings) {
+    if (calibration.started.exchange(true)) return calibration;
+    // tracking wheels reset instantly, so they're reset here. Only the IMU has to settle in the background
+    calibration.setState(CalibrationSensor::IMU,
+                         sensors.imu != nullptr && settings.calibrateIMU ? CalibrationState::PENDING
+                                                                         : CalibrationState::NONE,
+                         0);
+    // use the drivetrain motors for odometry if there are no vertical tracking wheels
+    if (sensors.vertical1 == nullptr)
+        sensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                      -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    if (sensors.vertical2 == nullptr)
+        sensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                      drivetrain.trackWidth / 2, drivetrain.rpm);
+    const std::pair<lemlib::TrackingWheel*, CalibrationSensor> wheels[] = {
+        {sensors.vertical1, CalibrationSensor::VERTICAL1},
+        {sensors.vertical2, CalibrationSensor::VERTICAL2},
+        {sensors.horizontal1, CalibrationSensor::HORIZONTAL1},
+        {sensors.horizontal2, CalibrationSensor::HORIZONTAL2}};
+    for (const auto& [wheel, sensor] : wheels) {
+        if (wheel == nullptr) continue;
+        wheel->reset();
+        calibration.setState(sensor, CalibrationState::DONE, 1);
+    }
+    calibrationTask = new pros::Task([this, settings] { runCalibration(settings); }, TASK_PRIORITY_DEFAULT,
+                                     TASK_STACK_DEPTH_DEFAULT, "Calibration Task");
+    return calibration;
+}
+
+const CalibrationHandle& RobotChassis::getCalibration() const { return calibration; }
+
+void RobotChassis::runCalibration(CalibrationSettings settings) {
+    if (calibration.getState(CalibrationSensor::IMU) == CalibrationState::PENDING) calibrateImu(settings);
+    lemlib::setSensors(sensors, drivetrain);
+    // run odometry on our own scheduler instead of lemlib::init()
+    odomScheduler->start();
+    // create the motion task now so starting a motion never allocates
+    initMotionTask();
+    // rumble to controller to indicate success
+    pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+    calibration.done = true;
+}
+
+void RobotChassis::calibrateImu(CalibrationSettings settings) {
+    CalibrationState result = CalibrationState::FAILED;
+    // calibrate inertial, and if calibration fails, then repeat until successful or out of attempts
+    for (int attempt = 1; attempt <= settings.imuAttempts; attempt++) {
+        const std::uint32_t start = pros::millis();
+        sensors.imu->reset();
+        // wait until IMU is calibrated, or has been calibrating for too long
+        bool timedOut = false;
+        do {
+            pros::delay(10);
+            const std::uint32_t elapsed = pros::millis() - start;
+            timedOut = elapsed >= settings.imuTimeout;
+            calibration.setState(CalibrationSensor::IMU, CalibrationState::CALIBRATING,
+                                 std::min(elapsed / IMU_CALIBRATION_TIME, 0.99f));
+        } while (!timedOut && sensors.imu->get_status() != pros::ImuStatus::error && sensors.imu->is_calibrating());
+        // exit if imu has been calibrated
+        const double heading = sensors.imu->get_heading();
+        if (!timedOut && std::isfinite(heading)) {
+            calibration.setState(CalibrationSensor::IMU, CalibrationState::DONE, 1);
+            return;
+        }
+        result = timedOut ? CalibrationState::TIMED_OUT : CalibrationState::FAILED;
+        calibration.failedAttempts++;
+        // indicate error
+        pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
+        robotLog().warn("IMU failed to calibrate{}! Attempt #{}", timedOut ? " in time" : "", attempt);
+    }
+    // calibration attempts weren't successful
+    sensors.imu = nullptr;
+    calibration.setState(CalibrationSensor::IMU, result, 1);
+    robotLog().error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+}
+
+OdomScheduler& RobotChassis::getOdomScheduler() { return *odomScheduler; }
+
+MotionRecorder& RobotChassis::getRecorder() { return recorder; }
+
+/**
+ * @brief Mean voltage of the motors that could be read, in mV. 0 if none could
+ */
+static std::int32_t averageVoltage(const MotorSnapshot& motors) {
+    std::int32_t sum = 0;
+    int count = 0;
+    for (int i = 0; i < motors.size; i++) {
+        if (!motors.isValid(i)) continue;
+        sum += motors.voltage[i];
+        count++;
+    }
+    return count == 0 ? 0 : sum / count;
+}
+
+void RobotChassis::recordTick(lemlib::Pose target, float lateralError, float lateralPIDOut, float angularError,
+                              float angularPIDOut, float leftPower, float rightPower, std::uint16_t flags) {
+    const lemlib::Pose pose = getPose();
+    // split the PID outputs into their terms. The integral is whatever the other two don't explain
+    const float lateralP = lateralSettings.kP * lateralError;
+    const float lateralD = lateralSettings.kD * (lateralError - prevRecordedLateralError);
+    const float angularP = angularSettings.kP * angularError;
+    const float angularD = angularSettings.kD * (angularError - prevRecordedAngularError);
+    prevRecordedLateralError = lateralError;
+    prevRecordedAngularError = angularError;
+    if (lateralSmallExit.getExit()) flags |= MotionSample::LATERAL_SMALL_EXIT;
+    if (lateralLargeExit.getExit()) flags |= MotionSample::LATERAL_LARGE_EXIT;
+    if (angularSmallExit.getExit()) flags |= MotionSample::ANGULAR_SMALL_EXIT;
+    if (angularLargeExit.getExit()) flags |= MotionSample::ANGULAR_LARGE_EXIT;
+    snapshot(*drivetrain.leftMotors, leftSnapshot, MotorSnapshot::VOLTAGE);
+    snapshot(*drivetrain.rightMotors, rightSnapshot, MotorSnapshot::VOLTAGE);
+    recorder.record({.targetX = target.x,
+                     .targetY = target.y,
+                     .targetTheta = target.theta,
+                     .x = pose.x,
+                     .y = pose.y,
+                     .theta = pose.theta,
+                     .lateralError = lateralError,
+                     .angularError = angularError,
+                     .lateralP = lateralP,
+                     .lateralI = lateralPIDOut - lateralP - lateralD,
+                     .lateralD = lateralD,
+                     .angularP = angularP,
+                     .angularI = angularPIDOut - angularP - angularD,
+                     .angularD = angularD,
+                     .leftCommand = std::int16_t(leftPower * 12000 / 127),
+                     .rightCommand = std::int16_t(rightPower * 12000 / 127),
+                     .leftVoltage = std::int16_t(averageVoltage(leftSnapshot)),
+                     .rightVoltage = std::int16_t(averageVoltage(rightSnapshot)),
+                     .flags = flags});
+}
+
+std::uint32_t RobotChassis::getAllocatingTicks() const { return allocationCheck.getFailedTicks(); }
+
+void RobotChassis::initMotionTask() {
+    if (motionTask != nullptr) return;
+    motionTask = new pros::Task([this] { motionTaskLoop(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+                                "Motion Task");
+}
+
+void RobotChassis::motionTaskLoop() {
+    while (true) {
+        pros::Task::notify_take(true, TIMEOUT_MAX);
+        const Motion motion = pendingMotion;
+        requestMotionStart();
+        // let the caller continue now that this motion is at the front of the queue
+        motionPending = false;
+        // were all motions cancelled?
+        if (!motionRunning) {
+            endMotion();
+            continue;
+        }
+        runMotion(motion);
+    }
+}
+
+void RobotChassis::startMotion(const Motion& motion, bool async) {
+    // take the mutex
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        endMotion();
+        return;
+    }
+    if (!async) {
+        runMotion(motion);
+        return;
+    }
+    // hand the motion over to the motion task
+    initMotionTask();
+    pendingMotion = motion;
+    motionPending = true;
+    motionTask->notify();
+    endMotion();
+    // wait until the motion task has queued the motion, so the next motion is queued after it
+    while (motionPending) pros::delay(1);
+}
+
+void RobotChassis::runMotion(const Motion& motion) {
+    recorder.begin(static_cast<std::uint32_t>(motion.type));
+    // the PIDs are reset at the start of every motion
+    prevRecordedLateralError = 0;
+    prevRecordedAngularError = 0;
+    switch (motion.type) {
+        case Motion::Type::TURN_TO_HEADING:
+            runTurnToHeading(motion.theta, motion.timeout, motion.turnToHeadingParams);
+            break;
+        case Motion::Type::MOVE_TO_POSE:
+            runMoveToPose(motion.x, motion.y, motion.theta, motion.timeout, motion.moveToPoseParams);
+            break;
+        case Motion::Type::MOVE_TO_POINT:
+            runMoveToPoint(motion.x, motion.y, motion.timeout, motion.moveToPointParams);
+            break;
+        case Motion::Type::PROFILED_MOVE:
+            runProfiledMove(motion.x, motion.y, motion.theta, motion.toPose, motion.timeout,
+                            motion.profiledMoveParams);
+            break;
+        case Motion::Type::FOLLOW: runFollow(motion.path, motion.lookahead, motion.timeout, motion.forwards); break;
+    }
+    // stop the drivetrain, unless the next motion is waiting to carry on at the speed this one exited with
+    if (chainPower == 0 || !motionQueued || !motionRunning) {
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+        chainPower = 0;
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    recorder.end();
+    endMotion();
+}
+
+void RobotChassis::turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params, bool async) {
+    startMotion({.type = Motion::Type::TURN_TO_HEADING,
+                 .theta = theta,
+                 .timeout = timeout,
+                 .turnToHeadingParams = params},
+                async);
+}
+
+void RobotChassis::moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params,
+                              bool async) {
+    startMotion(
+        {.type = Motion::Type::MOVE_TO_POSE, .x = x, .y = y, .theta = theta, .timeout = timeout, .moveToPoseParams = params},
+        async);
+}
+
+void RobotChassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params, bool async) {
+    startMotion({.type = Motion::Type::MOVE_TO_POINT, .x = x, .y = y, .timeout = timeout, .moveToPointParams = params},
+                async);
+}
+
+void RobotChassis::profiledMoveToPoint(float x, float y, int timeout, ProfiledMoveParams params, bool async) {
+    startMotion({.type = Motion::Type::PROFILED_MOVE,
+                 .x = x,
+                 .y = y,
+                 .timeout = timeout,
+                 .toPose = false,
+                 .profiledMoveParams = params},
+                async);
+}
+
+void RobotChassis::profiledMoveToPose(float x, float y, float theta, int timeout, ProfiledMoveParams params,
+                                      bool async) {
+    startMotion({.type = Motion::Type::PROFILED_MOVE,
+                 .x = x,
+                 .y = y,
+                 .theta = theta,
+                 .timeout = timeout,
+                 .toPose = true,
+                 .profiledMoveParams = params},
+                async);
+}
+
+void RobotChassis::follow(PathView path, float lookahead, int timeout, bool forwards, bool async) {
+    if (!path.isValid()) {
+        robotLog().error("Can't follow path: {}", path.getError());
+        return;
+    }
+    startMotion(
+        {.type = Motion::Type::FOLLOW, .timeout = timeout, .path = path, .lookahead = lookahead, .forwards = forwards},
+        async);
+}
+
+void RobotChassis::setProfiling(ProfileConstraints constraints, Feedforward feedforward) {
+    profileConstraints = constraints;
+    this->feedforward = feedforward;
+}
+
+void RobotChassis::setFeedforward(Feedforward lateral, Feedforward angular) {
+    feedforward = lateral;
+    angularFeedforward = angular;
+}
+
+void RobotChassis::setControllerSettings(lemlib::ControllerSettings lateralSettings,
+                                         lemlib::ControllerSettings angularSettings) {
+    this->lateralSettings = lateralSettings;
+    this->angularSettings = angularSettings;
+    // the PIDs and exit conditions keep their gains in const members, so they are rebuilt in place, with the same
+    // arguments as the lemlib::Chassis constructor
+    std::destroy_at(&lateralPID);
+    std::construct_at(&lateralPID, lateralSettings.kP, lateralSettings.kI, lateralSettings.kD,
+                      lateralSettings.windupRange, true);
+    std::destroy_at(&angularPID);
+    std::construct_at(&angularPID, angularSettings.kP, angularSettings.kI, angularSettings.kD,
+                      angularSettings.windupRange, true);
+    const std::pair<lemlib::ExitCondition*, std::pair<float, float>> exits[] = {
+        {&lateralLargeExit, {lateralSettings.largeError, lateralSettings.largeErrorTimeout}},
+        {&lateralSmallExit, {lateralSettings.smallError, lateralSettings.smallErrorTimeout}},
+        {&angularLargeExit, {angularSettings.largeError, angularSettings.largeErrorTimeout}},
+        {&angularSmallExit, {angularSettings.smallError, angularSettings.smallErrorTimeout}},
+    };
+    for (const auto& [exit, range] : exits) {
+        std::destroy_at(exit);
+        std::construct_at(exit, range.first, int(range.second));
+    }
+}
+
+void RobotChassis::setDriveCurves(lemlib::DriveCurve* throttleCurve, lemlib::DriveCurve* steerCurve) {
+    this->throttleCurve = throttleCurve;
+    this->steerCurve = steerCurve;
+}
+
+float RobotChassis::takeChainPower(bool forwards) {
+    const float power = chainPower;
+    chainPower = 0;
+    if (forwards ? power < 0 : power > 0) return 0;
+    return power;
+}
+
+/**
+ * @brief Add the power needed to overcome static friction, in the direction of the output
+ *
+ * Only while the error is outside the small error range, so the robot doesn't hunt around the target
+ */
+static float addStaticFriction(float output, float error, float smallError, float kS) {
+    if (output == 0 || std::fabs(error) <= smallError) return output;
+    return output + kS * lemlib::sgn(output);
+}
+
+void RobotChassis::runTurnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params) {
+    float prevMotorPower = 0;
+    const float startTheta = getPose().theta;
+    chainPower = 0; // turning in place can't carry lateral speed
+    bool settling = false;
+    std::optional<float> prevRawDeltaTheta = std::nullopt;
+    std::optional<float> prevDeltaTheta = std::nullopt;
+    const std::uint8_t compState = pros::competition::get_status();
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    angularPID.reset();
+
+    std::uint32_t prevTime = pros::millis();
+    // main loop
+    while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && motionRunning) {
+        CpuZone zone("turnToHeading");
+        // exit if the competition state changed
+        if (pros::competition::get_status() != compState) break;
+        allocationCheck.beginTick();
+
+        // update variables
+        const lemlib::Pose pose = getPose();
+
+        // update completion vars
+        distTraveled = std::fabs(lemlib::angleError(pose.theta, startTheta, false));
+
+        // check if settling
+        const float rawDeltaTheta = lemlib::angleError(theta, pose.theta, false);
+        if (prevRawDeltaTheta == std::nullopt) prevRawDeltaTheta = rawDeltaTheta;
+        if (lemlib::sgn(rawDeltaTheta) != lemlib::sgn(*prevRawDeltaTheta)) settling = true;
+        prevRawDeltaTheta = rawDeltaTheta;
+
+        // calculate deltaTheta
+        const float deltaTheta = settling ? lemlib::angleError(theta, pose.theta, false)
+                                          : lemlib::angleError(theta, pose.theta, false, params.direction);
+        if (prevDeltaTheta == std::nullopt) prevDeltaTheta = deltaTheta;
+
+        // motion chaining
+        if (params.minSpeed != 0 && std::fabs(deltaTheta) < params.earlyExitRange) break;
+        if (params.minSpeed != 0 && lemlib::sgn(deltaTheta) != lemlib::sgn(*prevDeltaTheta)) break;
+
+        // calculate the speed
+        const float angularPIDOut = angularPID.update(deltaTheta);
+        float motorPower = addStaticFriction(angularPIDOut, deltaTheta, angularSettings.smallError,
+                                             angularFeedforward.kS);
+        angularLargeExit.update(deltaTheta);
+        angularSmallExit.update(deltaTheta);
+
+        // cap the speed
+        motorPower = std::clamp<float>(motorPower, -params.maxSpeed, params.maxSpeed);
+        if (std::fabs(deltaTheta) > 20) motorPower = lemlib::slew(motorPower, prevMotorPower, angularSettings.slew);
+        if (motorPower < 0 && motorPower > -params.minSpeed) motorPower = -params.minSpeed;
+        else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
+        prevMotorPower = motorPower;
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(motorPower);
+        drivetrain.rightMotors->move(-motorPower);
+        recordTick(lemlib::Pose(pose.x, pose.y, theta), 0, 0, deltaTheta, angularPIDOut, motorPower, -motorPower,
+                   settling ? MotionSample::SETTLING : 0);
+
+        allocationCheck.endTick();
+        // the wait for the next tick isn't part of it
+        zone.end();
+        pros::Task::delay_until(&prevTime, 10);
+    }
+}
+
+void RobotChassis::runMoveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params) {
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    // calculate target pose in standard form
+    lemlib::Pose target(x, y, M_PI_2 - lemlib::degToRad(theta));
+    if (!params.forwards) target.theta = std::fmod(target.theta + M_PI, 2 * M_PI); // backwards movement
+
+    // use global horizontalDrift is horizontalDrift is 0
+    if (params.horizontalDrift == 0) params.horizontalDrift = drivetrain.horizontalDrift;
+
+    // initialize vars used between iterations
+    lemlib::Pose lastPose = getPose();
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    bool close = false;
+    bool lateralSettled = false;
+    bool prevSameSide = false;
+    float prevLateralOut = takeChainPower(params.forwards); // previous lateral power
+    const std::uint8_t compState = pros::competition::get_status();
+
+    std::uint32_t prevTime = pros::millis();
+    // main loop
+    while (!timer.isDone() &&
+           ((!lateralSettled || (!angularLargeExit.getExit() && !angularSmallExit.getExit())) || !close) &&
+           motionRunning) {
+        CpuZone zone("moveToPose");
+        // exit if the competition state changed
+        if (pros::competition::get_status() != compState) break;
+        allocationCheck.beginTick();
+
+        // update position
+        const lemlib::Pose pose = getPose(true, true);
+
+        // update distance travelled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false) {
+            close = true;
+            params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+        }
+
+        // check if the lateral controller has settled
+        if (lateralLargeExit.getExit() && lateralSmallExit.getExit()) lateralSettled = true;
+
+        // calculate the carrot point
+        lemlib::Pose carrot =
+            target - lemlib::Pose(std::cos(target.theta), std::sin(target.theta)) * params.lead * distTarget;
+        if (close) carrot = target; // settling behavior
+
+        // calculate if the robot is on the same side as the carrot point
+        const bool robotSide = (pose.y - target.y) * -std::sin(target.theta) <=
+                               (pose.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        const bool carrotSide = (carrot.y - target.y) * -std::sin(target.theta) <=
+                                (carrot.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        const bool sameSide = robotSide == carrotSide;
+        // exit if close
+        if (!sameSide && prevSameSide && close && params.minSpeed != 0) break;
+        prevSameSide = sameSide;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = close ? lemlib::angleError(adjustedRobotTheta, target.theta)
+                                         : lemlib::angleError(adjustedRobotTheta, pose.angle(carrot));
+        float lateralError = pose.distance(carrot);
+        // only use cos when settling
+        // otherwise just multiply by the sign of cos
+        // maxSlipSpeed takes care of lateralOut
+        if (close) lateralError *= std::cos(lemlib::angleError(pose.theta, pose.angle(carrot)));
+        else lateralError *= lemlib::sgn(std::cos(lemlib::angleError(pose.theta, pose.angle(carrot))));
+
+        // update exit conditions
+        lateralSmallExit.update(lateralError);
+        lateralLargeExit.update(lateralError);
+        angularSmallExit.update(lemlib::radToDeg(angularError));
+        angularLargeExit.update(lemlib::radToDeg(angularError));
+
+        // get output from PIDs
+        const float lateralPIDOut = lateralPID.update(lateralError);
+        const float angularPIDOut = angularPID.update(lemlib::radToDeg(angularError));
+        float lateralOut = addStaticFriction(lateralPIDOut, lateralError, lateralSettings.smallError, feedforward.kS);
+        float angularOut = angularPIDOut;
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // constrain lateral output by max accel
+        // but not for decelerating, since that would interfere with settling
+        if (!close) lateralOut = lemlib::slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // constrain lateral output by the max speed it can travel at without slipping
+        const float radius = 1 / std::fabs(lemlib::getCurvature(pose, carrot));
+        const float maxSlipSpeed = std::sqrt(params.horizontalDrift * radius * 9.8);
+        lateralOut = std::clamp(lateralOut, -maxSlipSpeed, maxSlipSpeed);
+        // prioritize angular movement over lateral movement
+        const float overturn = std::fabs(angularOut) + std::fabs(lateralOut) - params.maxSpeed;
+        if (overturn > 0) lateralOut -= lateralOut > 0 ? overturn : -overturn;
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0)
+            lateralOut = std::fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -std::fabs(params.minSpeed);
+
+        // update previous output
+        prevLateralOut = lateralOut;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+        recordTick(lemlib::Pose(target.x, target.y, 90 - lemlib::radToDeg(target.theta)), lateralError, lateralPIDOut,
+                   lemlib::radToDeg(angularError), angularPIDOut, leftPower, rightPower,
+                   close ? MotionSample::CLOSE : 0);
+
+        allocationCheck.endTick();
+        // the wait for the next tick isn't part of it
+        zone.end();
+        pros::Task::delay_until(&prevTime, 10);
+    }
+
+    // carry the speed over to the next motion if chaining
+    if (params.minSpeed != 0) chainPower = prevLateralOut;
+}
+
+void RobotChassis::runMoveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params) {
+    params.earlyExitRange = std::fabs(params.earlyExitRange);
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+
+    // initialize vars used between iterations
+    lemlib::Pose lastPose = getPose();
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    bool close = false;
+    float prevLateralOut = takeChainPower(params.forwards); // previous lateral power
+    const std::uint8_t compState = pros::competition::get_status();
+    std::optional<bool> prevSide = std::nullopt;
+
+    // calculate target pose in standard form
+    lemlib::Pose target(x, y);
+    target.theta = lastPose.angle(target);
+
+    std::uint32_t prevTime = pros::millis();
+    // main loop
+    while (!timer.isDone() && ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) &&
+           motionRunning) {
+        CpuZone zone("moveToPoint");
+        // exit if the competition state changed
+        if (pros::competition::get_status() != compState) break;
+        allocationCheck.beginTick();
+
+        // update position
+        const lemlib::Pose pose = getPose(true, true);
+
+        // update distance traveled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false) {
+            close = true;
+            params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+        }
+
+        // motion chaining
+        const bool side = (pose.y - target.y) * -std::sin(target.theta) <=
+                          (pose.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        if (prevSide == std::nullopt) prevSide = side;
+        const bool sameSide = side == prevSide;
+        // exit if close
+        if (!sameSide && params.minSpeed != 0) break;
+        prevSide = side;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = lemlib::angleError(adjustedRobotTheta, pose.angle(target));
+        const float lateralError = distTarget * std::cos(lemlib::angleError(pose.theta, pose.angle(target)));
+
+        // update exit conditions
+        lateralSmallExit.update(lateralError);
+        lateralLargeExit.update(lateralError);
+
+        // get output from PIDs
+        const float lateralPIDOut = lateralPID.update(lateralError);
+        const float angularPIDOut = angularPID.update(lemlib::radToDeg(angularError));
+        float lateralOut = addStaticFriction(lateralPIDOut, lateralError, lateralSettings.smallError, feedforward.kS);
+        float angularOut = angularPIDOut;
+        if (close) angularOut = 0;
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+
+        // constrain lateral output by max accel
+        if (!close) lateralOut = lemlib::slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0)
+            lateralOut = std::fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -std::fabs(params.minSpeed);
+
+        // update previous output
+        prevLateralOut = lateralOut;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+        recordTick(lemlib::Pose(target.x, target.y, 90 - lemlib::radToDeg(target.theta)), lateralError, lateralPIDOut,
+                   lemlib::radToDeg(angularError), angularPIDOut, leftPower, rightPower,
+                   close ? MotionSample::CLOSE : 0);
+
+        allocationCheck.endTick();
+        // the wait for the next tick isn't part of it
+        zone.end();
+        pros::Task::delay_until(&prevTime, 10);
+    }
+
+    // carry the speed over to the next motion if chaining
+    if (params.minSpeed != 0) chainPower = prevLateralOut;
+}
+
+void RobotChassis::runProfiledMove(float x, float y, float theta, bool toPose, int timeout, ProfiledMoveParams params) {
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    // calculate target pose in standard form
+    lemlib::Pose lastPose = getPose(true, true);
+    lemlib::Pose target(x, y);
+    target.theta = toPose ? M_PI_2 - lemlib::degToRad(theta) : lastPose.angle(target);
+    if (toPose && !params.forwards) target.theta = std::fmod(target.theta + M_PI, 2 * M_PI); // backwards movement
+
+    // generate the profile, scaled down by the max speed. It starts at the speed the last motion exited with
+    const float powerToVel = profileConstraints.maxVel / 127;
+    ProfileConstraints constraints = profileConstraints;
+    constraints.maxVel *= std::clamp<float>(params.maxSpeed, 0, 127) / 127;
+    const float startVel = std::fabs(takeChainPower(params.forwards)) * powerToVel;
+    const float endVel = std::clamp<float>(params.exitSpeed, 0, 127) * powerToVel;
+    const MotionProfile profile(lastPose.distance(target), constraints, startVel, endVel);
+    const float direction = params.forwards ? 1 : -1;
+    const bool chaining = params.exitSpeed != 0;
+    float prevLateralOut = 0;
+
+    // initialize vars used between iterations
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    bool close = false;
+    const std::uint8_t compState = pros::competition::get_status();
+    const std::uint64_t startTime = pros::micros();
+
+    std::uint32_t prevTime = pros::millis();
+    // main loop
+    while (!timer.isDone() && motionRunning) {
+        CpuZone zone("profiledMove");
+        // exit if the competition state changed
+        if (pros::competition::get_status() != compState) break;
+        allocationCheck.beginTick();
+
+        // update position
+        const lemlib::Pose pose = getPose(true, true);
+
+        // update distance travelled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // where the profile says the robot should be
+        const float t = (pros::micros() - startTime) / 1000000.0f;
+        const MotionProfile::State reference = profile.sample(t);
+        const bool profileDone = t >= profile.getDuration();
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+        if (distTarget < 7.5) close = true;
+
+        // calculate the carrot point
+        lemlib::Pose carrot = target;
+        if (toPose && !close)
+            carrot = target - lemlib::Pose(std::cos(target.theta), std::sin(target.theta)) * params.lead * distTarget;
+
+        // signed distance left to travel, and how far behind the profile the robot is
+        const float remaining = distTarget * std::cos(lemlib::angleError(pose.theta, pose.angle(carrot)));
+        const float trackingError = remaining - direction * (profile.getDistance() - reference.position);
+
+        // motion chaining. Hand over to the next motion once in the exit range, or once past the target
+        if (chaining && (direction * remaining < params.exitRange || profileDone)) {
+            allocationCheck.endTick();
+            break;
+        }
+
+        // calculate angular error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = toPose && close ? lemlib::angleError(adjustedRobotTheta, target.theta)
+                                                   : lemlib::angleError(adjustedRobotTheta, pose.angle(carrot));
+
+        // once the profile is done, settle on the target
+        if (profileDone) {
+            lateralSmallExit.update(remaining);
+            lateralLargeExit.update(remaining);
+            angularSmallExit.update(lemlib::radToDeg(angularError));
+            angularLargeExit.update(lemlib::radToDeg(angularError));
+            const bool lateralSettled = lateralSmallExit.getExit() || lateralLargeExit.getExit();
+            const bool angularSettled = angularSmallExit.getExit() || angularLargeExit.getExit();
+            if (lateralSettled && (!toPose || angularSettled)) {
+                allocationCheck.endTick();
+                break;
+            }
+        }
+
+        // feedforward from the profile, plus feedback on the tracking error
+        const float lateralPIDOut = lateralPID.update(trackingError);
+        const float angularPIDOut = angularPID.update(lemlib::radToDeg(angularError));
+        float lateralOut =
+            direction * feedforward.calculate(reference.velocity, reference.acceleration) + lateralPIDOut;
+        float angularOut = angularPIDOut;
+        if (!toPose && close) angularOut = 0;
+
+        // apply restrictions on speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+        prevLateralOut = lateralOut;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+        recordTick(lemlib::Pose(target.x, target.y, 90 - lemlib::radToDeg(target.theta)), trackingError,
+                   lateralPIDOut, lemlib::radToDeg(angularError), angularPIDOut, leftPower, rightPower,
+                   close ? MotionSample::CLOSE : 0);
+
+        allocationCheck.endTick();
+        // the wait for the next tick isn't part of it
+        zone.end();
+        pros::Task::delay_until(&prevTime, 10);
+    }
+
+    // carry the speed over to the next motion if chaining
+    if (chaining) chainPower = prevLateralOut;
+}
+
+void RobotChassis::runFollow(const PathView& path, float lookahead, int timeout, bool forwards) {
+    lemlib::Pose lastPose = getPose(true, true);
+    lemlib::Pose lookaheadPose(path[0].x, path[0].y);
+    std::size_t lookaheadIndex = 0;
+    pathIndex.build(path);
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    const std::uint8_t compState = pros::competition::get_status();
+    chainPower = 0;
+
+    std::uint32_t prevTime = pros::millis();
+    // main loop
+    while (!timer.isDone() && motionRunning) {
+        CpuZone zone("follow");
+        // exit if the competition state changed
+        if (pros::competition::get_status() != compState) break;
+        allocationCheck.beginTick();
+
+        // get the current position of the robot
+        lemlib::Pose pose = getPose(true, true);
+        if (!forwards) pose.theta += M_PI;
+
+        // update completion vars
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // find the closest point on the path to the robot. Search the whole path if the robot is further than the
+        // lookahead distance from where it was
+        const PathIndex::Closest closest = pathIndex.findClosest(pose.x, pose.y, lookahead);
+        // the last point of the path has a speed of 0
+        const float targetVel = path[closest.index].speed;
+        if (targetVel == 0) {
+            allocationCheck.endTick();
+            break;
+        }
+
+        // find the lookahead point. Only consider intersections past the closest point and the last lookahead point.
+        // If the robot deviated from the path, keep the last lookahead point
+        const std::optional<PathIndex::Lookahead> intersection =
+            pathIndex.findLookahead(pose.x, pose.y, lookahead, closest, lookaheadIndex);
+        if (intersection) {
+            lookaheadPose = lemlib::Pose(intersection->x, intersection->y);
+            lookaheadIndex = intersection->index;
+        }
+
+        // get the curvature of the arc between the robot and the lookahead point
+        const float curvature = lemlib::getCurvature(pose, lookaheadPose);
+
+        // calculate target left and right velocities
+        float targetLeftVel = targetVel * (2 + curvature * drivetrain.trackWidth) / 2;
+        float targetRightVel = targetVel * (2 - curvature * drivetrain.trackWidth) / 2;
+
+        // ratio the speeds to respect the max speed
+        const float ratio = std::max(std::fabs(targetLeftVel), std::fabs(targetRightVel)) / 127;
+        if (ratio > 1) {
+            targetLeftVel /= ratio;
+            targetRightVel /= ratio;
+        }
+
+        // move the drivetrain
+        if (forwards) {
+            drivetrain.leftMotors->move(targetLeftVel);
+            drivetrain.rightMotors->move(targetRightVel);
+            recordTick(lemlib::Pose(lookaheadPose.x, lookaheadPose.y, NAN), 0, 0, 0, 0, targetLeftVel, targetRightVel);
+        } else {
+            drivetrain.leftMotors->move(-targetRightVel);
+            drivetrain.rightMotors->move(-targetLeftVel);
+            recordTick(lemlib::Pose(lookaheadPose.x, lookaheadPose.y, NAN), 0, 0, 0, 0, -targetRightVel,
+                       -targetLeftVel);
+        }
+
+        allocationCheck.endTick();
+        // the wait for the next tick isn't part of it
+        zone.end();
+        pros::Task::delay_until(&prevTime, 10);
+    }
+}
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <atomic>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "AllocationCheck.hpp"
+#include "Calibration.hpp"
+#include "MotionProfile.hpp"
+#include "MotionRecorder.hpp"
+#include "MotorSnapshot.hpp"
+#include "OdomScheduler.hpp"
+#include "PathAsset.hpp"
+#include "PathIndex.hpp"
+
+/**
+ * @brief Parameters for RobotChassis::profiledMoveToPoint and RobotChassis::profiledMoveToPose
+ *
+ * The profiled motions take the same optional parameters as their lemlib counterparts, plus the exit speed for
+ * chaining, so they are passed by name in a struct instead of as a long list of arguments
+ */
+struct ProfiledMoveParams {
+        /** whether the robot should move forwards or backwards. True by default */
+        bool forwards = true;
+        /** carrot point multiplier, only used by profiledMoveToPose. value between 0 and 1. Higher values result in
+         * curvier movements. 0.6 by default */
+        float lead = 0.6;
+        /** the maximum speed the robot can travel at. Value between 0-127. Scales the maximum velocity of the
+         * profile. 127 by default */
+        float maxSpeed = 127;
+        /** the speed the robot should be travelling at when the movement exits, for motion chaining. Value between
+         * 0-127. 0 by default */
+        float exitSpeed = 0;
+        /** distance between the robot and target point where the movement will exit and hand over to the next
+         * motion. Only has an effect if exitSpeed is non-zero. 0 by default */
+        float exitRange = 0;
+};
+
+/**
+ * @brief The robot's chassis
+ *
+ * Extends lemlib::Chassis with the features we need that LemLib does not provide. Everything lemlib::Chassis can
+ * do is still available.
+ *
+ * moveToPoint, moveToPose and turnToHeading are reimplemented here so their control loops never touch the heap once
+ * the chassis is calibrated. Asynchronous motions are run by a single motion task that is created once, instead of
+ * a new task per motion.
+ *
+ * Motions are chained: when a motion exits early (a non-zero minSpeed or exitSpeed) and another motion is already
+ * queued, the drivetrain is not stopped, and the next motion starts from the speed the last one exited with instead
+ * of accelerating from 0 again.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // drive through (0, 24) at full speed, then curve into (24, 48) without stopping in between
+ * chassis.profiledMoveToPoint(0, 24, 2000, {.exitSpeed = 127, .exitRange = 4});
+ * chassis.profiledMoveToPose(24, 48, 90, 2000);
+ * @endcode
+ */
+class RobotChassis : public lemlib::Chassis {
+    public:
+        /**
+         * @brief RobotChassis constructor
+         *
+         * @param drivetrain drivetrain to be used for the chassis
+         * @param lateralSettings settings for the lateral controller
+         * @param angularSettings settings for the angular controller
+         * @param sensors sensors to be used for odometry
+         * @param odomScheduler scheduler that runs odometry once the chassis is calibrated
+         * @param throttleCurve curve applied to throttle input during driver control
+         * @param steerCurve curve applied to steer input during driver control
+         */
+        RobotChassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings lateralSettings,
+                     lemlib::ControllerSettings angularSettings, lemlib::OdomSensors sensors,
+                     OdomScheduler* odomScheduler, lemlib::DriveCurve* throttleCurve = &lemlib::defaultDriveCurve,
+                     lemlib::DriveCurve* steerCurve = &lemlib::defaultDriveCurve);
+        /**
+         * @brief Calibrate the chassis sensors. This should be called in the initialize function
+         *
+         * Does the same as lemlib::Chassis::calibrate, except odometry is run by the OdomScheduler instead of
+         * LemLib's own tracking task. Blocks until calibration finishes, use calibrateAsync to keep initialize short
+         *
+         * @param calibrateIMU whether the IMU should be calibrated. true by default
+         */
+        void calibrate(bool calibrateIMU = true);
+        /**
+         * @brief Calibrate the chassis sensors in the background
+         *
+         * The tracking wheels are reset straight away, and the IMU calibrates in a separate task, so initialize
+         * returns and competition_initialize and the brain screen keep running while it settles. An ImuArray
+         * calibrates all of its IMUs at the same time. Each IMU attempt that reports an error or runs past the
+         * timeout is retried, and if every attempt fails odometry runs without the IMU, like calibrate.
+         *
+         * Odometry starts once calibration finishes. Wait for it before starting any motion. Calling this again
+         * while calibration is running, or after it finished, returns the same handle.
+         *
+         * @param settings struct to simulate named parameters
+         * @return CalibrationHandle& the progress of the calibration
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     CalibrationHandle& calibration = chassis.calibrateAsync();
+         *     while (!calibration.isDone()) {
+         *         pros::lcd::print(0, "Calibrating: %.0f%%", calibration.getProgress() * 100);
+         *         pros::delay(50);
+         *     }
+         *     if (!calibration.succeeded()) pros::lcd::print(1, "IMU failed, using the wheels for heading");
+         * }
+         * @endcode
+         */
+        CalibrationHandle& calibrateAsync(CalibrationSettings settings = {});
+        /**
+         * @brief Get the progress of the calibration started by calibrate or calibrateAsync
+         */
+        const CalibrationHandle& getCalibration() const;
+        /**
+         * @brief Turn the chassis so it is facing the target heading
+         *
+         * Same as lemlib::Chassis::turnToHeading
+         *
+         * @param theta heading location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis towards the target pose
+         *
+         * Same as lemlib::Chassis::moveToPose. Uses the boomerang controller
+         *
+         * @param x x location
+         * @param y y location
+         * @param theta target heading in degrees.
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params = {},
+                        bool async = true);
+        /**
+         * @brief Move the chassis towards a target point
+         *
+         * Same as lemlib::Chassis::moveToPoint
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis to a target point, following a motion profile
+         *
+         * Instead of running PID on the distance to the target, a time-optimal velocity profile is generated from the
+         * start of the motion to the target. Each tick the lateral output is the feedforward of the profile's
+         * velocity and acceleration, plus the lateral PID on the error between where the profile says the robot
+         * should be and where it is. The profile decelerates smoothly to the target, so there is no overshoot.
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.setPose(0, 0, 0);
+         * // move to x = 0, y = 48 following a motion profile
+         * chassis.profiledMoveToPoint(0, 48, 2000);
+         * @endcode
+         */
+        void profiledMoveToPoint(float x, float y, int timeout, ProfiledMoveParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis to a target pose, following a motion profile
+         *
+         * Same as profiledMoveToPoint, but steers with the boomerang controller like moveToPose. The profile length
+         * is the straight line distance to the target, so it underestimates curvy paths; the lateral PID makes up
+         * the difference
+         *
+         * @param x x location
+         * @param y y location
+         * @param theta target heading in degrees.
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void profiledMoveToPose(float x, float y, float theta, int timeout, ProfiledMoveParams params = {},
+                                bool async = true);
+        /**
+         * @brief Set the limits and feedforward used by profiled motions
+         *
+         * By default the limits are derived from the drivetrain with ProfileConstraints::fromDrivetrain, and the
+         * feedforward maps the drivetrain's free speed to full power
+         *
+         * @param constraints velocity, acceleration and jerk limits
+         * @param feedforward feedforward gains
+         */
+        void setProfiling(ProfileConstraints constraints, Feedforward feedforward);
+        /**
+         * @brief Set the feedforward of the drivetrain, usually measured by a DriveCharacterizer
+         *
+         * Profiled motions use all of the lateral gains. The other motions have no velocity to follow, so they only
+         * add kS, to get the drivetrain moving while the error is outside the small error range
+         *
+         * @param lateral feedforward for driving, in power per inch per second
+         * @param angular feedforward for turning in place, in power per degree per second
+         */
+        void setFeedforward(Feedforward lateral, Feedforward angular);
+        /**
+         * @brief Replace the settings of the lateral and angular controllers
+         *
+         * The PIDs and exit conditions are rebuilt from the new settings, so this must not be called during a motion.
+         * Used to try gains without rebuilding, like the simulator's parameter sweeps
+         *
+         * @param lateralSettings settings for the lateral controller
+         * @param angularSettings settings for the angular controller
+         */
+        void setControllerSettings(lemlib::ControllerSettings lateralSettings,
+                                   lemlib::ControllerSettings angularSettings);
+        /**
+         * @brief Replace the curves applied to driver control input
+         *
+         * @param throttleCurve curve applied to throttle input during driver control
+         * @param steerCurve curve applied to steer input during driver control
+         */
+        void setDriveCurves(lemlib::DriveCurve* throttleCurve, lemlib::DriveCurve* steerCurve);
+        // a binary path overload would hide lemlib's follow of text paths
+        using lemlib::Chassis::follow;
+        /**
+         * @brief Move the chassis along a binary path
+         *
+         * Same pure pursuit as lemlib::Chassis::follow, but the path is read in place from a binary path asset, so
+         * starting the motion doesn't parse or allocate anything. Convert path.jerryio paths with `make paths`. The
+         * asset is checked once, when its PathView is made, not every time it is followed
+         *
+         * @param path the path to follow
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move
+         * faster but will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // "static/myPath.bin" is generated from "static/myPath.txt"
+         * ASSET(myPath_bin);
+         * PathView myPath(myPath_bin);
+         *
+         * void autonomous() {
+         *     // follow the path with a lookahead of 10 inches and a timeout of 4000ms
+         *     chassis.follow(myPath, 10, 4000);
+         * }
+         * @endcode
+         */
+        void follow(PathView path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Get the scheduler running odometry
+         */
+        OdomScheduler& getOdomScheduler();
+        /**
+         * @brief Get the recorder that captures every tick of every motion
+         */
+        MotionRecorder& getRecorder();
+        /**
+         * @brief Get the number of motion ticks that allocated on the heap
+         *
+         * @note always 0 unless the project is built with -DALLOCATION_CHECKS
+         */
+        std::uint32_t getAllocatingTicks() const;
+    protected:
+        /**
+         * @brief A motion to be run, with all of its parameters
+         */
+        struct Motion {
+                enum class Type { TURN_TO_HEADING, MOVE_TO_POSE, MOVE_TO_POINT, PROFILED_MOVE, FOLLOW };
+
+                Type type = Type::MOVE_TO_POINT;
+                float x = 0;
+                float y = 0;
+                float theta = 0;
+                int timeout = 0;
+                lemlib::TurnToHeadingParams turnToHeadingParams = {};
+                lemlib::MoveToPoseParams moveToPoseParams = {};
+                lemlib::MoveToPointParams moveToPointParams = {};
+                /** whether a profiled move should end at a pose, or at a point */
+                bool toPose = false;
+                ProfiledMoveParams profiledMoveParams = {};
+                PathView path = {};
+                float lookahead = 0;
+                /** whether a path should be followed forwards */
+                bool forwards = true;
+        };
+
+        /**
+         * @brief Start running a motion. Blocks until it is the motion's turn to run, like the lemlib motions
+         *
+         * @param motion the motion to run
+         * @param async whether the motion should be run by the motion task instead of the calling task
+         */
+        void startMotion(const Motion& motion, bool async);
+        /**
+         * @brief Run a motion. The motion must be at the front of the queue
+         */
+        void runMotion(const Motion& motion);
+        /**
+         * @brief The function run inside the motion task
+         */
+        void motionTaskLoop();
+        /**
+         * @brief Create the motion task if it doesn't exist yet
+         */
+        void initMotionTask();
+        /**
+         * @brief Calibrate the sensors and start odometry. Run by the calibration task
+         */
+        void runCalibration(CalibrationSettings settings);
+        /**
+         * @brief Calibrate the IMU, retrying until it succeeds or runs out of attempts
+         */
+        void calibrateImu(CalibrationSettings settings);
+
+        void runTurnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params);
+        void runMoveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params);
+        void runMoveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params);
+        void runProfiledMove(float x, float y, float theta, bool toPose, int timeout, ProfiledMoveParams params);
+        void runFollow(const PathView& path, float lookahead, int timeout, bool forwards);
+        /**
+         * @brief Take the lateral power the previous motion exited with, if it is in the direction of travel
+         *
+         * @param forwards whether the new motion moves forwards
+         * @return float the carried lateral power, between -127 and 127. 0 if there is nothing to carry over
+         */
+        float takeChainPower(bool forwards);
+        /**
+         * @brief Record a tick of the current motion. Reads the pose, exit conditions and motor voltages itself
+         *
+         * @param target the target, in inches and degrees like getPose()
+         * @param lateralError error given to the lateral PID, in inches
+         * @param lateralPIDOut output of the lateral PID, before any limits
+         * @param angularError error given to the angular PID, in degrees
+         * @param angularPIDOut output of the angular PID, before any limits
+         * @param leftPower power sent to the left motors, between -127 and 127
+         * @param rightPower power sent to the right motors, between -127 and 127
+         * @param flags MotionSample::CLOSE and MotionSample::SETTLING
+         */
+        void recordTick(lemlib::Pose target, float lateralError, float lateralPIDOut, float angularError,
+                        float angularPIDOut, float leftPower, float rightPower, std::uint16_t flags = 0);
+
+        OdomScheduler* odomScheduler;
+
+        ProfileConstraints profileConstraints;
+        Feedforward feedforward;
+        /** only kS is used, since turns have no velocity to follow */
+        Feedforward angularFeedforward;
+        /** lateral power the last motion exited with, carried over to the next motion. 0 if it stopped */
+        float chainPower = 0;
+        /** index of the path being followed */
+        PathIndex pathIndex;
+
+        MotionRecorder recorder;
+        /** errors recorded last tick, to split the PID outputs into their terms */
+        float prevRecordedLateralError = 0;
+        float prevRecordedAngularError = 0;
+        /** voltages of the drive motors, read once per recorded tick */
+        MotorSnapshot leftSnapshot;
+        MotorSnapshot rightSnapshot;
+
+        CalibrationHandle calibration;
+        pros::Task* calibrationTask = nullptr;
+
+        pros::Task* motionTask = nullptr;
+        Motion pendingMotion = {};
+        std::atomic<bool> motionPending = false;
+
+        AllocationCheck allocationCheck {"RobotChassis motion"};
+};
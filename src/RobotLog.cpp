@@ -0,0 +1,36 @@
+#include <mutex>
+#include "LogBuffer.hpp"
+#include "RobotLog.hpp"
+
+/** names of the levels, in lemlib::Level order */
+static const char* const LEVEL_NAMES[] = {"INFO", "DEBUG", "WARN", "ERROR", "FATAL"};
+
+RobotLog::RobotLog(std::initializer_list<Output> outputs) {
+    for (const Output& output : outputs) addOutput(output);
+}
+
+bool RobotLog::addOutput(Output output) {
+    std::lock_guard<pros::Mutex> lock(outputMutex);
+    const std::size_t index = outputCount;
+    if (index >= MAX_OUTPUTS) return false;
+    outputs[index] = std::move(output);
+    // publish the output after it has been stored
+    outputCount.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+bool RobotLog::addSink(std::shared_ptr<lemlib::BaseSink> sink) {
+    return addOutput([sink = std::move(sink)](lemlib::Level level, std::uint32_t, std::string_view message) {
+        sink->log(level, "{}", message);
+    });
+}
+
+void RobotLog::setLowestLevel(lemlib::Level level) { lowestLevel = level; }
+
+RobotLog& robotLog() {
+    // warnings and errors take the priority lane of the buffer, so they aren't held back behind telemetry
+    static RobotLog log({[](lemlib::Level level, std::uint32_t, std::string_view message) {
+        bufferedLog().print(logLane(level), "[{}] {}\n", LEVEL_NAMES[static_cast<int>(level)], message);
+    }});
+    return log;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/baseSink.hpp"
+
+/**
+ * @brief The lowest level of RobotLog calls that is compiled in
+ *
+ * Set it with a level name, for example -DROBOT_LOG_FLOOR=WARN in EXTRA_CXXFLAGS, to remove every INFO and DEBUG call
+ * of the project from a competition build. Levels are in lemlib::Level order, where INFO is below DEBUG. The arguments
+ * of a removed call are still evaluated, but nothing is formatted or sent.
+ */
+#ifndef ROBOT_LOG_FLOOR
+#define ROBOT_LOG_FLOOR INFO
+#endif
+
+/**
+ * @brief The project's logger, with a compile time floor and one formatting for every output
+ *
+ * LemLib's sinks live in the prebuilt library, so they can't be changed without breaking it: a combined sink formats
+ * the message again for every sink it holds, and checks the level only after building the format arguments. This
+ * logger checks the floor at compile time, then the lowest level at run time, before anything is formatted. A message
+ * that passes is formatted once into the stack, never a std::string, and the same text goes to every output.
+ *
+ * Calls inside LemLib still go to lemlib::infoSink, and aren't affected by the floor. robotLog() writes to
+ * bufferedLog(), with warnings and above in its priority lane.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     robotLog().info("battery at {} V", pros::battery::get_voltage() / 1000.0);
+ *     // only warnings and above from here on
+ *     robotLog().setLowestLevel(lemlib::Level::WARN);
+ * }
+ * @endcode
+ */
+class RobotLog {
+    public:
+        /** the lowest level that is compiled in, see ROBOT_LOG_FLOOR */
+        static constexpr lemlib::Level FLOOR = lemlib::Level::ROBOT_LOG_FLOOR;
+        /** most outputs a logger can have */
+        static constexpr std::size_t MAX_OUTPUTS = 4;
+        /** longest message, in bytes. Longer messages are cut short */
+        static constexpr std::size_t MAX_MESSAGE = 256;
+
+        /**
+         * @brief Receives every message that passes the level checks
+         *
+         * @param level the level of the message
+         * @param time milliseconds since the program started
+         * @param message the formatted message, without a newline
+         */
+        using Output = std::function<void(lemlib::Level level, std::uint32_t time, std::string_view message)>;
+
+        /**
+         * @brief Construct a new RobotLog
+         *
+         * @param outputs where messages go
+         */
+        RobotLog(std::initializer_list<Output> outputs = {});
+        RobotLog(const RobotLog&) = delete;
+        RobotLog& operator=(const RobotLog&) = delete;
+        /**
+         * @brief Add an output. Safe while other tasks are logging
+         *
+         * @return false if the logger has MAX_OUTPUTS already
+         */
+        bool addOutput(Output output);
+        /**
+         * @brief Add a LemLib sink as an output, which applies its own format and level to the message
+         *
+         * @return false if the logger has MAX_OUTPUTS already
+         */
+        bool addSink(std::shared_ptr<lemlib::BaseSink> sink);
+        /**
+         * @brief Set the lowest level that is logged. INFO by default. Levels below the floor are never logged
+         */
+        void setLowestLevel(lemlib::Level level);
+        /**
+         * @brief Log a message, if its level is at or above the lowest level
+         */
+        template <typename... T> void log(lemlib::Level level, fmt::format_string<T...> format, T&&... args) {
+            if (level < lowestLevel.load(std::memory_order_relaxed)) return;
+            const std::size_t count = outputCount.load(std::memory_order_acquire);
+            if (count == 0) return;
+            char message[MAX_MESSAGE];
+            const auto result = fmt::format_to_n(message, sizeof(message), format, std::forward<T>(args)...);
+            const std::string_view text(message, std::min(result.size, sizeof(message)));
+            const std::uint32_t time = pros::millis();
+            for (std::size_t i = 0; i < count; i++) outputs[i](level, time, text);
+        }
+
+        template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (lemlib::Level::DEBUG >= FLOOR) log(lemlib::Level::DEBUG, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (lemlib::Level::INFO >= FLOOR) log(lemlib::Level::INFO, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (lemlib::Level::WARN >= FLOOR) log(lemlib::Level::WARN, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (lemlib::Level::ERROR >= FLOOR) log(lemlib::Level::ERROR, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (lemlib::Level::FATAL >= FLOOR) log(lemlib::Level::FATAL, format, std::forward<T>(args)...);
+        }
+    private:
+        pros::Mutex outputMutex;
+        std::array<Output, MAX_OUTPUTS> outputs = {};
+        std::atomic<std::size_t> outputCount = 0;
+        std::atomic<lemlib::Level> lowestLevel = lemlib::Level::INFO;
+};
+
+/**
+ * @brief Get the project's logger. Sends to bufferedLog() by default, so logging never waits for stdout
+ */
+RobotLog& robotLog();
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * The binary log format written by SdLogSink, shared by the robot and the host decoder. This doesn't depend on PROS.
+ *
+ * A log file is a file header, padded with zeros to SDLOG_BLOCK_SIZE so every block after it starts on a block
+ * boundary of the card, followed by blocks of exactly SDLOG_BLOCK_SIZE bytes. Each block is a block header, then
+ * whole records, then zeros to the end of the block: a record never spans two blocks, so a decoder can skip a damaged
+ * block and carry on with the next one. Each record is a record header followed by its payload.
+ *
+ * Text records hold a log message, with its level in the flags. Any other type is a binary record written with
+ * SdLogSink::write, whose payload is whatever struct the program wrote. Everything is little endian.
+ */
+
+/** size of a block, in bytes */
+constexpr std::uint32_t SDLOG_BLOCK_SIZE = 4096;
+
+/**
+ * @brief Type of a record. Types from FIRST_USER up are free for the program's own records
+ */
+enum class SdLogRecordType : std::uint8_t { TEXT = 0, FIRST_USER = 16 };
+
+/**
+ * @brief At the start of each file, in a block of its own
+ */
+struct SdLogFileHeader {
+        /** "SLOG" */
+        static constexpr std::uint32_t MAGIC = 0x474F4C53;
+        static constexpr std::uint16_t VERSION = 2;
+
+        std::uint32_t magic = MAGIC;
+        std::uint16_t version = VERSION;
+        std::uint16_t reserved = 0;
+        std::uint32_t blockSize = SDLOG_BLOCK_SIZE;
+        /** number of the file, counting up from 0 with every run and every rotation */
+        std::uint32_t run = 0;
+};
+
+static_assert(sizeof(SdLogFileHeader) == 16, "SdLogFileHeader must not have padding");
+
+/**
+ * @brief At the start of each block
+ */
+struct SdLogBlockHeader {
+        /** number of the block in the file. A gap means blocks were dropped */
+        std::uint32_t sequence = 0;
+        /** bytes used in the block, including this header */
+        std::uint16_t used = 0;
+        /** number of records in the block */
+        std::uint16_t count = 0;
+};
+
+static_assert(sizeof(SdLogBlockHeader) == 8, "SdLogBlockHeader must not have padding");
+
+/**
+ * @brief Before each record
+ */
+struct SdLogRecordHeader {
+        /** size of the payload, in bytes */
+        std::uint16_t size = 0;
+        /** SdLogRecordType, or the program's own type */
+        std::uint8_t type = 0;
+        /** the lemlib::Level of a text record. Free for binary records */
+        std::uint8_t flags = 0;
+        /** milliseconds since the program started */
+        std::uint32_t time = 0;
+};
+
+static_assert(sizeof(SdLogRecordHeader) == 8, "SdLogRecordHeader must not have padding");
+
+/** largest payload of a record, in bytes */
+constexpr std::uint32_t SDLOG_MAX_RECORD = SDLOG_BLOCK_SIZE - sizeof(SdLogBlockHeader) - sizeof(SdLogRecordHeader);
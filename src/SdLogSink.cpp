@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include "pros/misc.hpp"
+#include "RobotLog.hpp"
+#include "SdLogSink.hpp"
+
+SdLogSink::SdLogSink(const char* prefix, SdLogSettings settings)
+    : prefix(prefix),
+      settings(settings) {
+    // the time and level are in the record header, so only the message is formatted
+    setFormat("{message}");
+    setLowestLevel(lemlib::Level::INFO);
+    activeHeader.used = sizeof(SdLogBlockHeader);
+}
+
+void SdLogSink::start() {
+    if (writerTask != nullptr) return;
+    // below the control loops, writing to the SD card can take a while
+    writerTask = new pros::Task([this] { writerLoop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "SD Log");
+}
+
+void SdLogSink::rotate() {
+    rotateRequested = true;
+    if (writerTask != nullptr) writerTask->notify();
+}
+
+bool SdLogSink::write(SdLogRecordType type, const void* data, std::size_t size, std::uint8_t flags) {
+    if (size > SDLOG_MAX_RECORD) {
+        dropped++;
+        return false;
+    }
+    SdLogRecordHeader header;
+    header.size = size;
+    header.type = static_cast<std::uint8_t>(type);
+    header.flags = flags;
+    header.time = pros::millis();
+    return append(header, data);
+}
+
+bool SdLogSink::writeText(lemlib::Level level, std::uint32_t time, std::string_view message) {
+    SdLogRecordHeader header;
+    header.size = std::min<std::size_t>(message.size(), SDLOG_MAX_RECORD);
+    header.type = static_cast<std::uint8_t>(SdLogRecordType::TEXT);
+    header.flags = static_cast<std::uint8_t>(level);
+    header.time = time;
+    return append(header, message.data());
+}
+
+void SdLogSink::sendMessage(const lemlib::Message& message) { writeText(message.level, message.time, message.message); }
+
+std::uint32_t SdLogSink::getDropped() const { return dropped; }
+
+std::uint32_t SdLogSink::getBlocksWritten() const { return blocksWritten; }
+
+std::uint32_t SdLogSink::getRun() const { return run; }
+
+bool SdLogSink::append(const SdLogRecordHeader& header, const void* data) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (activeHeader.used + sizeof(header) + header.size > SDLOG_BLOCK_SIZE && !swap()) {
+        dropped++;
+        return false;
+    }
+    std::uint8_t* end = blocks[active].data() + activeHeader.used;
+    std::memcpy(end, &header, sizeof(header));
+    std::memcpy(end + sizeof(header), data, header.size);
+    activeHeader.used += sizeof(header) + header.size;
+    activeHeader.count++;
+    return true;
+}
+
+bool SdLogSink::swap() {
+    const std::size_t other = 1 - active;
+    if (full[other]) return false;
+    activeHeader.sequence = sequence++;
+    std::memcpy(blocks[active].data(), &activeHeader, sizeof(activeHeader));
+    full[active] = true;
+    active = other;
+    activeHeader = SdLogBlockHeader();
+    activeHeader.used = sizeof(SdLogBlockHeader);
+    if (writerTask != nullptr) writerTask->notify();
+    return true;
+}
+
+void SdLogSink::writerLoop() {
+    openNext();
+    while (true) {
+        const bool notified = pros::Task::notify_take(true, settings.flushInterval) != 0;
+        const bool rotating = rotateRequested.exchange(false);
+        writeBlock();
+        // write a block that isn't full if nothing has been written for a while, or before starting the next file
+        if (!notified || rotating) {
+            {
+                std::lock_guard<pros::Mutex> lock(mutex);
+                if (activeHeader.count != 0) swap();
+                if (rotating) sequence = 0;
+            }
+            writeBlock();
+        }
+        if (rotating) openNext();
+    }
+}
+
+void SdLogSink::writeBlock() {
+    for (std::size_t i = 0; i < blocks.size(); i++) {
+        if (!full[i]) continue;
+        std::array<std::uint8_t, SDLOG_BLOCK_SIZE>& block = blocks[i];
+        SdLogBlockHeader header;
+        std::memcpy(&header, block.data(), sizeof(header));
+        // clear what is left of the last time the block was used, so it isn't decoded as records
+        std::memset(block.data() + header.used, 0, SDLOG_BLOCK_SIZE - header.used);
+        if (file != nullptr && std::fwrite(block.data(), SDLOG_BLOCK_SIZE, 1, file) == 1) {
+            blocksWritten++;
+            // only whole blocks are ever flushed
+            std::fflush(file);
+            // closing the file is the only way to be sure the data is on the card
+            if (++blocksInFile % settings.syncInterval == 0) {
+                std::fclose(file);
+                file = std::fopen(path, "ab");
+            }
+        } else {
+            dropped += header.count;
+        }
+        full[i] = false;
+        return;
+    }
+}
+
+void SdLogSink::openNext() {
+    if (file != nullptr) std::fclose(file);
+    file = nullptr;
+    blocksInFile = 0;
+    if (!pros::usd::is_installed()) {
+        robotLog().warn("Can't log to the SD card, there is no SD card");
+        return;
+    }
+    // never overwrite the log of an earlier run
+    for (std::uint32_t next = nextRun; next < 10000; next++) {
+        std::snprintf(path, sizeof(path), "%s%04lu.bin", prefix, static_cast<unsigned long>(next));
+        if (FILE* existing = std::fopen(path, "rb")) {
+            std::fclose(existing);
+            continue;
+        }
+        file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            robotLog().error("Can't open {} to log to", path);
+            return;
+        }
+        // the header takes a whole block, so the blocks after it line up with the card's
+        static const std::array<std::uint8_t, SDLOG_BLOCK_SIZE - sizeof(SdLogFileHeader)> padding = {};
+        SdLogFileHeader header;
+        header.run = next;
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(padding.data(), padding.size(), 1, file);
+        run = next;
+        nextRun = next + 1;
+        return;
+    }
+    robotLog().error("Can't log to the SD card, every log file name is taken");
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string_view>
+#include <type_traits>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/baseSink.hpp"
+#include "SdLogFormat.hpp"
+
+/**
+ * @brief Parameters for an SdLogSink
+ */
+struct SdLogSettings {
+        /** how often a block that isn't full is written anyway, in milliseconds, so a quiet log still reaches the
+         * card. 2000 by default */
+        std::uint32_t flushInterval = 2000;
+        /** the file is closed and reopened every this many blocks, which is the only way to be sure its data is on
+         * the card. 16 by default, or 64 KB */
+        std::uint32_t syncInterval = 16;
+};
+
+/**
+ * @brief A log sink that writes to the SD card, in fixed size blocks, from a background task
+ *
+ * Logging to a file directly makes the logging task wait for the SD card, which can take tens of milliseconds. This
+ * sink copies each record into a block in memory instead, which costs a memcpy under a short lock. When the block is
+ * full it is swapped with a second one, and a background task writes the full block to the card. If the card falls
+ * so far behind that both blocks are full, records are dropped and counted, and never wait.
+ *
+ * Each run of the program writes to a new file, /usd/log0000.bin, /usd/log0001.bin and so on, and rotate starts the
+ * next file, for example at the start of each match. Besides log messages, structs can be written as binary records,
+ * to keep full rate logs of a whole practice. Add it to robotLog() with writeText, which copies the text robotLog()
+ * has already formatted, instead of as a sink, which formats it again. The format is described in SdLogFormat.hpp, and decoded on the computer
+ * by tools/sdlog_decode, built with `make sdlog_decode`.
+ *
+ * @b Example
+ * @code {.cpp}
+ * SdLogSink sdLog;
+ *
+ * void initialize() {
+ *     sdLog.start();
+ *     robotLog().addOutput([](lemlib::Level level, std::uint32_t time, std::string_view message) {
+ *         sdLog.writeText(level, time, message);
+ *     });
+ *     robotLog().info("started with {} V", pros::battery::get_voltage() / 1000.0);
+ * }
+ *
+ * void autonomous() {
+ *     // one file per match
+ *     sdLog.rotate();
+ *     while (true) {
+ *         sdLog.write(SdLogRecordType::FIRST_USER, chassis.getPose());
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class SdLogSink : public lemlib::BaseSink {
+    public:
+        /**
+         * @brief Construct a new SdLogSink. Nothing is written until start is called
+         *
+         * @param prefix start of the file names, the run number and ".bin" are appended. "/usd/log" by default
+         * @param settings the settings
+         */
+        SdLogSink(const char* prefix = "/usd/log", SdLogSettings settings = {});
+        /**
+         * @brief Open the first file, and start the writer task
+         */
+        void start();
+        /**
+         * @brief Write what has been logged, and start a new file. Returns straight away
+         */
+        void rotate();
+        /**
+         * @brief Write a binary record. Never waits for the card
+         *
+         * @param type type of the record
+         * @param data the payload
+         * @param size size of the payload, at most SDLOG_MAX_RECORD
+         * @param flags free for the program
+         * @return true if the record was written, false if it was dropped
+         */
+        bool write(SdLogRecordType type, const void* data, std::size_t size, std::uint8_t flags = 0);
+        /**
+         * @brief Write a struct as a binary record. Never waits for the card
+         */
+        template <typename T> bool write(SdLogRecordType type, const T& record, std::uint8_t flags = 0) {
+            static_assert(std::is_trivially_copyable_v<T>, "binary records must be trivially copyable");
+            static_assert(sizeof(T) <= SDLOG_MAX_RECORD, "record is too large for a block");
+            return write(type, &record, sizeof(T), flags);
+        }
+        /**
+         * @brief Write a log message that is already formatted as a text record. Never waits for the card
+         *
+         * @param level the level of the message
+         * @param time milliseconds since the program started
+         * @param message the message, cut short at SDLOG_MAX_RECORD bytes
+         * @return true if the record was written, false if it was dropped
+         */
+        bool writeText(lemlib::Level level, std::uint32_t time, std::string_view message);
+        /**
+         * @brief Get the number of records dropped because the card fell behind
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @brief Get the number of blocks written to the card
+         */
+        std::uint32_t getBlocksWritten() const;
+        /**
+         * @brief Get the number of the file being written
+         */
+        std::uint32_t getRun() const;
+    private:
+        /**
+         * @brief Write a log message as a text record
+         */
+        void sendMessage(const lemlib::Message& message) override;
+        /**
+         * @brief Append a record to the active block, swapping blocks if it doesn't fit
+         */
+        bool append(const SdLogRecordHeader& header, const void* data);
+        /**
+         * @brief Hand the active block to the writer task, and start filling the other one. Hold the mutex
+         *
+         * @return false if the other block is still being written
+         */
+        bool swap();
+        /**
+         * @brief The function run inside the writer task
+         */
+        void writerLoop();
+        /**
+         * @brief Write the full block, if there is one. There is never more than one
+         */
+        void writeBlock();
+        /**
+         * @brief Close the current file, and open the next one that doesn't exist yet
+         */
+        void openNext();
+
+        const char* prefix;
+        SdLogSettings settings;
+        pros::Task* writerTask = nullptr;
+
+        pros::Mutex mutex;
+        alignas(4) std::array<std::array<std::uint8_t, SDLOG_BLOCK_SIZE>, 2> blocks = {};
+        /** blocks waiting to be written */
+        std::array<std::atomic<bool>, 2> full = {};
+        std::size_t active = 0;
+        SdLogBlockHeader activeHeader = {};
+        std::uint32_t sequence = 0;
+        std::atomic<bool> rotateRequested = false;
+
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> blocksWritten = 0;
+        std::atomic<std::uint32_t> run = 0;
+
+        // only used by the writer task
+        FILE* file = nullptr;
+        char path[32] = {};
+        std::uint32_t nextRun = 0;
+        std::uint32_t blocksInFile = 0;
+};
@@ -0,0 +1,79 @@
+#include <mutex>
+#include "LogBuffer.hpp"
+#include "Telemetry.hpp"
+
+TelemetryStream::TelemetryStream(Output output, std::uint32_t schemaInterval)
+    : output(std::move(output)),
+      schemaInterval(schemaInterval) {
+    if (this->output == nullptr) this->output = [](std::string_view frame) { return bufferedLog().pushToBuffer(frame); };
+}
+
+std::uint8_t TelemetryStream::addSchema(const char* name, const TelemetryType* types, const char* const* fieldNames,
+                                        std::size_t fieldCount) {
+    std::size_t index;
+    {
+        std::lock_guard<pros::Mutex> lock(schemaMutex);
+        index = schemaCount;
+        if (index >= MAX_RECORDS || fieldCount > MAX_FIELDS) return TELEMETRY_SCHEMA_ID;
+        Schema& schema = schemas[index];
+        schema.name = name;
+        schema.fieldCount = fieldCount;
+        for (std::size_t i = 0; i < fieldCount; i++) {
+            schema.types[i] = types[i];
+            schema.fieldNames[i] = fieldNames[i];
+        }
+        // publish the schema after it has been filled in
+        schemaCount = index + 1;
+    }
+    // ids start at 1, 0 is for schemas
+    const std::uint8_t id = index + 1;
+    sendSchema(id);
+    return id;
+}
+
+void TelemetryStream::sendSchema(std::uint8_t id) {
+    const Schema& schema = schemas[id - 1];
+    TelemetryFrame frame;
+    frame.putByte(TELEMETRY_SCHEMA_ID);
+    frame.putByte(id);
+    frame.putString(schema.name);
+    frame.putByte(schema.fieldCount);
+    for (std::size_t i = 0; i < schema.fieldCount; i++) {
+        frame.putByte(static_cast<std::uint8_t>(schema.types[i]));
+        frame.putString(schema.fieldNames[i]);
+    }
+    write(frame);
+}
+
+void TelemetryStream::setEnabled(bool enabled) {
+    if (enabled == this->enabled.exchange(enabled) || !enabled) return;
+    sendSchemas();
+}
+
+bool TelemetryStream::isEnabled() const { return enabled; }
+
+void TelemetryStream::sendSchemas() {
+    lastSchemaTime = pros::millis();
+    const std::size_t count = schemaCount;
+    for (std::size_t i = 0; i < count; i++) sendSchema(i + 1);
+}
+
+void TelemetryStream::send(const TelemetryFrame& frame) {
+    // repeat the schemas for decoders that started late. Only one task wins the exchange
+    const std::uint32_t now = pros::millis();
+    std::uint32_t last = lastSchemaTime;
+    if (now - last >= schemaInterval && lastSchemaTime.compare_exchange_strong(last, now)) sendSchemas();
+    write(frame);
+}
+
+void TelemetryStream::write(const TelemetryFrame& frame) {
+    if (!enabled || frame.hasOverflowed()) return;
+    std::uint8_t encoded[TelemetryFrame::MAX_ENCODED_SIZE];
+    const std::size_t size = frame.encode(encoded);
+    if (output(std::string_view(reinterpret_cast<const char*>(encoded), size))) bytesSent += size;
+    else dropped++;
+}
+
+std::uint32_t TelemetryStream::getBytesSent() const { return bytesSent; }
+
+std::uint32_t TelemetryStream::getDropped() const { return dropped; }
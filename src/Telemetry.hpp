@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string_view>
+#include "pros/rtos.hpp"
+#include "TelemetryProtocol.hpp"
+
+class TelemetryStream;
+
+/**
+ * @brief A kind of record, with a fixed list of typed fields. Created by TelemetryStream::addRecord
+ *
+ * @tparam T the types of the fields. Floating point fields are sent as floats, integers as varints
+ */
+template <typename... T> class TelemetryRecord {
+    public:
+        /**
+         * @brief Send a record. Costs a few bytes per field and no formatting, and never allocates
+         *
+         * @param values the fields, in the order they were named
+         */
+        void send(T... values) const;
+        /**
+         * @brief Whether the record was added. addRecord fails if the stream has MAX_RECORDS already
+         */
+        bool isValid() const { return stream != nullptr; }
+    private:
+        friend class TelemetryStream;
+
+        TelemetryRecord(TelemetryStream* stream, std::uint8_t id)
+            : stream(stream),
+              id(id) {}
+
+        TelemetryStream* stream;
+        std::uint8_t id;
+};
+
+/**
+ * @brief Sends telemetry as compact binary records instead of formatted text
+ *
+ * Formatting the pose with the telemetry sink costs two rounds of fmt formatting and a few dozen bytes of text per
+ * message. A record costs a few bytes per field: a pose is about 20 bytes on the wire, framing included. The stream
+ * is described in TelemetryProtocol.hpp, and decoded on the host by tools/telemetry_decode, built with
+ * `make telemetry_decode`.
+ *
+ * Each frame is written whole, so records from different tasks don't interleave. By default frames go in the bulk
+ * lane of bufferedLog(), with the logs and motion recordings, so they share its bandwidth budget: over the radio a
+ * frame that doesn't fit is dropped, and counted by getDropped, instead of holding up the link. Nothing is written
+ * until the stream is enabled, so text on the same output stays readable unless binary is asked for. Schemas are sent
+ * when the stream is enabled or a record is added, and every schemaInterval after that.
+ *
+ * @b Example
+ * @code {.cpp}
+ * TelemetryStream telemetry;
+ * const auto poseRecord = telemetry.addRecord<float, float, float>("pose", {"x", "y", "theta"});
+ *
+ * void opcontrol() {
+ *     telemetry.setEnabled(true);
+ *     while (true) {
+ *         const lemlib::Pose pose = chassis.getPose();
+ *         poseRecord.send(pose.x, pose.y, pose.theta);
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ *
+ * Then, on the computer:
+ * @code {.sh}
+ * make telemetry_decode
+ * pros terminal --raw | bin/tools/telemetry_decode
+ * @endcode
+ */
+class TelemetryStream {
+    public:
+        /** most kinds of records a stream can have */
+        static constexpr std::size_t MAX_RECORDS = 32;
+        /** most fields a record can have */
+        static constexpr std::size_t MAX_FIELDS = 16;
+
+        /**
+         * @brief Writes an encoded frame
+         *
+         * @return false if the frame was dropped
+         */
+        using Output = std::function<bool(std::string_view frame)>;
+
+        /**
+         * @brief Construct a new TelemetryStream
+         *
+         * @param output where frames are written. The bulk lane of bufferedLog() by default
+         * @param schemaInterval how often schemas are repeated, in milliseconds. 1000 by default
+         */
+        TelemetryStream(Output output = nullptr, std::uint32_t schemaInterval = 1000);
+        /**
+         * @brief Add a kind of record, and send its schema
+         *
+         * @tparam T the types of the fields
+         * @param name name of the record. Must outlive the stream, like a string literal
+         * @param fieldNames names of the fields. Must outlive the stream
+         * @return TelemetryRecord<T...> the record. Not valid if the stream already has MAX_RECORDS
+         */
+        template <typename... T>
+        TelemetryRecord<T...> addRecord(const char* name, std::array<const char*, sizeof...(T)> fieldNames) {
+            static_assert(sizeof...(T) <= MAX_FIELDS, "too many fields");
+            const std::array<TelemetryType, sizeof...(T)> types = {telemetryType<T>()...};
+            const std::uint8_t id = addSchema(name, types.data(), fieldNames.data(), sizeof...(T));
+            return TelemetryRecord<T...>(id == TELEMETRY_SCHEMA_ID ? nullptr : this, id);
+        }
+        /**
+         * @brief Start or stop writing frames. Starting sends the schemas of every record
+         *
+         * @param enabled whether to write frames. false by default
+         */
+        void setEnabled(bool enabled);
+        /**
+         * @brief Whether frames are being written
+         */
+        bool isEnabled() const;
+        /**
+         * @brief Send the schemas of every record now
+         */
+        void sendSchemas();
+        /**
+         * @brief Get the number of bytes written, including framing
+         */
+        std::uint32_t getBytesSent() const;
+        /**
+         * @brief Get the number of frames the output dropped
+         */
+        std::uint32_t getDropped() const;
+    private:
+        template <typename... T> friend class TelemetryRecord;
+
+        /**
+         * @brief The fields of a kind of record
+         */
+        struct Schema {
+                const char* name = nullptr;
+                std::size_t fieldCount = 0;
+                std::array<TelemetryType, MAX_FIELDS> types = {};
+                std::array<const char*, MAX_FIELDS> fieldNames = {};
+        };
+
+        /**
+         * @brief Add a schema and send it
+         *
+         * @return std::uint8_t the id of the record, or TELEMETRY_SCHEMA_ID if there is no room
+         */
+        std::uint8_t addSchema(const char* name, const TelemetryType* types, const char* const* fieldNames,
+                               std::size_t fieldCount);
+        void sendSchema(std::uint8_t id);
+        /**
+         * @brief Encode and write a frame. Repeats the schemas first if they're due
+         */
+        void send(const TelemetryFrame& frame);
+        void write(const TelemetryFrame& frame);
+
+        Output output;
+        std::uint32_t schemaInterval;
+        std::atomic<bool> enabled = false;
+        std::atomic<std::uint32_t> lastSchemaTime = 0;
+        std::atomic<std::uint32_t> bytesSent = 0;
+        std::atomic<std::uint32_t> dropped = 0;
+
+        pros::Mutex schemaMutex;
+        std::array<Schema, MAX_RECORDS> schemas = {};
+        std::atomic<std::size_t> schemaCount = 0;
+};
+
+template <typename... T> void TelemetryRecord<T...>::send(T... values) const {
+    if (stream == nullptr || !stream->isEnabled()) return;
+    TelemetryFrame frame;
+    frame.putByte(id);
+    frame.putUVarint(pros::millis());
+    (frame.put(values), ...);
+    stream->send(frame);
+}
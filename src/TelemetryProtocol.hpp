@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * The binary telemetry protocol, shared by the robot and the host decoder. This doesn't depend on PROS.
+ *
+ * The stream is a sequence of frames. Each frame is a payload followed by a CRC-8 of the payload, COBS encoded so it
+ * contains no zero bytes, with a zero byte before and after it. A decoder can start reading anywhere: it skips to
+ * the next zero byte. Text printed to the same stream ends up as frames that fail the CRC, and is skipped.
+ *
+ * The first byte of a payload is the record id. Id 0 is a schema, describing a record:
+ *
+ *     0, record id, name, field count, (field type, field name) for each field
+ *
+ * Any other id is a record, described by the schema with that id:
+ *
+ *     record id, time (uvarint, milliseconds since the program started), each field
+ *
+ * Strings are a uvarint length then the bytes. UINT fields are uvarints, INT fields are zigzag encoded varints,
+ * FLOAT fields are 4 byte little endian IEEE 754 floats. Schemas are repeated regularly, so a decoder that starts
+ * late learns them.
+ */
+
+/**
+ * @brief Type of a telemetry field
+ */
+enum class TelemetryType : std::uint8_t { UINT = 0, INT = 1, FLOAT = 2 };
+
+/**
+ * @brief The telemetry type a C++ type is sent as
+ */
+template <typename T> constexpr TelemetryType telemetryType() {
+    static_assert(std::is_arithmetic_v<T>, "telemetry fields must be numbers");
+    if constexpr (std::is_floating_point_v<T>) return TelemetryType::FLOAT;
+    else if constexpr (std::is_signed_v<T>) return TelemetryType::INT;
+    else return TelemetryType::UINT;
+}
+
+/** record id of schemas */
+constexpr std::uint8_t TELEMETRY_SCHEMA_ID = 0;
+
+/**
+ * @brief CRC-8 with polynomial 0x07
+ */
+inline std::uint8_t telemetryCrc(const std::uint8_t* data, std::size_t size) {
+    std::uint8_t crc = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief A frame being written. Nothing allocates
+ */
+class TelemetryFrame {
+    public:
+        /** most bytes a payload can have */
+        static constexpr std::size_t MAX_SIZE = 256;
+        /** most bytes an encoded frame can have: the payload and CRC, COBS overhead, and the delimiters */
+        static constexpr std::size_t MAX_ENCODED_SIZE = MAX_SIZE + 1 + (MAX_SIZE + 1) / 254 + 1 + 2;
+
+        void putByte(std::uint8_t byte) {
+            if (size >= MAX_SIZE) {
+                overflowed = true;
+                return;
+            }
+            data[size++] = byte;
+        }
+
+        void putUVarint(std::uint64_t value) {
+            while (value >= 0x80) {
+                putByte(std::uint8_t(value) | 0x80);
+                value >>= 7;
+            }
+            putByte(std::uint8_t(value));
+        }
+
+        void putVarint(std::int64_t value) {
+            // zigzag, so small negative numbers are small too
+            putUVarint((std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+        }
+
+        void putFloat(float value) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; i++) putByte(std::uint8_t(bits >> (8 * i)));
+        }
+
+        void putString(const char* string) {
+            const std::size_t length = std::strlen(string);
+            putUVarint(length);
+            for (std::size_t i = 0; i < length; i++) putByte(string[i]);
+        }
+
+        /**
+         * @brief Write a field, as the telemetry type of its C++ type
+         */
+        template <typename T> void put(T value) {
+            if constexpr (telemetryType<T>() == TelemetryType::FLOAT) putFloat(value);
+            else if constexpr (telemetryType<T>() == TelemetryType::INT) putVarint(value);
+            else putUVarint(value);
+        }
+
+        /**
+         * @brief Whether the payload didn't fit. Frames that overflowed must not be sent
+         */
+        bool hasOverflowed() const { return overflowed; }
+
+        /**
+         * @brief COBS encode the payload and its CRC, between zero bytes
+         *
+         * @param out buffer of at least MAX_ENCODED_SIZE bytes
+         * @return std::size_t number of bytes written
+         */
+        std::size_t encode(std::uint8_t* out) const {
+            std::size_t length = 0;
+            out[length++] = 0;
+            std::size_t codeIndex = length++;
+            std::uint8_t code = 1;
+            const std::uint8_t crc = telemetryCrc(data.data(), size);
+            for (std::size_t i = 0; i <= size; i++) {
+                const std::uint8_t byte = i < size ? data[i] : crc;
+                if (byte != 0) {
+                    out[length++] = byte;
+                    code++;
+                }
+                // a zero, or a full block, ends the block
+                if (byte == 0 || code == 0xFF) {
+                    out[codeIndex] = code;
+                    codeIndex = length++;
+                    code = 1;
+                }
+            }
+            out[codeIndex] = code;
+            out[length++] = 0;
+            return length;
+        }
+    private:
+        std::array<std::uint8_t, MAX_SIZE> data = {};
+        std::size_t size = 0;
+        bool overflowed = false;
+};
+
+/**
+ * @brief Reads the fields of a decoded payload
+ */
+class TelemetryReader {
+    public:
+        TelemetryReader(const std::uint8_t* data, std::size_t size)
+            : data(data),
+              size(size) {}
+
+        bool getByte(std::uint8_t& byte) {
+            if (position >= size) return false;
+            byte = data[position++];
+            return true;
+        }
+
+        bool getUVarint(std::uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                std::uint8_t byte;
+                if (!getByte(byte)) return false;
+                value |= std::uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool getVarint(std::int64_t& value) {
+            std::uint64_t zigzag;
+            if (!getUVarint(zigzag)) return false;
+            value = std::int64_t(zigzag >> 1) ^ -std::int64_t(zigzag & 1);
+            return true;
+        }
+
+        bool getFloat(float& value) {
+            if (size - position < 4) return false;
+            std::uint32_t bits = 0;
+            for (int i = 0; i < 4; i++) bits |= std::uint32_t(data[position++]) << (8 * i);
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        }
+
+        /**
+         * @brief Read a string into a buffer, null terminated
+         */
+        bool getString(char* out, std::size_t capacity) {
+            std::uint64_t length;
+            if (!getUVarint(length) || length >= capacity || size - position < length) return false;
+            std::memcpy(out, data + position, length);
+            out[length] = '\0';
+            position += length;
+            return true;
+        }
+
+        /**
+         * @brief Whether every byte has been read
+         */
+        bool isDone() const { return position == size; }
+    private:
+        const std::uint8_t* data;
+        std::size_t size;
+        std::size_t position = 0;
+};
+
+/**
+ * @brief Decode a COBS encoded frame, without its delimiters, and check its CRC
+ *
+ * @param in the encoded frame
+ * @param size number of encoded bytes
+ * @param out buffer for the payload, at least size bytes
+ * @return std::size_t size of the payload, or 0 if the frame is malformed or its CRC doesn't match
+ */
+inline std::size_t telemetryDecode(const std::uint8_t* in, std::size_t size, std::uint8_t* out) {
+    std::size_t length = 0;
+    std::size_t i = 0;
+    while (i < size) {
+        const std::uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > size) return 0;
+        for (std::uint8_t j = 1; j < code; j++) out[length++] = in[i++];
+        // a block shorter than 254 bytes was followed by a zero, unless it is the last one
+        if (code != 0xFF && i < size) out[length++] = 0;
+    }
+    // the last byte is the CRC
+    if (length < 2 || telemetryCrc(out, length - 1) != out[length - 1]) return 0;
+    return length - 1;
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+#include "TimestampedOdom.hpp"
+
+TimestampedOdom::TimestampedOdom(lemlib::Drivetrain drivetrain, pros::Imu* imu)
+    : trackWidth(drivetrain.trackWidth),
+      wheelDiameter(drivetrain.wheelDiameter),
+      rpm(drivetrain.rpm),
+      imu(imu) {
+    left.motors = drivetrain.leftMotors;
+    right.motors = drivetrain.rightMotors;
+}
+
+void TimestampedOdom::reset() { initialized = false; }
+
+void TimestampedOdom::init(Side& side) {
+    snapshot(*side.motors, side.snapshot, MotorSnapshot::RAW_POSITION);
+    side.size = side.snapshot.size;
+    for (int i = 0; i < side.size; i++) {
+        const std::int8_t port = side.motors->get_port(i);
+        // encoder counts per revolution of the cartridge output, and the output rpm of the cartridge
+        float countsPerRev = 900;
+        float cartridgeRpm = 200;
+        switch (pros::c::motor_get_gearing(port)) {
+            case pros::E_MOTOR_GEARSET_36: countsPerRev = 1800, cartridgeRpm = 100; break;
+            case pros::E_MOTOR_GEARSET_06: countsPerRev = 300, cartridgeRpm = 600; break;
+            default: break;
+        }
+        side.inchesPerCount[i] = wheelDiameter * M_PI / countsPerRev * (rpm / cartridgeRpm);
+        // a motor that is disconnected now takes its first valid reading as its baseline, in sample
+        side.baselined[i] = side.snapshot.isValid(i);
+        side.counts[i] = side.baselined[i] ? side.snapshot.rawPosition[i] : 0;
+        side.timestamps[i] = side.baselined[i] ? side.snapshot.rawTimestamp[i] : 0;
+    }
+    side.position = 0;
+    side.integrated = 0;
+    side.velocity = 0;
+    side.time = *std::max_element(side.timestamps.begin(), side.timestamps.begin() + std::max(side.size, 1));
+}
+
+bool TimestampedOdom::sample(Side& side) {
+    bool fresh = false;
+    std::uint32_t newest = side.time;
+    // movement of the connected motors since the last sample. A motor with no new sample counts as not moving, so
+    // motors that refresh at different times still average to the movement of the side
+    float moved = 0;
+    int connected = 0;
+    snapshot(*side.motors, side.snapshot, MotorSnapshot::RAW_POSITION);
+    for (int i = 0; i < side.size; i++) {
+        // motor disconnected. It is left out of the average, so the others carry the side
+        if (!side.snapshot.isValid(i)) {
+            side.baselined[i] = false;
+            continue;
+        }
+        const std::int32_t counts = side.snapshot.rawPosition[i];
+        const std::uint32_t timestamp = side.snapshot.rawTimestamp[i];
+        // first reading since startup or reconnecting. How far it moved while disconnected isn't known
+        if (!side.baselined[i]) {
+            side.counts[i] = counts;
+            side.timestamps[i] = timestamp;
+            side.baselined[i] = true;
+            continue;
+        }
+        connected++;
+        if (timestamp == side.timestamps[i]) { // this sample has already been integrated
+            staleSamples++;
+            continue;
+        }
+        moved += (counts - side.counts[i]) * side.inchesPerCount[i];
+        side.counts[i] = counts;
+        side.timestamps[i] = timestamp;
+        newest = std::max(newest, timestamp);
+        fresh = true;
+    }
+    if (!fresh) return false;
+
+    const float position = side.position + moved / connected;
+    // velocity over the time between the samples, not the time between odometry updates
+    if (newest > side.time) side.velocity = (position - side.position) / ((newest - side.time) / 1000.0f);
+    side.position = position;
+    side.time = newest;
+    return true;
+}
+
+void TimestampedOdom::update() {
+    if (poll()) lemlib::setPose(integrate(lemlib::getPose(true)), true);
+}
+
+bool TimestampedOdom::poll() {
+    if (!initialized) {
+        init(left);
+        init(right);
+        if (imu != nullptr) prevImuRotation = imu->get_rotation();
+        initialized = true;
+        return false;
+    }
+
+    const bool leftFresh = sample(left);
+    const bool rightFresh = sample(right);
+    // nothing to integrate until the smart ports have refreshed
+    if (!leftFresh && !rightFresh) return false;
+
+    const float deltaLeft = left.position - left.integrated;
+    const float deltaRight = right.position - right.integrated;
+    left.integrated = left.position;
+    right.integrated = right.position;
+
+    // heading change, clockwise positive
+    deltaTheta = (deltaLeft - deltaRight) / trackWidth;
+    if (imu != nullptr) {
+        const float rotation = imu->get_rotation();
+        if (std::isfinite(rotation) && std::isfinite(prevImuRotation))
+            deltaTheta = lemlib::degToRad(rotation - prevImuRotation);
+        // not finite during a dropout, so the first reading after it only catches up, the wheels covered the dropout
+        prevImuRotation = rotation;
+    }
+    angularVelocity = (left.velocity - right.velocity) / trackWidth;
+
+    // arc approximation of the distance traveled
+    const float deltaY = (deltaLeft + deltaRight) / 2;
+    deltaDistance = deltaTheta == 0 ? deltaY : 2 * std::sin(deltaTheta / 2) * (deltaY / deltaTheta);
+    return true;
+}
+
+lemlib::Pose TimestampedOdom::getDelta() { return lemlib::Pose(0, deltaDistance, deltaTheta); }
+
+lemlib::Pose TimestampedOdom::integrate(lemlib::Pose pose) {
+    const float avgHeading = pose.theta + deltaTheta / 2;
+    pose.x += deltaDistance * std::sin(avgHeading);
+    pose.y += deltaDistance * std::cos(avgHeading);
+    pose.theta += deltaTheta;
+    return pose;
+}
+
+lemlib::Pose TimestampedOdom::getLocalSpeed() {
+    return lemlib::Pose(0, (left.velocity + right.velocity) / 2, angularVelocity);
+}
+
+std::uint32_t TimestampedOdom::getStaleSamples() { return staleSamples; }
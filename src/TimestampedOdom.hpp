@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "pros/imu.hpp"
+#include "pros/motor_group.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/pose.hpp"
+#include "MotorSnapshot.hpp"
+
+/**
+ * @brief Odometry for drivetrains with no tracking wheels, using the timestamps reported by the motors
+ *
+ * The smart ports refresh motor data every 10ms, independently of when odometry runs. lemlib::update() assumes every
+ * reading it takes is new and was taken "now", so when the odometry loop aliases against the port refresh it either
+ * integrates the same sample twice or gets two samples worth of movement in one tick, which shows up as velocity
+ * spikes. This reads the raw encoder count of every drive motor along with the timestamp the count was sampled at,
+ * ignores samples that have already been integrated, and computes velocities over the real time between samples.
+ *
+ * The pose is integrated on top of lemlib's pose, so chassis.setPose() keeps working as usual. Estimators that keep
+ * their own pose, like PoseEstimator, call poll() instead of update() and use the speeds without touching lemlib's pose.
+ *
+ * @b Example
+ * @code {.cpp}
+ * TimestampedOdom timestampedOdom(drivetrain, &imu);
+ * // run it instead of lemlib::update
+ * OdomScheduler odomScheduler(10, TASK_PRIORITY_DEFAULT + 2, [] { timestampedOdom.update(); });
+ * @endcode
+ */
+class TimestampedOdom {
+    public:
+        /**
+         * @brief Construct a new timestamped odometry
+         *
+         * @param drivetrain the drivetrain to track. The motor groups must have their gearset set
+         * @param imu pointer to the IMU used for heading. If nullptr, or if the IMU fails, heading is calculated from
+         * the difference between the two sides of the drivetrain
+         */
+        TimestampedOdom(lemlib::Drivetrain drivetrain, pros::Imu* imu = nullptr);
+        /**
+         * @brief Forget the last samples. The next update will only take new reference samples
+         *
+         * @note this is done automatically on the first update
+         */
+        void reset();
+        /**
+         * @brief Read new samples from the drivetrain and integrate them into lemlib's pose
+         *
+         * This should be called periodically, ideally by an OdomScheduler
+         */
+        void update();
+        /**
+         * @brief Read new samples from the drivetrain, without touching any pose
+         *
+         * @return true if at least one motor had a new sample. The speeds and getDelta() only change when it does
+         */
+        bool poll();
+        /**
+         * @brief Get how far the robot moved between the last two polls that had new samples
+         *
+         * @return lemlib::Pose y is the distance moved along the average heading, in inches, theta is the heading change
+         * in radians (clockwise positive). x is always 0
+         */
+        lemlib::Pose getDelta();
+        /**
+         * @brief Move a pose by the last delta
+         *
+         * @param pose the pose before the delta, in inches and radians like lemlib::getPose(true)
+         * @return lemlib::Pose the pose after the delta
+         */
+        lemlib::Pose integrate(lemlib::Pose pose);
+        /**
+         * @brief Get the local speed of the robot, measured over the real time between samples
+         *
+         * @return lemlib::Pose y is forwards speed in inches per second, theta is angular speed in radians per second
+         * (clockwise positive). x is always 0
+         */
+        lemlib::Pose getLocalSpeed();
+        /**
+         * @brief Get the number of motor samples that were rejected because they had already been integrated
+         */
+        std::uint32_t getStaleSamples();
+    private:
+        /**
+         * @brief The latest sample of one side of the drivetrain
+         */
+        struct Side {
+                pros::MotorGroup* motors;
+                /** the latest raw positions, read in one pass */
+                MotorSnapshot snapshot;
+                int size = 0;
+                /** inches traveled per encoder count of each motor */
+                std::array<float, MotorSnapshot::MAX_MOTORS> inchesPerCount {};
+                /** the last integrated encoder count of each motor, and when it was sampled */
+                std::array<std::int32_t, MotorSnapshot::MAX_MOTORS> counts {};
+                std::array<std::uint32_t, MotorSnapshot::MAX_MOTORS> timestamps {};
+                /** whether counts holds a real reading of the motor. Not while it is disconnected */
+                std::array<bool, MotorSnapshot::MAX_MOTORS> baselined {};
+                /** distance traveled, the sum of the average movement of the connected motors of each sample */
+                float position = 0;
+                /** time of the newest sample contributing to position, in milliseconds */
+                std::uint32_t time = 0;
+                float velocity = 0;
+                /** position when it was last integrated into the pose */
+                float integrated = 0;
+        };
+
+        /**
+         * @brief Read the motors on one side of the drivetrain
+         *
+         * @return true if at least one motor had a new sample
+         */
+        bool sample(Side& side);
+        /**
+         * @brief Take reference samples of one side of the drivetrain
+         */
+        void init(Side& side);
+
+        Side left;
+        Side right;
+        float trackWidth;
+        float wheelDiameter;
+        float rpm;
+        pros::Imu* imu;
+
+        bool initialized = false;
+        float prevImuRotation = 0;
+        std::uint32_t staleSamples = 0;
+        float angularVelocity = 0;
+        /** distance moved and heading change of the last poll with new samples */
+        float deltaDistance = 0;
+        float deltaTheta = 0;
+};
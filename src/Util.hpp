@@ -0,0 +1,26 @@
+#pragma once
+
+#include <span>
+
+/**
+ * @brief Return the average of a range of numbers
+ *
+ * Unlike lemlib::avg, which takes a std::vector by value, this works on any contiguous range without copying it,
+ * so it can be used in loops that must not allocate
+ *
+ * @param values
+ * @return float 0 if the range is empty
+ *
+ * @b Example
+ * @code {.cpp}
+ * std::array<float, 5> values = {1, 2, 3, 4, 5};
+ * avg(values); // returns 3
+ * avg(std::span(values).first(2)); // returns 1.5
+ * @endcode
+ */
+inline float avg(std::span<const float> values) {
+    if (values.empty()) return 0;
+    float sum = 0;
+    for (float value : values) sum += value;
+    return sum / values.size();
+}
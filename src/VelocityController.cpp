@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include "RobotLog.hpp"
+#include "VelocityController.hpp"
+
+/** full voltage, in millivolts */
+constexpr float MAX_VOLTAGE = 12000;
+
+pros::Mutex VelocityController::controllersMutex;
+std::array<VelocityController*, VelocityController::MAX_CONTROLLERS> VelocityController::controllers = {};
+std::atomic<std::size_t> VelocityController::controllerCount = 0;
+pros::Task* VelocityController::task = nullptr;
+
+VelocityController::VelocityController(pros::AbstractMotor* motors, VelocityControllerSettings settings)
+    : motors(motors),
+      settings(settings) {
+    this->settings.period = std::max<std::uint32_t>(settings.period, 1);
+}
+
+void VelocityController::setVelocity(float velocity) {
+    target = velocity;
+    if (!joined.exchange(true)) join();
+}
+
+void VelocityController::join() {
+    std::lock_guard<pros::Mutex> lock(controllersMutex);
+    const std::size_t index = controllerCount;
+    if (index >= MAX_CONTROLLERS) {
+        robotLog().error("Can't run more than {} velocity controllers", MAX_CONTROLLERS);
+        return;
+    }
+    controllers[index] = this;
+    // publish the controller after it has been stored
+    controllerCount.store(index + 1, std::memory_order_release);
+    if (task == nullptr)
+        task = new pros::Task(taskLoop, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Velocity Controllers");
+}
+
+float VelocityController::getVelocity() const { return velocity; }
+
+bool VelocityController::isUnjamming() const { return unjamming; }
+
+std::uint32_t VelocityController::getJams() const { return jams; }
+
+void VelocityController::init() {
+    snapshot(*motors, readings, MotorSnapshot::RAW_POSITION);
+    size = readings.size;
+    // the free speed of the cartridge, and encoder counts per revolution of its output
+    freeSpeed = 200;
+    for (int i = 0; i < size; i++) {
+        countsPerRev[i] = 900;
+        switch (motors->get_gearing(i)) {
+            case pros::MotorGears::ratio_36_to_1: countsPerRev[i] = 1800, freeSpeed = 100; break;
+            case pros::MotorGears::ratio_6_to_1: countsPerRev[i] = 300, freeSpeed = 600; break;
+            default: break;
+        }
+        // a motor that is disconnected now takes its first valid reading as its baseline, in measure
+        baselined[i] = readings.isValid(i);
+        counts[i] = {readings.rawPosition[i], readings.rawPosition[i]};
+        timestamps[i] = {readings.rawTimestamp[i], readings.rawTimestamp[i]};
+        velocities[i] = 0;
+    }
+}
+
+void VelocityController::measure() {
+    float sum = 0;
+    int count = 0;
+    for (int i = 0; i < size; i++) {
+        // motor disconnected. Its counts from before may be far off by the time it comes back
+        if (!readings.isValid(i)) {
+            baselined[i] = false;
+            continue;
+        }
+        const std::int32_t newCounts = readings.rawPosition[i];
+        const std::uint32_t timestamp = readings.rawTimestamp[i];
+        // first reading since startup or reconnecting, there is nothing to differentiate it against yet
+        if (!baselined[i]) {
+            counts[i] = {newCounts, newCounts};
+            timestamps[i] = {timestamp, timestamp};
+            velocities[i] = 0;
+            baselined[i] = true;
+            continue;
+        }
+        // only differentiate samples the motor has refreshed, over the time between them. Going back two samples
+        // halves the noise of counting whole encoder ticks, for one more refresh of delay
+        if (timestamp > timestamps[i][0]) {
+            velocities[i] = (newCounts - counts[i][1]) / countsPerRev[i] / ((timestamp - timestamps[i][1]) / 60000.0f);
+            counts[i] = {newCounts, counts[i][0]};
+            timestamps[i] = {timestamp, timestamps[i][0]};
+        }
+        sum += velocities[i];
+        count++;
+    }
+    velocity = count == 0 ? 0 : sum / count;
+}
+
+void VelocityController::update(float targetVelocity, std::uint32_t now) {
+    if (unjamming) {
+        if (now < unjamEnd) {
+            motors->move_voltage(targetVelocity > 0 ? -settings.unjamVoltage : settings.unjamVoltage);
+            return;
+        }
+        unjamming = false;
+        stalling = false;
+    }
+    if (targetVelocity == 0) {
+        integral = 0;
+        stalling = false;
+        motors->brake();
+        return;
+    }
+
+    std::int32_t current = 0;
+    for (int i = 0; i < size; i++)
+        if (readings.isValid(i)) current = std::max(current, readings.current[i]);
+    const bool currentLimited = current >= settings.stallCurrent;
+
+    // wait for the stall time before unjamming, a ball pushing through the intake stalls it for a moment
+    if (currentLimited && std::fabs(velocity) < settings.stallVelocity * freeSpeed) {
+        if (!stalling) stallStart = now;
+        stalling = true;
+        if (settings.unjamTime > 0 && now - stallStart >= settings.stallTime) {
+            unjamming = true;
+            unjamEnd = now + settings.unjamTime;
+            integral = 0;
+            jams++;
+            motors->move_voltage(targetVelocity > 0 ? -settings.unjamVoltage : settings.unjamVoltage);
+            return;
+        }
+    } else stalling = false;
+
+    // feedforward from the free speed, plus PI on the error
+    const float error = (targetVelocity - velocity) / freeSpeed;
+    const float output = targetVelocity / freeSpeed + settings.kP * error + settings.kI * integral;
+    // the integral stops growing once the output is saturated, so it doesn't wind up behind a jam
+    if (std::fabs(output) < 1) integral += error * settings.period / 1000.0f;
+    motors->move_voltage(std::clamp(output, -1.0f, 1.0f) * MAX_VOLTAGE);
+}
+
+void VelocityController::tick(std::uint32_t now) {
+    if (!initialized) {
+        init();
+        initialized = true;
+    } else if (now - lastUpdate < settings.period) return;
+    lastUpdate = now;
+    snapshot(*motors, readings, MotorSnapshot::CURRENT);
+    measure();
+    update(target, now);
+}
+
+void VelocityController::taskLoop() {
+    std::uint32_t prevTime = pros::millis();
+    while (true) {
+        // wake for the shortest period, each controller waits out its own
+        std::uint32_t period = UINT32_MAX;
+        const std::size_t count = controllerCount.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; i++) {
+            controllers[i]->tick(prevTime);
+            period = std::min(period, controllers[i]->settings.period);
+        }
+        pros::Task::delay_until(&prevTime, period);
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "pros/abstract_motor.hpp"
+#include "pros/rtos.hpp"
+#include "MotorSnapshot.hpp"
+
+/**
+ * @brief Settings for a velocity controller
+ *
+ * Gains are unitless, so the same gains fit every cartridge: the error is a fraction of the free speed, and the output
+ * a fraction of full voltage.
+ */
+struct VelocityControllerSettings {
+        /** voltage per error, both as fractions. 1 by default, full voltage at the free speed of error */
+        float kP = 1;
+        /** voltage per error per second, both as fractions. 80 by default, so a load is made up in tens of ms */
+        float kI = 80;
+        /** time between updates, in milliseconds. 5 by default */
+        std::uint32_t period = 5;
+        /** current a motor draws when it's pushing as hard as it can, in milliamps. 2000 by default */
+        std::int32_t stallCurrent = 2000;
+        /** the motors are stalled when slower than this, as a fraction of the free speed. 0.05 by default */
+        float stallVelocity = 0.05;
+        /** how long the motors must be stalled before unjamming, in milliseconds. 150 by default */
+        std::uint32_t stallTime = 150;
+        /** how long to reverse to unjam, in milliseconds. 0 to never unjam. 100 by default */
+        std::uint32_t unjamTime = 100;
+        /** voltage to reverse at while unjamming, in millivolts. 6000 by default */
+        std::int32_t unjamVoltage = 6000;
+};
+
+/**
+ * @brief Holds a motor or motor group at a velocity, with a loop that runs on the brain
+ *
+ * The velocity loop inside the motors reacts slowly to load, so a jam takes hundreds of milliseconds to recover from.
+ * This loop sets the voltage instead: the voltage the free speed says the velocity needs, plus a PI controller on the
+ * error. The velocity is measured from the encoder counts and the time each was sampled at, like TimestampedOdom, so
+ * it isn't delayed by the motor's filtering.
+ *
+ * While the output is at full voltage the integral stops growing, so it doesn't wind up behind a jam.
+ * If they stay stalled for the stall time, they reverse briefly to unjam, then try again.
+ *
+ * Every controller runs in one shared task, at TASK_PRIORITY_DEFAULT, so the intake doesn't cost a task and a context
+ * switch per motor every period, and never preempts the tasks of the program. A controller joins the task on its first
+ * call to setVelocity, and the task updates each one when its period is up.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Motor intake(2, pros::MotorGearset::green);
+ * VelocityController intakeVelocity(&intake);
+ *
+ * void opcontrol() {
+ *     // replaces intake.move_velocity(200)
+ *     intakeVelocity.setVelocity(200);
+ * }
+ * @endcode
+ */
+class VelocityController {
+    public:
+        /** most controllers the shared task runs */
+        static constexpr std::size_t MAX_CONTROLLERS = 8;
+
+        /**
+         * @brief VelocityController constructor. It doesn't join the shared task until the first call to setVelocity
+         *
+         * @param motors the motor or motor group to control. Every motor must have the same cartridge
+         * @param settings gains and stall detection
+         */
+        VelocityController(pros::AbstractMotor* motors, VelocityControllerSettings settings = {});
+
+        VelocityController(const VelocityController&) = delete;
+        VelocityController& operator=(const VelocityController&) = delete;
+
+        /**
+         * @brief Set the target velocity. 0 brakes the motors, with their brake mode
+         *
+         * @param velocity in rpm, like pros::Motor::move_velocity
+         */
+        void setVelocity(float velocity);
+        /**
+         * @brief Get the measured velocity, in rpm
+         */
+        float getVelocity() const;
+        /**
+         * @brief Whether the motors are reversing to unjam
+         */
+        bool isUnjamming() const;
+        /**
+         * @brief Get how many times the motors have jammed
+         */
+        std::uint32_t getJams() const;
+    private:
+        /**
+         * @brief Find the free speed, and take the first encoder sample of every motor
+         */
+        void init();
+        /**
+         * @brief Measure the velocity from the encoders in the snapshot that have been sampled since the last update
+         */
+        void measure();
+        void update(float targetVelocity, std::uint32_t now);
+        /**
+         * @brief Update the controller if its period is up. Called by the shared task
+         *
+         * @param now the time of this round of the shared task
+         */
+        void tick(std::uint32_t now);
+        /**
+         * @brief Add the controller to the shared task, and start the task the first time
+         */
+        void join();
+        /**
+         * @brief The function run inside the shared task
+         */
+        static void taskLoop();
+
+        pros::AbstractMotor* motors;
+        VelocityControllerSettings settings;
+
+        std::atomic<float> target = 0;
+        std::atomic<float> velocity = 0;
+        std::atomic<bool> unjamming = false;
+        std::atomic<std::uint32_t> jams = 0;
+
+        /** encoder counts and current draws, read once per update */
+        MotorSnapshot readings;
+        int size = 0;
+        /** in rpm */
+        float freeSpeed = 200;
+        std::array<float, MotorSnapshot::MAX_MOTORS> countsPerRev {};
+        /** the last two encoder samples of each motor, newest first */
+        std::array<std::array<std::int32_t, 2>, MotorSnapshot::MAX_MOTORS> counts {};
+        std::array<std::array<std::uint32_t, 2>, MotorSnapshot::MAX_MOTORS> timestamps {};
+        std::array<float, MotorSnapshot::MAX_MOTORS> velocities {};
+        /** whether counts and timestamps hold a real reading of the motor. Not while it is disconnected */
+        std::array<bool, MotorSnapshot::MAX_MOTORS> baselined {};
+
+        float integral = 0;
+        bool stalling = false;
+        std::uint32_t stallStart = 0;
+        std::uint32_t unjamEnd = 0;
+
+        // only used by the shared task
+        bool initialized = false;
+        std::uint32_t lastUpdate = 0;
+
+        std::atomic<bool> joined = false;
+
+        static pros::Mutex controllersMutex;
+        static std::array<VelocityController*, MAX_CONTROLLERS> controllers;
+        static std::atomic<std::size_t> controllerCount;
+        static pros::Task* task;
+};
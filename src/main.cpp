@@ -8,6 +8,9 @@
 #include "main.h"
 #include "lemlib/api.hpp" // IWYU pragma: keep
 #include "Create.hpp" // Robot Setup File 
+#include "CpuProfiler.hpp"
+#include "LogBuffer.hpp"
+#include "RobotLog.hpp"
 
 
 /**
@@ -18,13 +21,26 @@
  */
 void initialize() {
     pros::lcd::initialize(); // initialize brain screen
-    chassis.calibrate(); // calibrate sensors
+    chassis.calibrateAsync(); // calibrate sensors in the background, so the brain screen starts straight away
     chassis.setPose(0, 0, 0); // set position to x:0, y:0, heading:0
+    // record every tick of every motion to /usd/motions.bin, to debug autons after the run
+    chassis.getRecorder().setOutput(MotionRecorder::Output::SD);
+    // log to /usd/logNNNN.bin, a new file every run: our log messages, and the pose from the screen task
+    sdLog.start();
+    robotLog().addOutput([](lemlib::Level level, std::uint32_t time, std::string_view message) {
+        sdLog.writeText(level, time, message);
+    });
+    // time the CPU_ZONEs, when built with -DCPU_PROFILING
+    cpuProfiler().start();
+    // the pose is logged as text. To send it as binary records instead, decoded by tools/telemetry_decode:
+    // telemetry.setEnabled(true);
     
     // the default rate is 50. however, if you need to change the rate, you
     // can do the following.
     // lemlib::bufferedStdout().setRate(...);
     // If you use bluetooth or a wired connection, you will want to have a rate of 10ms
+    // our own logs go through bufferedLog(). Over the radio, give it a budget so they don't arrive late:
+    // bufferedLog().setBandwidth(...);
 
     // for more information on how the formatting for the loggers
     // works, refer to the fmtlib docs
@@ -32,12 +48,27 @@ void initialize() {
     // thread to for brain screen and position logging
     pros::Task screenTask([&]() {
         while (true) {
-            // print robot location to the brain screen
-            pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
-            pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
-            pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
-            // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            {
+                CPU_ZONE("screen");
+                // print robot location to the brain screen
+                pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
+                pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
+                pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
+                // calibration progress, and whether the IMU made it
+                const CalibrationHandle& calibration = chassis.getCalibration();
+                if (!calibration.isDone()) pros::lcd::print(4, "Calibrating: %.0f%%", calibration.getProgress() * 100);
+                else pros::lcd::print(4, calibration.succeeded() ? "Calibrated" : "IMU calibration failed");
+                // odometry timing, to check pose integration keeps a steady rate
+                OdomTimingStats odomStats = chassis.getOdomScheduler().getStats();
+                pros::lcd::print(3, "Odom jitter max: %luus, overruns: %lu, WCET: %luus", odomStats.maxJitter,
+                                 odomStats.overruns, odomStats.worstExecTime);
+                // log position telemetry, as a binary record if the telemetry stream is enabled
+                const lemlib::Pose pose = chassis.getPose();
+                if (telemetry.isEnabled()) poseTelemetry.send(pose.x, pose.y, pose.theta);
+                else bufferedLog().printDeferred("Chassis pose: {}\n", pose);
+                // and as a binary record on the SD card, three floats: x, y and theta
+                sdLog.write(SdLogRecordType::FIRST_USER, pose);
+            }
             // delay to save resources
 
             
@@ -165,6 +196,9 @@ void competition_initialize() {}
  * This is an example autonomous routine which demonstrates a lot of the features LemLib has to offer
  */
 void autonomous() {
+    // give each match its own log file
+    if (pros::competition::is_connected()) sdLog.rotate();
+    chassis.getCalibration().wait(); // odometry must be running before moving
     Left_side();
 }
 
@@ -172,6 +206,7 @@ void autonomous() {
  * Runs in driver control
  */
 void opcontrol() {
+    chassis.getCalibration().wait(); // odometry must be running before moving
     // loop to continuously update motors
     while (true) {
         // get left y and right x positions (get joystick positions)
@@ -179,7 +214,10 @@ void opcontrol() {
         int rightY = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
 
         // move the robot
-        chassis.tank(leftY, rightY);
+        {
+            CPU_ZONE("tank");
+            chassis.tank(leftY, rightY);
+        }
         
         // Pneumatics Control
         
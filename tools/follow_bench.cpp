@@ -0,0 +1,138 @@
+/**
+ * follow_bench - benchmark the pure pursuit path search
+ *
+ * Usage: follow_bench
+ *
+ * Drives a simulated robot along long synthetic paths, with some noise and the occasional shove off the path, and
+ * times finding the closest point and the lookahead point each tick. Compares the linear scan LemLib's follow does
+ * with PathIndex. Built for the host by `make bench`.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "PathIndex.hpp"
+
+/**
+ * @brief Generate a serpentine path, like sweeping the field, as a binary path asset
+ */
+static std::vector<std::uint8_t> makePath(std::size_t count, float spacing) {
+    std::vector<PathPoint> points(count);
+    constexpr float LANE_LENGTH = 120;
+    constexpr float LANE_WIDTH = 12;
+    const std::size_t pointsPerLane = LANE_LENGTH / spacing;
+    for (std::size_t i = 0; i < count; i++) {
+        const std::size_t lane = i / pointsPerLane;
+        const float along = (i % pointsPerLane) * spacing;
+        points[i].x = lane * LANE_WIDTH;
+        points[i].y = lane % 2 == 0 ? along : LANE_LENGTH - along;
+        points[i].speed = i + 1 == count ? 0 : 100;
+        if (i > 0)
+            points[i].distance =
+                points[i - 1].distance + std::hypot(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+    }
+    PathHeader header {.magic = PATH_MAGIC,
+                       .version = PATH_VERSION,
+                       .pointSize = sizeof(PathPoint),
+                       .count = std::uint32_t(count),
+                       .length = points.back().distance,
+                       .checksum = crc32(points.data(), count * sizeof(PathPoint))};
+    std::vector<std::uint8_t> buffer(sizeof(header) + count * sizeof(PathPoint));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), points.data(), count * sizeof(PathPoint));
+    return buffer;
+}
+
+/**
+ * @brief Where the simulated robot is each tick: following the path, slightly off it, and shoved every few seconds
+ */
+static std::vector<PathPoint> makeTrajectory(const PathView& path, std::size_t ticks) {
+    std::vector<PathPoint> trajectory(ticks);
+    for (std::size_t t = 0; t < ticks; t++) {
+        // 0.5 inches per tick is 50 in/s
+        const std::size_t i = std::min<std::size_t>(t * 0.5 / (path.getLength() / path.size()), path.size() - 1);
+        trajectory[t] = path[i];
+        trajectory[t].x += std::sin(t * 0.05f) * 1.5f;
+        if (t % 300 > 250) trajectory[t].x += 15;
+    }
+    return trajectory;
+}
+
+/**
+ * @brief The search LemLib's follow does: scan every point for the closest, then every segment past it
+ */
+struct LinearSearch {
+        const PathView& path;
+        std::size_t lookaheadIndex = 0;
+
+        PathIndex::Closest findClosest(float x, float y) {
+            PathIndex::Closest best {0, INFINITY};
+            for (std::size_t i = 0; i < path.size(); i++) {
+                const float distance = std::hypot(path[i].x - x, path[i].y - y);
+                if (distance < best.distance) best = {i, distance};
+            }
+            return best;
+        }
+
+        bool findLookahead(float x, float y, float lookahead, std::size_t closest) {
+            for (std::size_t i = std::max(closest, lookaheadIndex); i + 1 < path.size(); i++) {
+                const PathPoint p1 = path[i];
+                const PathPoint p2 = path[i + 1];
+                const float dx = p2.x - p1.x, dy = p2.y - p1.y, fx = p1.x - x, fy = p1.y - y;
+                const float a = dx * dx + dy * dy;
+                const float b = 2 * (fx * dx + fy * dy);
+                const float c = fx * fx + fy * fy - lookahead * lookahead;
+                const float discriminant = b * b - 4 * a * c;
+                if (discriminant < 0) continue;
+                const float t2 = (-b + std::sqrt(discriminant)) / (2 * a);
+                const float t1 = (-b - std::sqrt(discriminant)) / (2 * a);
+                if ((t2 >= 0 && t2 <= 1) || (t1 >= 0 && t1 <= 1)) {
+                    lookaheadIndex = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
+int main() {
+    constexpr float LOOKAHEAD = 10;
+    constexpr int REPEATS = 5;
+    std::printf("%8s %10s %14s %14s %8s\n", "points", "ticks", "linear ns/tick", "index ns/tick", "speedup");
+    for (std::size_t count : {250, 1000, 4000, 16000}) {
+        const std::vector<std::uint8_t> buffer = makePath(count, 1);
+        const asset pathAsset {const_cast<std::uint8_t*>(buffer.data()), buffer.size()};
+        const PathView path(pathAsset);
+        const std::vector<PathPoint> trajectory = makeTrajectory(path, path.getLength() / 0.5);
+
+        double linearNs = 0;
+        double indexNs = 0;
+        std::size_t sink = 0;
+        static PathIndex index;
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            LinearSearch linear {path};
+            auto start = std::chrono::steady_clock::now();
+            for (const PathPoint& pose : trajectory) {
+                const PathIndex::Closest closest = linear.findClosest(pose.x, pose.y);
+                sink += closest.index + linear.findLookahead(pose.x, pose.y, LOOKAHEAD, closest.index);
+            }
+            linearNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            index.build(path);
+            std::size_t lookaheadIndex = 0;
+            for (const PathPoint& pose : trajectory) {
+                const PathIndex::Closest closest = index.findClosest(pose.x, pose.y, LOOKAHEAD);
+                const auto lookahead = index.findLookahead(pose.x, pose.y, LOOKAHEAD, closest, lookaheadIndex);
+                if (lookahead) lookaheadIndex = lookahead->index;
+                sink += closest.index + lookahead.has_value();
+            }
+            indexNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        const double ticks = double(trajectory.size()) * REPEATS;
+        std::printf("%8zu %10zu %14.0f %14.0f %7.1fx\n", count, trajectory.size(), linearNs / ticks, indexNs / ticks,
+                    linearNs / indexNs);
+        if (sink == 0) std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * log_bench - benchmark what logging costs the task that logs
+ *
+ * Usage: log_bench
+ *
+ * Pushes typical control loop messages into a LogRing, the way LogBuffer does, and times the calling task: formatting
+ * into a std::string like LemLib's sinks, formatting into the stack like LogBuffer::print, and copying the raw
+ * arguments like LogBuffer::printDeferred. Also times the buffer task formatting the deferred messages when it drains
+ * them. Built and run on the host by `make log_bench`.
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "DeferredLog.hpp"
+#include "LogRing.hpp"
+
+using Ring = LogRing<8192>;
+
+/** messages pushed between drains, few enough that the ring never fills */
+constexpr int BATCH = 32;
+constexpr int BATCHES = 20000;
+
+/**
+ * @brief Push a record like LogBuffer: the formatter, then its payload
+ */
+static bool push(Ring& ring, LogFormatter formatter, std::string_view payload) {
+    return ring.push({std::string_view(reinterpret_cast<const char*>(&formatter), sizeof(formatter)), payload});
+}
+
+/**
+ * @brief Pop every record and format it, like the buffer task
+ *
+ * @return std::size_t bytes of text
+ */
+static std::size_t drain(Ring& ring) {
+    static char record[Ring::MAX_MESSAGE];
+    static char text[Ring::MAX_MESSAGE];
+    std::size_t total = 0;
+    std::size_t length;
+    while (ring.pop(record, length)) {
+        LogFormatter formatter;
+        std::memcpy(&formatter, record, sizeof(formatter));
+        total += formatter(record + sizeof(formatter), length - sizeof(formatter), text, sizeof(text));
+    }
+    return total;
+}
+
+/**
+ * @brief Time pushing BATCH messages at a time, and draining them
+ *
+ * @param name what is being measured
+ * @param log pushes message i
+ */
+template <typename F> static void bench(const char* name, F log) {
+    static Ring ring;
+    double pushNs = 0;
+    double drainNs = 0;
+    std::size_t bytes = 0;
+    for (int batch = 0; batch < BATCHES; batch++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BATCH; i++) log(ring, batch * BATCH + i);
+        auto end = std::chrono::steady_clock::now();
+        pushNs += std::chrono::duration<double, std::nano>(end - start).count();
+        bytes += drain(ring);
+        drainNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - end).count();
+    }
+    const double messages = double(BATCH) * BATCHES;
+    std::printf("%-32s %12.0f %12.0f %10.1f %8u\n", name, pushNs / messages, drainNs / messages, bytes / messages,
+                ring.getDropped());
+}
+
+int main() {
+    std::printf("%-32s %12s %12s %10s %8s\n", "", "log ns/msg", "drain ns/msg", "bytes/msg", "dropped");
+    // the pose and error of a motion tick
+    bench("pose, fmt::format", [](Ring& ring, int i) {
+        const std::string message = fmt::format("pose: {:.2f}, {:.2f}, {:.2f}, error: {:.3f}\n", i * 0.01f, 24.5f,
+                                                i * 0.1f, 0.125f);
+        push(ring, copyLogText, message);
+    });
+    bench("pose, print", [](Ring& ring, int i) {
+        char message[Ring::MAX_MESSAGE];
+        const auto result = fmt::format_to_n(message, sizeof(message), "pose: {:.2f}, {:.2f}, {:.2f}, error: {:.3f}\n",
+                                             i * 0.01f, 24.5f, i * 0.1f, 0.125f);
+        push(ring, copyLogText, std::string_view(message, std::min(result.size, sizeof(message))));
+    });
+    bench("pose, printDeferred", [](Ring& ring, int i) {
+        const DeferredLog<float, float, float, float> message("pose: {:.2f}, {:.2f}, {:.2f}, error: {:.3f}\n",
+                                                              i * 0.01f, 24.5f, i * 0.1f, 0.125f);
+        push(ring, DeferredLog<float, float, float, float>::format, message.getPayload());
+    });
+    // the odometry overrun warning
+    bench("overrun, fmt::format", [](Ring& ring, int i) {
+        const std::string message = fmt::format("[WARN] Odometry overran its {} ms period, taking {} us\n", 10, i);
+        push(ring, copyLogText, message);
+    });
+    bench("overrun, print", [](Ring& ring, int i) {
+        char message[Ring::MAX_MESSAGE];
+        const auto result = fmt::format_to_n(message, sizeof(message),
+                                             "[WARN] Odometry overran its {} ms period, taking {} us\n", 10, i);
+        push(ring, copyLogText, std::string_view(message, std::min(result.size, sizeof(message))));
+    });
+    bench("overrun, printDeferred", [](Ring& ring, int i) {
+        const DeferredLog<int, int> message("[WARN] Odometry overran its {} ms period, taking {} us\n", 10, i);
+        push(ring, DeferredLog<int, int>::format, message.getPayload());
+    });
+    return 0;
+}
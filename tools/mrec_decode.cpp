@@ -0,0 +1,175 @@
+/**
+ * mrec_decode - decode the motion recordings written by MotionRecorder
+ *
+ * Usage: mrec_decode motions.bin
+ *        mrec_decode --serial < terminal.log
+ *
+ * Reads the recordings appended to the SD card, or with --serial, the "MREC " and "MREC+ " lines from a terminal log
+ * on stdin, for example piped from `pros terminal`. Prints one CSV line per sample, with the motion it belongs to.
+ * Motions with samples dropped at the start, and recordings that are cut short or damaged, are reported on stderr. The
+ * format is described in src/MotionRecordFormat.hpp. Built for the host by `make mrec_decode`.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MotionRecordFormat.hpp"
+
+/** names of RobotChassis::Motion::Type, in order */
+static const char* const TYPES[] = {"turnToHeading", "moveToPose", "moveToPoint", "profiledMove", "follow"};
+
+struct Counts {
+        std::uint32_t motions = 0;
+        std::uint32_t samples = 0;
+        std::uint32_t dropped = 0;
+        std::uint32_t damaged = 0;
+};
+
+static void printHeader() {
+    std::printf("motion,type,time,target_x,target_y,target_theta,x,y,theta,lateral_error,angular_error,lateral_p,"
+                "lateral_i,lateral_d,angular_p,angular_i,angular_d,left_command,right_command,left_voltage,"
+                "right_voltage,flags\n");
+}
+
+/**
+ * @brief Print a recording: a header and its samples
+ *
+ * @return the number of bytes used, or 0 if the recording is damaged or cut short
+ */
+static std::size_t printRecording(const std::uint8_t* data, std::size_t size, Counts& counts) {
+    MotionRecordHeader header;
+    if (size < sizeof(header)) return 0;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MotionRecordHeader::MAGIC || header.version != MotionRecordHeader::VERSION ||
+        header.sampleSize < sizeof(MotionSample))
+        return 0;
+    const std::size_t length = sizeof(header) + std::size_t(header.count) * header.sampleSize;
+    if (size < length) return 0;
+
+    const char* type = header.type < sizeof(TYPES) / sizeof(TYPES[0]) ? TYPES[header.type] : "?";
+    if (header.dropped != 0)
+        std::fprintf(stderr, "motion %" PRIu32 " (%s at %" PRIu32 " ms): the first %" PRIu32 " samples were dropped\n",
+                     header.index, type, header.startTime, header.dropped);
+    for (std::uint32_t i = 0; i < header.count; i++) {
+        MotionSample s;
+        std::memcpy(&s, data + sizeof(header) + std::size_t(i) * header.sampleSize, sizeof(s));
+        std::printf("%" PRIu32 ",%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,"
+                    "%d,%u\n",
+                    header.index, type, (header.startTime + s.time / 1000.0), s.targetX, s.targetY, s.targetTheta, s.x,
+                    s.y, s.theta, s.lateralError, s.angularError, s.lateralP, s.lateralI, s.lateralD, s.angularP,
+                    s.angularI, s.angularD, s.leftCommand, s.rightCommand, s.leftVoltage, s.rightVoltage, s.flags);
+    }
+    counts.motions++;
+    counts.samples += header.count;
+    counts.dropped += header.dropped;
+    return length;
+}
+
+/**
+ * @brief Decode base64 onto the end of bytes, stopping at the first character that isn't base64
+ */
+static void decodeBase64(const char* text, std::vector<std::uint8_t>& bytes) {
+    std::uint32_t bits = 0;
+    int bitCount = 0;
+    for (; *text != '\0'; text++) {
+        const char c = *text;
+        int value;
+        if (c >= 'A' && c <= 'Z') value = c - 'A';
+        else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') value = c - '0' + 52;
+        else if (c == '+') value = 62;
+        else if (c == '/') value = 63;
+        else break; // padding, the newline, or the end of a damaged line
+        bits = bits << 6 | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            bytes.push_back(bits >> bitCount & 0xFF);
+        }
+    }
+}
+
+/**
+ * @brief Size of the recording that starts the bytes, from its header. 0 if the header isn't there yet
+ */
+static std::size_t recordingSize(const std::vector<std::uint8_t>& bytes) {
+    MotionRecordHeader header;
+    if (bytes.size() < sizeof(header)) return 0;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return sizeof(header) + std::size_t(header.count) * header.sampleSize;
+}
+
+static void decodeSerial(Counts& counts) {
+    std::string line;
+    // the recording being put together, from its lines
+    std::vector<std::uint8_t> bytes;
+    bool inRecording = false;
+    // read whole lines whatever their length. Binary telemetry may share the stream, NUL bytes and all
+    while (std::getline(std::cin, line)) {
+        // other output may come before the recording's text on the same line
+        const std::size_t start = line.find("MREC ");
+        const std::size_t next = line.find("MREC+ ");
+        if (start != std::string::npos) {
+            // a new recording while the last one wasn't finished: its lines were lost
+            if (inRecording) counts.damaged++;
+            bytes.clear();
+            decodeBase64(line.c_str() + start + 5, bytes);
+            inRecording = true;
+        } else if (next != std::string::npos && inRecording) {
+            decodeBase64(line.c_str() + next + 6, bytes);
+        }
+        const std::size_t size = recordingSize(bytes);
+        if (!inRecording || size == 0 || bytes.size() < size) continue;
+        if (printRecording(bytes.data(), bytes.size(), counts) == 0) counts.damaged++;
+        inRecording = false;
+    }
+    if (inRecording) counts.damaged++;
+}
+
+static bool decodeFile(const char* path, Counts& counts) {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    std::vector<std::uint8_t> data;
+    std::uint8_t buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + read);
+    std::fclose(file);
+
+    std::size_t offset = 0;
+    while (offset < data.size()) {
+        const std::size_t length = printRecording(data.data() + offset, data.size() - offset, counts);
+        if (length != 0) {
+            offset += length;
+            continue;
+        }
+        // a recording was cut short, like when the robot turned off while writing. Find the next one
+        counts.damaged++;
+        offset++;
+        while (offset + sizeof(std::uint32_t) <= data.size() &&
+               std::memcmp(data.data() + offset, &MotionRecordHeader::MAGIC, sizeof(std::uint32_t)) != 0)
+            offset++;
+        if (offset + sizeof(std::uint32_t) > data.size()) break;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const bool serial = argc == 2 && std::strcmp(argv[1], "--serial") == 0;
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s motions.bin\n       %s --serial < terminal.log\n", argv[0], argv[0]);
+        return 1;
+    }
+    Counts counts;
+    printHeader();
+    if (serial) decodeSerial(counts);
+    else if (!decodeFile(argv[1], counts)) {
+        std::fprintf(stderr, "%s: can't open %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    std::fprintf(stderr,
+                 "mrec_decode: %" PRIu32 " motions, %" PRIu32 " samples, %" PRIu32 " dropped, %" PRIu32 " damaged\n",
+                 counts.motions, counts.samples, counts.dropped, counts.damaged);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * path2bin - convert a path.jerryio path to a binary path asset
+ *
+ * Usage: path2bin <input.txt> <output.bin>
+ *
+ * Reads the "x, y, speed" lines up to "endData", precomputes the curvature and distance along the path at every
+ * point, and writes the layout described in src/PathAsset.hpp. Built for the host by `make paths`.
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "PathAsset.hpp"
+
+/**
+ * @brief Signed curvature of the circle through three points. Positive curvature is clockwise
+ */
+static float curvature(const PathPoint& a, const PathPoint& b, const PathPoint& c) {
+    const float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    const float ab = std::hypot(b.x - a.x, b.y - a.y);
+    const float bc = std::hypot(c.x - b.x, c.y - b.y);
+    const float ca = std::hypot(a.x - c.x, a.y - c.y);
+    if (ab * bc * ca == 0) return 0;
+    // counter-clockwise turns have a positive cross product
+    return -2 * cross / (ab * bc * ca);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <input.txt> <output.bin>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        std::fprintf(stderr, "path2bin: can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    // read points until the end of the data
+    std::vector<PathPoint> points;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        if (line.rfind("endData", 0) == 0) break;
+        if (line.empty()) continue;
+        std::istringstream stream(line);
+        PathPoint point {};
+        char comma1 = 0, comma2 = 0;
+        if (!(stream >> point.x >> comma1 >> point.y >> comma2 >> point.speed) || comma1 != ',' || comma2 != ',') {
+            std::fprintf(stderr, "path2bin: %s:%d: expected \"x, y, speed\"\n", argv[1], lineNumber);
+            return 1;
+        }
+        points.push_back(point);
+    }
+    if (points.empty()) {
+        std::fprintf(stderr, "path2bin: %s has no points\n", argv[1]);
+        return 1;
+    }
+
+    // distance along the path
+    for (std::size_t i = 1; i < points.size(); i++) {
+        points[i].distance =
+            points[i - 1].distance + std::hypot(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+    }
+    // curvature, using the neighbouring points. The ends take the curvature of the point next to them
+    for (std::size_t i = 1; i + 1 < points.size(); i++)
+        points[i].curvature = curvature(points[i - 1], points[i], points[i + 1]);
+    if (points.size() >= 3) {
+        points.front().curvature = points[1].curvature;
+        points.back().curvature = points[points.size() - 2].curvature;
+    }
+
+    PathHeader header {.magic = PATH_MAGIC,
+                       .version = PATH_VERSION,
+                       .pointSize = sizeof(PathPoint),
+                       .count = std::uint32_t(points.size()),
+                       .length = points.back().distance,
+                       .checksum = crc32(points.data(), points.size() * sizeof(PathPoint))};
+
+    std::ofstream output(argv[2], std::ios::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(PathPoint));
+    if (!output) {
+        std::fprintf(stderr, "path2bin: can't write %s\n", argv[2]);
+        return 1;
+    }
+    std::printf("%s: %zu points, %.1f in\n", argv[2], points.size(), header.length);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * sdlog_decode - decode a log file written to the SD card by SdLogSink
+ *
+ * Usage: sdlog_decode log0000.bin
+ *
+ * Prints one line per record: "time [LEVEL] message" for log messages, and "time type=N flags=N" followed by the
+ * payload in hex for binary records. Gaps in the block sequence, where blocks were dropped, and damaged blocks are
+ * reported on stderr. The format is described in src/SdLogFormat.hpp. Built for the host by `make sdlog_decode`.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "SdLogFormat.hpp"
+
+/** names of the lemlib log levels, in order */
+static const char* const LEVELS[] = {"INFO", "DEBUG", "WARN", "ERROR", "FATAL"};
+
+static void printRecord(const SdLogRecordHeader& header, const std::uint8_t* payload) {
+    if (header.type == static_cast<std::uint8_t>(SdLogRecordType::TEXT)) {
+        const char* level = header.flags < sizeof(LEVELS) / sizeof(LEVELS[0]) ? LEVELS[header.flags] : "?";
+        // messages usually end with their own newline
+        int length = header.size;
+        if (length > 0 && payload[length - 1] == '\n') length--;
+        std::printf("%" PRIu32 " [%s] %.*s\n", header.time, level, length, reinterpret_cast<const char*>(payload));
+        return;
+    }
+    std::printf("%" PRIu32 " type=%u flags=%u", header.time, header.type, header.flags);
+    for (std::uint16_t i = 0; i < header.size; i++) std::printf("%s%02x", i == 0 ? " " : "", payload[i]);
+    std::printf("\n");
+}
+
+/**
+ * @brief Print the records of a block
+ *
+ * @return false if the block is damaged
+ */
+static bool printBlock(const std::uint8_t* block, const SdLogBlockHeader& header) {
+    if (header.used < sizeof(SdLogBlockHeader) || header.used > SDLOG_BLOCK_SIZE) return false;
+    std::uint32_t offset = sizeof(SdLogBlockHeader);
+    for (std::uint16_t i = 0; i < header.count; i++) {
+        SdLogRecordHeader record;
+        if (header.used - offset < sizeof(record)) return false;
+        std::memcpy(&record, block + offset, sizeof(record));
+        offset += sizeof(record);
+        if (header.used - offset < record.size) return false;
+        printRecord(record, block + offset);
+        offset += record.size;
+    }
+    return offset == header.used;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s log0000.bin\n", argv[0]);
+        return 1;
+    }
+    FILE* file = std::fopen(argv[1], "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "%s: can't open %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    SdLogFileHeader fileHeader;
+    if (std::fread(&fileHeader, sizeof(fileHeader), 1, file) != 1 || fileHeader.magic != SdLogFileHeader::MAGIC ||
+        fileHeader.version != SdLogFileHeader::VERSION || fileHeader.blockSize != SDLOG_BLOCK_SIZE) {
+        std::fprintf(stderr, "%s: %s isn't a version %u log\n", argv[0], argv[1], SdLogFileHeader::VERSION);
+        std::fclose(file);
+        return 1;
+    }
+    // the rest of the header's block is padding
+    std::fseek(file, SDLOG_BLOCK_SIZE, SEEK_SET);
+
+    std::vector<std::uint8_t> block(SDLOG_BLOCK_SIZE);
+    std::uint32_t blocks = 0;
+    std::uint32_t expected = 0;
+    std::uint32_t missing = 0;
+    std::uint32_t damaged = 0;
+    while (std::fread(block.data(), SDLOG_BLOCK_SIZE, 1, file) == 1) {
+        blocks++;
+        SdLogBlockHeader header;
+        std::memcpy(&header, block.data(), sizeof(header));
+        if (header.sequence != expected) {
+            std::fprintf(stderr, "blocks %" PRIu32 " to %" PRIu32 " are missing\n", expected, header.sequence - 1);
+            missing += header.sequence - expected;
+        }
+        expected = header.sequence + 1;
+        if (!printBlock(block.data(), header)) {
+            std::fprintf(stderr, "block %" PRIu32 " is damaged\n", header.sequence);
+            damaged++;
+        }
+    }
+    std::fclose(file);
+    std::fprintf(stderr, "sdlog_decode: run %" PRIu32 ", %" PRIu32 " blocks, %" PRIu32 " missing, %" PRIu32 " damaged\n",
+                 fileHeader.run, blocks, missing, damaged);
+    return 0;
+}
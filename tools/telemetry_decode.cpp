@@ -0,0 +1,143 @@
+/**
+ * telemetry_decode - decode the binary telemetry stream sent by TelemetryStream
+ *
+ * Usage: telemetry_decode [--csv] < stream
+ *
+ * Reads the stream from stdin, for example piped from `pros terminal --raw`, and prints one line per record:
+ * "time name field=value ...", or with --csv, "time,name,value,...". Frames that fail their CRC, like text printed
+ * to the same stream, and records whose schema hasn't arrived yet are skipped and counted on stderr at the end. The
+ * protocol is described in src/TelemetryProtocol.hpp. Built for the host by `make telemetry_decode`.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "TelemetryProtocol.hpp"
+
+/**
+ * @brief A schema received from the robot
+ */
+struct Schema {
+        bool known = false;
+        std::string name;
+        std::vector<TelemetryType> types;
+        std::vector<std::string> fieldNames;
+};
+
+struct Counts {
+        std::uint64_t records = 0;
+        std::uint64_t badFrames = 0;
+        std::uint64_t unknownRecords = 0;
+};
+
+static bool readSchema(TelemetryReader& reader, std::vector<Schema>& schemas) {
+    std::uint8_t id;
+    char name[256];
+    std::uint8_t fieldCount;
+    if (!reader.getByte(id) || id == TELEMETRY_SCHEMA_ID || !reader.getString(name, sizeof(name)) ||
+        !reader.getByte(fieldCount))
+        return false;
+    Schema schema;
+    schema.known = true;
+    schema.name = name;
+    for (std::uint8_t i = 0; i < fieldCount; i++) {
+        std::uint8_t type;
+        if (!reader.getByte(type) || type > static_cast<std::uint8_t>(TelemetryType::FLOAT) ||
+            !reader.getString(name, sizeof(name)))
+            return false;
+        schema.types.push_back(static_cast<TelemetryType>(type));
+        schema.fieldNames.push_back(name);
+    }
+    if (!reader.isDone()) return false;
+    schemas[id] = std::move(schema);
+    return true;
+}
+
+static bool printRecord(TelemetryReader& reader, const Schema& schema, bool csv) {
+    std::uint64_t time;
+    if (!reader.getUVarint(time)) return false;
+    std::string line = std::to_string(time) + (csv ? "," : " ") + schema.name;
+    char value[64];
+    for (std::size_t i = 0; i < schema.types.size(); i++) {
+        switch (schema.types[i]) {
+            case TelemetryType::UINT: {
+                std::uint64_t field;
+                if (!reader.getUVarint(field)) return false;
+                std::snprintf(value, sizeof(value), "%" PRIu64, field);
+                break;
+            }
+            case TelemetryType::INT: {
+                std::int64_t field;
+                if (!reader.getVarint(field)) return false;
+                std::snprintf(value, sizeof(value), "%" PRId64, field);
+                break;
+            }
+            case TelemetryType::FLOAT: {
+                float field;
+                if (!reader.getFloat(field)) return false;
+                std::snprintf(value, sizeof(value), "%g", field);
+                break;
+            }
+        }
+        line += csv ? "," : " " + schema.fieldNames[i] + "=";
+        line += value;
+    }
+    if (!reader.isDone()) return false;
+    std::puts(line.c_str());
+    // records are read live from the robot, don't hold them back
+    std::fflush(stdout);
+    return true;
+}
+
+static void handleFrame(const std::vector<std::uint8_t>& encoded, std::vector<Schema>& schemas, Counts& counts,
+                        bool csv) {
+    if (encoded.empty()) return;
+    std::vector<std::uint8_t> payload(encoded.size());
+    const std::size_t size = telemetryDecode(encoded.data(), encoded.size(), payload.data());
+    if (size == 0) {
+        counts.badFrames++;
+        return;
+    }
+    TelemetryReader reader(payload.data(), size);
+    std::uint8_t id;
+    reader.getByte(id);
+    if (id == TELEMETRY_SCHEMA_ID) {
+        if (!readSchema(reader, schemas)) counts.badFrames++;
+        return;
+    }
+    if (!schemas[id].known) {
+        counts.unknownRecords++;
+        return;
+    }
+    if (printRecord(reader, schemas[id], csv)) counts.records++;
+    else counts.badFrames++;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    if (argc == 2 && std::strcmp(argv[1], "--csv") == 0) csv = true;
+    else if (argc != 1) {
+        std::fprintf(stderr, "usage: %s [--csv] < stream\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Schema> schemas(256);
+    Counts counts;
+    std::vector<std::uint8_t> frame;
+    int byte;
+    while ((byte = std::getchar()) != EOF) {
+        // frames are separated by zero bytes
+        if (byte == 0) {
+            handleFrame(frame, schemas, counts, csv);
+            frame.clear();
+            continue;
+        }
+        frame.push_back(byte);
+    }
+    handleFrame(frame, schemas, counts, csv);
+    std::fprintf(stderr, "telemetry_decode: %" PRIu64 " records, %" PRIu64 " bad frames, %" PRIu64
+                         " records without a schema\n",
+                 counts.records, counts.badFrames, counts.unknownRecords);
+    return 0;
+}